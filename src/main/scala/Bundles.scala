@@ -7,6 +7,14 @@ import utility.CircularQueuePtr
 
 class RobPtr extends CircularQueuePtr[RobPtr](VRobSize)
 
+// Squash of in-flight uops (e.g. RobPtr rollback): kills every uop after robIdx, and robIdx itself if flushItself
+class VFlush extends Bundle {
+  val valid = Bool()
+  val robIdx = new RobPtr
+  val flushItself = Bool()
+  def needFlush(ptr: RobPtr): Bool = valid && (ptr > robIdx || flushItself && ptr === robIdx)
+}
+
 class Dispatch_S2V extends Bundle {
   val robIdx = new RobPtr
   val inst = UInt(32.W)
@@ -30,13 +30,18 @@ object VParams {
   val wbDelay = 0  // Write back to RF
   val delayBias = issueDelay + wbDelay
   require(delayBias >= 1)
+  // Pipeline depth of FAdd_16_32: 2 (low latency) ~ 4 (high frequency), latency = faddStages - 1
+  val faddStages = 3
+  require(faddStages >= 2 && faddStages <= 4)
   // Concrete execution delays
   val aluDelay = 1 + delayBias
-  val faddDelay = 1 + delayBias
+  val faddDelay = (faddStages - 1) + delayBias
+  val fcmpDelay = delayBias  // Compare/min/max/sgnj/move of VFAddWrapper: output register only
   val fmaDelay = 3 + delayBias
   val fcvtDelay = 2 + delayBias
-  val fredFp16Delay = log2Up(VLEN/32) + 2 + delayBias
-  val fredFp32Delay = log2Up(VLEN/32) + 1 + delayBias
+  // VFRed unordered tree: log2(VLEN/32) + 2 levels of FAdd_16_32, the same for every format
+  val fredFp16Delay = (log2Up(VLEN/32) + 2) * (faddStages - 1) + delayBias
+  val fredFp32Delay = fredFp16Delay
   val vrgatherDelay = 1 + delayBias
 
   // Load/Store
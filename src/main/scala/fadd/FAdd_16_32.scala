@@ -2,16 +2,28 @@
   * FAdd supporting bf/fp16 and fp32. Includs:
   *   (1) bf16 -> bf16   (2) fp16 -> fp16   (3) fp32 -> fp32
   *   (4) bf16 -> fp32   (5) fp16 -> fp32
+  *   (6) fp32 -> bf16   (7) fp32 -> fp16  (narrowing: is_narrow, one rounding of the fp32 sum)
   * Hardware reuse:
   *   One fp19 adder and one fp32 adder
   * Scenario:
   *   AI, vector processing in LLM, etc.
   * Note: 
   *   1) For widen instrn, input bf/fp16 should be the highest half of the 32-bit input
-  *   2) Rounding mode only supports RNE
-  * Pipeline: |      |
+  *   2) Rounding mode only supports RNE, plus optional stochastic rounding of 16-bit results (StochasticRounding = true)
+  *   3) fflags (NV DZ OF UF NX) per 16-bit half; for a 32-bit result they are in fflags(0) (valid pattern 01)
+  *   4) For narrow instrn, is_bf16/is_fp16 give the result format; the result is the highest half of res (low half 0),
+  *      its fflags are in fflags(1) (valid pattern 10)
+  *   5) TwoSum = true: io.err = (a + b) - res exactly, same layout as res, for fp32/fp16/bf16 (not widen/narrow).
+  *      err is +0 if the result is exact, Inf/NaN or overflows. Needs ExtendedWidth >= SigWidth + 1 for both adders
+  *   6) Flush = true: io.robIdx_in travels with the op (io.robIdx_out). An op covered by io.flush is dropped from
+  *      whatever stage it is in during that cycle (valid_in included), so it never raises valid_out
+  * Pipeline (NStages = 3, default VParams.faddStages): |      |
   *      ---->|----->|----->
   *       S0  |  S1  |  S2
+  *   NStages = 2: S1 and S2 merged (no S1/S2 register), latency 1
+  *   NStages = 4: S3 = final result select after rounding, latency 3.
+  *                RetimeS3: S3 is only an output register instead, to be moved back into S2 by synthesis retiming
+  *   Latency (valid_in -> valid_out) = NStages - 1
   */
 
 package race.vpu.exu.laneexu.fp
@@ -19,30 +31,55 @@ package race.vpu.exu.laneexu.fp
 import chisel3._
 import chisel3.util._
 import race.vpu._
+import race.vpu.yunsuan.util._
 
 class FAdd_16_32(
   ExtendedWidthFp19: Int = 10 + 1 + 2, // Tunable parameter: trade-off between area and precision
-  ExtendedWidthFp32: Int = 23 + 1 + 2
+  ExtendedWidthFp32: Int = 23 + 1 + 2,
+  NStages: Int = VParams.faddStages,  // 2 (low latency) ~ 4 (high frequency)
+  RetimeS3: Boolean = false,
+  StochasticRounding: Boolean = false, // io.rm_sr selects it per op, random bits from an LFSR in the unit
+  TwoSum: Boolean = false, // io.err: rounding error of each result, for compensated summation
+  Flush: Boolean = false // io.flush: robIdx-based kill of in-flight ops
 ) extends Module {
+  require(NStages >= 2 && NStages <= 4, "FAdd_16_32: NStages must be 2, 3 or 4")
   val SigWidthFp19 = 10 + 1  // Fixed
   val SigWidthFp32 = 23 + 1  // Fixed
+  require(!TwoSum || ExtendedWidthFp19 >= SigWidthFp19 + 1 && ExtendedWidthFp32 >= SigWidthFp32 + 1,
+          "FAdd_16_32: TwoSum needs ExtendedWidthFp19 >= 12 and ExtendedWidthFp32 >= 25")
   val io = IO(new Bundle {
     val valid_in = Input(Bool())
     val is_bf16, is_fp16, is_fp32 = Input(Bool())
     val is_widen = Input(Bool())
+    val is_narrow = Input(Bool()) // fp32 a, b -> bf16/fp16 result
     val a_already_widen = Input(Bool()) // a already widened to fp32 (b not)
     val a, b = Input(UInt(32.W))  // a: vs2   b: vs1/rs1
     val res = Output(UInt(32.W))
+    val fflags = Output(Vec(2, UInt(5.W)))
     val valid_out = Output(Bool())
     val valid_S1 = Output(Bool())
+    // StochasticRounding only. rm_sr: round the 16-bit results of this op stochastically (fp32/widen keep RNE)
+    //   sr_seed_valid: load the LFSR with sr_seed (0 is replaced by 1)
+    val rm_sr = if (StochasticRounding) Some(Input(Bool())) else None
+    val sr_seed_valid = if (StochasticRounding) Some(Input(Bool())) else None
+    val sr_seed = if (StochasticRounding) Some(Input(UInt(32.W))) else None
+    // TwoSum only. res + err == a + b exactly (see Note 5)
+    val err = if (TwoSum) Some(Output(UInt(32.W))) else None
+    val flush = if (Flush) Some(Input(new VFlush)) else None
+    val robIdx_in = if (Flush) Some(Input(new RobPtr)) else None
+    val robIdx_out = if (Flush) Some(Output(new RobPtr)) else None
   })
 
-  val (is_bf16, is_fp16, is_fp32) = (io.is_bf16, io.is_fp16, io.is_fp32)
+  // Narrowing: operands are decoded (and added) as fp32, is_bf16/is_fp16 only select the rounding of the result
+  val narrow = io.is_narrow
+  val (is_bf16, is_fp16, is_fp32) = (io.is_bf16 && !narrow, io.is_fp16 && !narrow, io.is_fp32 || narrow)
   val is_16 = is_fp16 || is_bf16
   val widen = io.is_widen
-  val res_is_32 = widen || is_fp32
-  val res_is_bf16 = is_bf16 && !widen
-  val res_is_fp16 = is_fp16 && !widen
+  val res_is_32 = widen || is_fp32 && !narrow
+  val res_is_bf16 = is_bf16 && !widen || narrow && io.is_bf16
+  val res_is_fp16 = is_fp16 && !widen || narrow && io.is_fp16
+  val narrow_fp16 = narrow && io.is_fp16
+  val rm_sr = io.rm_sr.getOrElse(false.B) && is_16 && !widen
   val (sign_low_a, sign_low_b, sign_high_a, sign_high_b) = (io.a(15), io.b(15), io.a(31), io.b(31))
 
   val exp_high_a, exp_low_a, exp_high_b, exp_low_b = Wire(UInt(8.W))
@@ -109,9 +146,13 @@ class FAdd_16_32(
     sig_adjust_subnorm_32(i) := Mux(is_subnorm(i+2), 0.U(1.W), 1.U(1.W)) ## frac_in_32(i)
   }
 
+  // Flush: an op is killed in the stage it is in, the valid of that stage is cleared
+  def killed(robIdx: Option[RobPtr]): Bool = io.flush.map(_.needFlush(robIdx.get)).getOrElse(false.B)
+  val valid_S0 = io.valid_in && !killed(io.robIdx_in)
+
   //---- fp19 adder (low) + fp32 adder (low) ----
   val fadd_extSig_fp19 = Module(new FAdd_extSig(ExpWidth = 8, SigWidth = SigWidthFp19, ExtendedWidth = ExtendedWidthFp19, ExtAreZeros = true, UseShiftRightJam = true))
-  fadd_extSig_fp19.io.valid_in := io.valid_in
+  fadd_extSig_fp19.io.valid_in := valid_S0
   fadd_extSig_fp19.io.is_fp16 := is_fp16
   fadd_extSig_fp19.io.a.sign := sign_low_a
   fadd_extSig_fp19.io.a.exp := exp_adjust_subnorm(0)
@@ -125,8 +166,8 @@ class FAdd_16_32(
   fadd_extSig_fp19.io.b_is_nan := is_nan_16(1)
   
   val fadd_extSig_fp32 = Module(new FAdd_extSig(ExpWidth = 8, SigWidth = SigWidthFp32, ExtendedWidth = ExtendedWidthFp32, ExtAreZeros = true, UseShiftRightJam = true))
-  fadd_extSig_fp32.io.valid_in := io.valid_in
-  fadd_extSig_fp32.io.is_fp16 := res_is_fp16
+  fadd_extSig_fp32.io.valid_in := valid_S0
+  fadd_extSig_fp32.io.is_fp16 := is_fp16 && !widen // fp32 exponent range when narrowing
   val sig_adjust_subnorm_high_a = Mux(is_16 && !io.a_already_widen, sig_adjust_subnorm_16(2) ## 0.U(13.W), sig_adjust_subnorm_32(0))
   val sig_adjust_subnorm_high_b = Mux(is_16, sig_adjust_subnorm_16(3) ## 0.U(13.W), sig_adjust_subnorm_32(1))
   fadd_extSig_fp32.io.a.sign := sign_high_a
@@ -135,15 +176,44 @@ class FAdd_16_32(
   fadd_extSig_fp32.io.b.sign := sign_high_b
   fadd_extSig_fp32.io.b.exp := exp_adjust_subnorm(3)
   fadd_extSig_fp32.io.b.sig := sig_adjust_subnorm_high_b ## 0.U(ExtendedWidthFp32.W)
-  fadd_extSig_fp32.io.a_is_inf := Mux(is_16, is_inf_16(2), is_inf_32(0))
-  fadd_extSig_fp32.io.b_is_inf := Mux(is_16, is_inf_16(3), is_inf_32(1))
-  fadd_extSig_fp32.io.a_is_nan := Mux(is_16, is_nan_16(2), is_nan_32(0))
-  fadd_extSig_fp32.io.b_is_nan := Mux(is_16, is_nan_16(3), is_nan_32(1))
+  val (is_inf_high_a, is_inf_high_b) = (Mux(is_16, is_inf_16(2), is_inf_32(0)), Mux(is_16, is_inf_16(3), is_inf_32(1)))
+  val (is_nan_high_a, is_nan_high_b) = (Mux(is_16, is_nan_16(2), is_nan_32(0)), Mux(is_16, is_nan_16(3), is_nan_32(1)))
+  fadd_extSig_fp32.io.a_is_inf := is_inf_high_a
+  fadd_extSig_fp32.io.b_is_inf := is_inf_high_b
+  fadd_extSig_fp32.io.a_is_nan := is_nan_high_a
+  fadd_extSig_fp32.io.b_is_nan := is_nan_high_b
+
+  //---- Exception flags known from the operands ----
+  // NV: signaling NaN operand (MSB of fraction is 0) or Inf - Inf. For widen, converting a signaling NaN is invalid too.
+  // special: Inf/NaN operand, the result is not rounded (no OF/UF/NX)
+  val is_snan_16 = is_nan_16 zip frac_in_16 map {case (is_nan, frac) => is_nan && !frac.head(1).asBool}
+  val is_snan_32 = is_nan_32 zip frac_in_32 map {case (is_nan, frac) => is_nan && !frac.head(1).asBool}
+  val invalid_low = is_snan_16(0) || is_snan_16(1) || is_inf_16(0) && is_inf_16(1) && sign_low_a =/= sign_low_b
+  val invalid_high = Mux(is_16, is_snan_16(2) || is_snan_16(3), is_snan_32(0) || is_snan_32(1)) ||
+                     is_inf_high_a && is_inf_high_b && sign_high_a =/= sign_high_b
+  val special_low = is_inf_16(0) || is_inf_16(1) || is_nan_16(0) || is_nan_16(1)
+  val special_high = is_inf_high_a || is_inf_high_b || is_nan_high_a || is_nan_high_b
+
+  //---- TwoSum: an operand more than ExtendedWidth below the other is under a quarter ulp of it, so res is the
+  //  larger operand and err is the smaller one (its own bits, +0 for a zero). Otherwise the alignment shifts
+  //  nothing out and the adder output is the exact sum.
+  def belowWindow(exp_a: UInt, exp_b: UInt, ext: Int, a: UInt, b: UInt): (Bool, UInt) = {
+    val a_above = exp_a > exp_b +& ext.U
+    val small = Mux(a_above, b, a)
+    (a_above || exp_b > exp_a +& ext.U, Mux(small.tail(1) === 0.U, 0.U, small))
+  }
+  val (err_tiny_low, err_small_low) = belowWindow(exp_adjust_subnorm(0), exp_adjust_subnorm(1), ExtendedWidthFp19,
+                                                  io.a(15, 0), io.b(15, 0))
+  val (err_tiny_high, err_small_high) = belowWindow(exp_adjust_subnorm(2), exp_adjust_subnorm(3), ExtendedWidthFp32,
+                                                    Mux(is_16, io.a(31, 16) ## 0.U(16.W), io.a),
+                                                    Mux(is_16, io.b(31, 16) ## 0.U(16.W), io.b)) // 16-bit: high half
+  val err_en = !widen && !narrow
 
   //-----------------------------------------
   //---- Second stage: S1 (pipeline 1)   ----
   //-----------------------------------------
-  val valid_S1 = fadd_extSig_fp19.io.valid_out
+  val robIdx_S1 = io.robIdx_in.map(RegEnable(_, valid_S0))
+  val valid_S1 = fadd_extSig_fp19.io.valid_out && !killed(robIdx_S1)
   val res_extSig_fp19_S1 = fadd_extSig_fp19.io.res
   val res_extSig_fp32_S1 = fadd_extSig_fp32.io.res
 
@@ -154,30 +224,63 @@ class FAdd_16_32(
   val res_is_negInf_high_S1 = fadd_extSig_fp32.io.res_is_negInf
   val res_is_nan_high_S1 = fadd_extSig_fp32.io.res_is_nan
 
-  val res_is_32_S1 = RegEnable(res_is_32, io.valid_in)
-  val res_is_bf16_S1 = RegEnable(res_is_bf16, io.valid_in)
-  val res_is_fp16_S1 = RegEnable(res_is_fp16, io.valid_in)
+  val res_is_32_S1 = RegEnable(res_is_32, valid_S0)
+  val res_is_bf16_S1 = RegEnable(res_is_bf16, valid_S0)
+  val res_is_fp16_S1 = RegEnable(res_is_fp16, valid_S0)
+  val rm_sr_S1 = RegEnable(rm_sr, valid_S0)
+  val (narrow_S1, narrow_fp16_S1) = (RegEnable(narrow, valid_S0), RegEnable(narrow_fp16, valid_S0))
+  val (invalid_low_S1, invalid_high_S1) = (RegEnable(invalid_low, valid_S0), RegEnable(invalid_high, valid_S0))
+  val (special_low_S1, special_high_S1) = (RegEnable(special_low, valid_S0), RegEnable(special_high, valid_S0))
+  val (err_tiny_low_S1, err_tiny_high_S1) = (RegEnable(err_tiny_low, valid_S0), RegEnable(err_tiny_high, valid_S0))
+  val (err_small_low_S1, err_small_high_S1) = (RegEnable(err_small_low, valid_S0), RegEnable(err_small_high, valid_S0))
+  val err_en_S1 = RegEnable(err_en, valid_S0)
 
   //-----------------------------------------
   //---- Third stage: S2 (pipeline 2)   ----
   //-----------------------------------------
-  val valid_S2 = RegNext(valid_S1)
-  val res_extSig_fp19_S2 = RegEnable(res_extSig_fp19_S1, valid_S1)
-  val res_extSig_fp32_S2 = RegEnable(res_extSig_fp32_S1, valid_S1)
-  val res_is_32_S2 = RegEnable(res_is_32_S1, valid_S1)
-  val res_is_bf16_S2 = RegEnable(res_is_bf16_S1, valid_S1)
-  val res_is_fp16_S2 = RegEnable(res_is_fp16_S1, valid_S1)
-
-  val res_is_posInf_high_S2 = RegEnable(res_is_posInf_high_S1, valid_S1)
-  val res_is_negInf_high_S2 = RegEnable(res_is_negInf_high_S1, valid_S1)
-  val res_is_nan_high_S2 = RegEnable(res_is_nan_high_S1, valid_S1)
-  val res_is_posInf_low_S2 = RegEnable(res_is_posInf_low_S1, valid_S1)
-  val res_is_negInf_low_S2 = RegEnable(res_is_negInf_low_S1, valid_S1)
-  val res_is_nan_low_S2 = RegEnable(res_is_nan_low_S1, valid_S1)
+  // NStages = 2: no register here, S2 logic follows S1 in the same cycle
+  def regS2[T <: Data](x: T): T = if (NStages >= 3) RegEnable(x, valid_S1) else x
+  val robIdx_S2 = robIdx_S1.map(regS2(_))
+  val valid_S2 = (if (NStages >= 3) RegNext(valid_S1) else valid_S1) && !killed(robIdx_S2)
+  val res_extSig_fp19_S2 = regS2(res_extSig_fp19_S1)
+  val res_extSig_fp32_S2 = regS2(res_extSig_fp32_S1)
+  val res_is_32_S2 = regS2(res_is_32_S1)
+  val res_is_bf16_S2 = regS2(res_is_bf16_S1)
+  val res_is_fp16_S2 = regS2(res_is_fp16_S1)
+  val rm_sr_S2 = regS2(rm_sr_S1)
+  val (narrow_S2, narrow_fp16_S2) = (regS2(narrow_S1), regS2(narrow_fp16_S1))
+
+  val res_is_posInf_high_S2 = regS2(res_is_posInf_high_S1)
+  val res_is_negInf_high_S2 = regS2(res_is_negInf_high_S1)
+  val res_is_nan_high_S2 = regS2(res_is_nan_high_S1)
+  val res_is_posInf_low_S2 = regS2(res_is_posInf_low_S1)
+  val res_is_negInf_low_S2 = regS2(res_is_negInf_low_S1)
+  val res_is_nan_low_S2 = regS2(res_is_nan_low_S1)
+  val (invalid_low_S2, invalid_high_S2) = (regS2(invalid_low_S1), regS2(invalid_high_S1))
+  val (special_low_S2, special_high_S2) = (regS2(special_low_S1), regS2(special_high_S1))
+  val (err_tiny_low_S2, err_tiny_high_S2) = (regS2(err_tiny_low_S1), regS2(err_tiny_high_S1))
+  val (err_small_low_S2, err_small_high_S2) = (regS2(err_small_low_S1), regS2(err_small_high_S1))
+  val err_en_S2 = regS2(err_en_S1)
 
   val (sign_res_extSig_fp19, sign_res_extSig_fp32) = (res_extSig_fp19_S2.sign, res_extSig_fp32_S2.sign)
-  val (exp_res_extSig_fp19, exp_res_extSig_fp32) = (res_extSig_fp19_S2.exp, res_extSig_fp32_S2.exp)
-  val (sig_res_extSig_fp19, sig_res_extSig_fp32) = (res_extSig_fp19_S2.sig, res_extSig_fp32_S2.sig)
+
+  //---- Narrowing fp32 -> fp16: rebias the fp32 adder result to the fp16 exponent ----
+  //  Below the fp16 normal range the significand is shifted right (with jam) to exponent 1, so the fp16 rounding
+  //  below sees a subnormal exactly like in fp16 -> fp16. Above it the result overflows to Inf before rounding.
+  //  A bf16 result has the fp32 exponent range and needs nothing here.
+  val exp_narrow_fp16 = res_extSig_fp32_S2.exp.zext - (127 - 15).S // 9 bits
+  val narrow_fp16_tiny = exp_narrow_fp16 < 1.S
+  val narrow_fp16_ovf = narrow_fp16_S2 && exp_narrow_fp16 > 30.S
+  val (sig_narrow_fp16_main, sig_narrow_fp16_sticky) = ShiftRightJam(res_extSig_fp32_S2.sig, (1.S - exp_narrow_fp16).asUInt)
+  val sig_narrow_fp16 = Mux(narrow_fp16_tiny, Cat(sig_narrow_fp16_main.head(sig_narrow_fp16_main.getWidth - 1),
+                                                  sig_narrow_fp16_main(0) || sig_narrow_fp16_sticky),
+                            res_extSig_fp32_S2.sig)
+  val exp_narrow_fp16_adjust = Mux(narrow_fp16_tiny, 1.U, exp_narrow_fp16.asUInt(7, 0))
+
+  val (exp_res_extSig_fp19, exp_res_extSig_fp32) = (res_extSig_fp19_S2.exp,
+            Mux(narrow_fp16_S2, exp_narrow_fp16_adjust, res_extSig_fp32_S2.exp))
+  val (sig_res_extSig_fp19, sig_res_extSig_fp32) = (res_extSig_fp19_S2.sig,
+            Mux(narrow_fp16_S2, sig_narrow_fp16, res_extSig_fp32_S2.sig))
 
   //---- Rouding (only RNE) of adder out ----
   //---- (1) Calculate LSB, Guard bit, Sticky bit, and significand
@@ -211,12 +314,34 @@ class FAdd_16_32(
                             s_adderOut_high_fp16
   val sig_adderOut_high_bf16 = sig_res_extSig_fp32.head(SigWidthFp32 - 13 - 3)
   
+  //---- Stochastic rounding: round away from zero iff (discarded bits + random) carries into the LSB ----
+  //  Only the top SRBits of the discarded part are used, so P(round up) is exact to 2^-SRBits ulp.
+  //  The LFSR (x^32 + x^22 + x^2 + x + 1, Galois) steps 32 times per stochastically rounded op: fresh bits
+  //  for both halves, and RNE ops leave it idle.
+  val SRBits = 16
+  val (rand_low, rand_high) = if (StochasticRounding) {
+    def lfsrStep(x: UInt): UInt = Mux(x(0), (x >> 1) ^ "h80200003".U(32.W), x >> 1)
+    val lfsr = RegInit("hACE1ACE1".U(32.W))
+    when (io.sr_seed_valid.get) {
+      lfsr := Mux(io.sr_seed.get === 0.U, 1.U, io.sr_seed.get)
+    }.elsewhen (valid_S2 && rm_sr_S2) {
+      lfsr := (0 until 32).foldLeft(lfsr)((x, _) => lfsrStep(x))
+    }
+    (lfsr(SRBits - 1, 0), lfsr(2 * SRBits - 1, SRBits))
+  } else (0.U(SRBits.W), 0.U(SRBits.W))
+  def withSR(rne: Bool, discarded: UInt, rand: UInt): Bool = if (StochasticRounding) {
+    val d = if (discarded.getWidth >= SRBits) discarded.head(SRBits) else discarded ## 0.U((SRBits - discarded.getWidth).W)
+    Mux(rm_sr_S2, (d +& rand)(SRBits), rne)
+  } else rne
+
   //---- (2) Calculate final significand and exponent of result ----
   // Low fp16/bf16
-  val rnd_cin_low_fp16 = Mux(!g_adderOut_low_fp16, false.B,
-                          Mux(s_adderOut_low_fp16, true.B, lsb_adderOut_low_fp16))
-  val rnd_cin_low_bf16 = Mux(!g_adderOut_low_bf16, false.B,
-                          Mux(s_adderOut_low_bf16, true.B, lsb_adderOut_low_bf16))
+  val rnd_cin_low_fp16 = withSR(Mux(!g_adderOut_low_fp16, false.B,
+                          Mux(s_adderOut_low_fp16, true.B, lsb_adderOut_low_fp16)),
+                          sig_res_extSig_fp19(ExtendedWidthFp19, 0), rand_low)
+  val rnd_cin_low_bf16 = withSR(Mux(!g_adderOut_low_bf16, false.B,
+                          Mux(s_adderOut_low_bf16, true.B, lsb_adderOut_low_bf16)),
+                          sig_res_extSig_fp19(ExtendedWidthFp19 + 3, 0), rand_low)
   val sig_res_low_tmp = sig_adderOut_low_fp16 +&
             Mux(res_is_fp16_S2, rnd_cin_low_fp16.asUInt, rnd_cin_low_bf16.asUInt << 3) // SigWidthFp19 + 1 bits
   val sig_res_low = Mux(sig_res_low_tmp(SigWidthFp19),
@@ -229,19 +354,77 @@ class FAdd_16_32(
   // High fp32/fp16/bf16
   val rnd_cin_high_fp32 = Mux(!g_adderOut_high_fp32, false.B,
                           Mux(s_adderOut_high_fp32, true.B, lsb_adderOut_high_fp32))
-  val rnd_cin_high_fp16 = Mux(!g_adderOut_high_fp16, false.B,
-                          Mux(s_adderOut_high_fp16, true.B, lsb_adderOut_high_fp16))
-  val rnd_cin_high_bf16 = Mux(!g_adderOut_high_bf16, false.B,
-                          Mux(s_adderOut_high_bf16, true.B, lsb_adderOut_high_bf16))
+  val rnd_cin_high_fp16 = withSR(Mux(!g_adderOut_high_fp16, false.B,
+                          Mux(s_adderOut_high_fp16, true.B, lsb_adderOut_high_fp16)),
+                          sig_res_extSig_fp32(ExtendedWidthFp32 + 13, 0), rand_high)
+  val rnd_cin_high_bf16 = withSR(Mux(!g_adderOut_high_bf16, false.B,
+                          Mux(s_adderOut_high_bf16, true.B, lsb_adderOut_high_bf16)),
+                          sig_res_extSig_fp32(ExtendedWidthFp32 + 16, 0), rand_high)
   val sig_res_high_tmp = sig_adderOut_high_fp32 +& Mux(res_is_32_S2, rnd_cin_high_fp32.asUInt,
             Mux(res_is_fp16_S2, rnd_cin_high_fp16.asUInt << 13, rnd_cin_high_bf16.asUInt << 16)) // SigWidthFp32 + 1 bits
   val sig_res_high = Mux(sig_res_high_tmp(SigWidthFp32),
                         sig_res_high_tmp(SigWidthFp32, 1), sig_res_high_tmp(SigWidthFp32 - 1, 0)) // SigWidthFp32 bits
   val exp_adjust_res_high = exp_res_extSig_fp32 + sig_res_high_tmp(SigWidthFp32).asUInt // 8 bits
   val isInf_res_high = sig_res_high_tmp(SigWidthFp32) &&
-            Mux(!res_is_fp16_S2, exp_res_extSig_fp32 === "b11111110".U, exp_res_extSig_fp32 === "b00011110".U)
+            Mux(!res_is_fp16_S2, exp_res_extSig_fp32 === "b11111110".U, exp_res_extSig_fp32 === "b00011110".U) ||
+            narrow_fp16_ovf
   val exp_res_high = Mux(exp_adjust_res_high === 1.U && !sig_res_high(SigWidthFp32 - 1), 0.U, exp_adjust_res_high) // 8 bits
 
+  //---- (3) Exception flags: NV DZ OF UF NX ----
+  // OF: finite operands, result rounds (or already added up) to Inf.  NX: guard/sticky bits dropped, or OF.
+  // UF: tiny after rounding (RISC-V) and inexact. A sum below the normal range is exact, so UF stays 0 for a correct datapath
+  //     except when narrowing.
+  val inexact_low = Mux(res_is_fp16_S2, g_adderOut_low_fp16 || s_adderOut_low_fp16, g_adderOut_low_bf16 || s_adderOut_low_bf16)
+  val inexact_high = Mux(res_is_32_S2, g_adderOut_high_fp32 || s_adderOut_high_fp32,
+                     Mux(res_is_fp16_S2, g_adderOut_high_fp16 || s_adderOut_high_fp16, g_adderOut_high_bf16 || s_adderOut_high_bf16))
+  val overflow_low = !special_low_S2 && (isInf_res_low || res_is_posInf_low_S2 || res_is_negInf_low_S2)
+  val overflow_high = !special_high_S2 && (isInf_res_high || res_is_posInf_high_S2 || res_is_negInf_high_S2)
+  val nx_low = overflow_low || !special_low_S2 && inexact_low
+  val nx_high = overflow_high || !special_high_S2 && inexact_high
+  val uf_low = nx_low && !overflow_low && exp_res_low === 0.U
+  //     Narrowing decides tininess like SoftFloat: the sum rounded to 11 (fp16) / 8 (bf16) bits with an unbounded exponent
+  //     is still below 2^-14 / 2^-126. Only a sum in [2^-15, 2^-14) / [2^-127, 2^-126) whose significand and guard bit
+  //     are all ones rounds up out of tiny (RNE, lsb = 1); the subnormal rounding above reaches the normal range from
+  //     further below, so exp_res_high === 0 misses UF there.
+  val sigW_fp32 = res_extSig_fp32_S2.sig.getWidth
+  val narrow_fp16_tiny_unb = exp_narrow_fp16 < 0.S ||
+            exp_narrow_fp16 === 0.S && !res_extSig_fp32_S2.sig(sigW_fp32 - 1, sigW_fp32 - 12).andR
+  val narrow_bf16_tiny_unb = res_extSig_fp32_S2.exp === 1.U && !res_extSig_fp32_S2.sig(sigW_fp32 - 1) &&
+            !res_extSig_fp32_S2.sig(sigW_fp32 - 2, sigW_fp32 - 10).andR
+  val tiny_high = Mux(narrow_S2, Mux(narrow_fp16_S2, narrow_fp16_tiny_unb, narrow_bf16_tiny_unb), exp_res_high === 0.U)
+  val uf_high = nx_high && !overflow_high && tiny_high
+  val fflags_low = Cat(invalid_low_S2, false.B, overflow_low, uf_low, nx_low)
+  val fflags_high = Cat(invalid_high_S2, false.B, overflow_high, uf_high, nx_high)
+
+  //---- (4) TwoSum: rounding error of the result ----
+  //  The k bits below the LSB are D. Rounded down, err = D with the sign of the result; rounded up, err = 2^k - D
+  //  with the opposite sign. Its leading one is normalised away; the guard bit has exponent exp - SigWidth of the
+  //  format, and below exponent 1 err is subnormal. It is exactly representable, so no bit is lost.
+  def roundingError(sign: Bool, exp: UInt, sig: UInt, k: Int, rnd_cin: Bool, expBits: Int, fracBits: Int): UInt = {
+    val d = sig(k - 1, 0)
+    val mag = Mux(rnd_cin, (0.U(k.W) - d)(k - 1, 0), d)
+    val lzd = LZD(mag)
+    val exp_guard = exp.zext - (fracBits + 1).S
+    val normal = exp_guard > lzd.zext
+    val shamt = Mux(normal, lzd +& (fracBits + 1).U, (exp_guard + fracBits.S).asUInt)(log2Up(k + fracBits + 2) - 1, 0)
+    val frac = (mag << shamt)(k + fracBits - 1, k)
+    val exp_err = Mux(normal, (exp_guard - lzd.zext).asUInt(expBits - 1, 0), 0.U(expBits.W))
+    Cat((sign ^ rnd_cin) && mag.orR, exp_err, frac)
+  }
+  val err = if (TwoSum) {
+    val err_low = Mux(!err_en_S2 || special_low_S2 || overflow_low, 0.U,
+                  Mux(err_tiny_low_S2, err_small_low_S2, Mux(res_is_fp16_S2,
+            roundingError(sign_res_extSig_fp19, exp_res_extSig_fp19, sig_res_extSig_fp19, ExtendedWidthFp19 + 1, rnd_cin_low_fp16, 5, 10),
+            roundingError(sign_res_extSig_fp19, exp_res_extSig_fp19, sig_res_extSig_fp19, ExtendedWidthFp19 + 4, rnd_cin_low_bf16, 8, 7)))))
+    val err_high = Mux(!err_en_S2 || special_high_S2 || overflow_high, 0.U,
+                   Mux(err_tiny_high_S2, err_small_high_S2, Mux(res_is_32_S2,
+            roundingError(sign_res_extSig_fp32, exp_res_extSig_fp32, sig_res_extSig_fp32, ExtendedWidthFp32 + 1, rnd_cin_high_fp32, 8, 23),
+            Mux(res_is_fp16_S2,
+            roundingError(sign_res_extSig_fp32, exp_res_extSig_fp32, sig_res_extSig_fp32, ExtendedWidthFp32 + 14, rnd_cin_high_fp16, 5, 10),
+            roundingError(sign_res_extSig_fp32, exp_res_extSig_fp32, sig_res_extSig_fp32, ExtendedWidthFp32 + 17, rnd_cin_high_bf16, 8, 7)) ## 0.U(16.W))))
+    Mux(res_is_32_S2, err_high, Cat(err_high(31, 16), err_low(15, 0)))
+  } else 0.U(32.W)
+
   //-----------------------------------------
   //---- Final result -----
   //-----------------------------------------
@@ -251,40 +434,63 @@ class FAdd_16_32(
   val resFinal_fp16_high_tmp = Cat(sign_res_extSig_fp32, exp_res_high(4, 0), sig_res_high(SigWidthFp32 - 2, 13))
   val resFinal_bf16_high_tmp = Cat(sign_res_extSig_fp32, exp_res_high, sig_res_high(SigWidthFp32 - 2, 16))
 
+  //---- S3 (NStages = 4): register between rounding and the final result select ----
+  def regS3[T <: Data](x: T): T = if (NStages == 4 && !RetimeS3) RegEnable(x, valid_S2) else x
+  val robIdx_S3 = robIdx_S2.map(x => if (NStages == 4) RegEnable(x, valid_S2) else x)
+  val valid_S3 = (if (NStages == 4) RegNext(valid_S2) else valid_S2) && !killed(robIdx_S3)
+  val resFinal_fp16_low_S3 = regS3(resFinal_fp16_low_tmp)
+  val resFinal_bf16_low_S3 = regS3(resFinal_bf16_low_tmp)
+  val resFinal_32_high_S3 = regS3(resFinal_32_high_tmp)
+  val resFinal_fp16_high_S3 = regS3(resFinal_fp16_high_tmp)
+  val resFinal_bf16_high_S3 = regS3(resFinal_bf16_high_tmp)
+  val (sign_res_fp19_S3, sign_res_fp32_S3) = (regS3(sign_res_extSig_fp19), regS3(sign_res_extSig_fp32))
+  val (isInf_res_low_S3, isInf_res_high_S3) = (regS3(isInf_res_low), regS3(isInf_res_high))
+  val res_is_32_S3 = regS3(res_is_32_S2)
+  val res_is_fp16_S3 = regS3(res_is_fp16_S2)
+  val narrow_S3 = regS3(narrow_S2)
+  val res_is_posInf_high_S3 = regS3(res_is_posInf_high_S2)
+  val res_is_negInf_high_S3 = regS3(res_is_negInf_high_S2)
+  val res_is_nan_high_S3 = regS3(res_is_nan_high_S2)
+  val res_is_posInf_low_S3 = regS3(res_is_posInf_low_S2)
+  val res_is_negInf_low_S3 = regS3(res_is_negInf_low_S2)
+  val res_is_nan_low_S3 = regS3(res_is_nan_low_S2)
+  val (fflags_low_S3, fflags_high_S3) = (regS3(fflags_low), regS3(fflags_high))
+  val err_S3 = regS3(err)
+
   // val resFinal_is_posInf_high = isInf_res_high || res_is_posInf_high_S2
   // val resFinal_is_negInf_high = isInf_res_high || res_is_negInf_high_S2
   // val resFinal_is_posInf_low = isInf_res_low || res_is_posInf_low_S2
   // val resFinal_is_negInf_low = isInf_res_low || res_is_negInf_low_S2
 
-  val resFinal_32_high = MuxCase(resFinal_32_high_tmp, Seq(
-          res_is_nan_high_S2 -> "h7FC00000".U,
-          res_is_posInf_high_S2 -> "h7F800000".U,
-          res_is_negInf_high_S2 -> "hFF800000".U,
-          isInf_res_high -> sign_res_extSig_fp32 ## ~0.U(8.W) ## 0.U(23.W)
+  val resFinal_32_high = MuxCase(resFinal_32_high_S3, Seq(
+          res_is_nan_high_S3 -> "h7FC00000".U,
+          res_is_posInf_high_S3 -> "h7F800000".U,
+          res_is_negInf_high_S3 -> "hFF800000".U,
+          isInf_res_high_S3 -> sign_res_fp32_S3 ## ~0.U(8.W) ## 0.U(23.W)
   ))
-  val resFinal_bf16_high = MuxCase(resFinal_bf16_high_tmp, Seq(
-          res_is_nan_high_S2 -> "h7FC0".U,
-          res_is_posInf_high_S2 -> "h7F80".U,
-          res_is_negInf_high_S2 -> "hFF80".U,
-          isInf_res_high -> sign_res_extSig_fp32 ## ~0.U(8.W) ## 0.U(7.W)
+  val resFinal_bf16_high = MuxCase(resFinal_bf16_high_S3, Seq(
+          res_is_nan_high_S3 -> "h7FC0".U,
+          res_is_posInf_high_S3 -> "h7F80".U,
+          res_is_negInf_high_S3 -> "hFF80".U,
+          isInf_res_high_S3 -> sign_res_fp32_S3 ## ~0.U(8.W) ## 0.U(7.W)
   ))
-  val resFinal_fp16_high = MuxCase(resFinal_fp16_high_tmp, Seq(
-          res_is_nan_high_S2 -> "h7E00".U,
-          res_is_posInf_high_S2 -> "h7C00".U,
-          res_is_negInf_high_S2 -> "hFC00".U,
-          isInf_res_high -> sign_res_extSig_fp32 ## ~0.U(5.W) ## 0.U(10.W)
+  val resFinal_fp16_high = MuxCase(resFinal_fp16_high_S3, Seq(
+          res_is_nan_high_S3 -> "h7E00".U,
+          res_is_posInf_high_S3 -> "h7C00".U,
+          res_is_negInf_high_S3 -> "hFC00".U,
+          isInf_res_high_S3 -> sign_res_fp32_S3 ## ~0.U(5.W) ## 0.U(10.W)
   ))
-  val resFinal_bf16_low = MuxCase(resFinal_bf16_low_tmp, Seq(
-          res_is_nan_low_S2 -> "h7FC0".U,
-          res_is_posInf_low_S2 -> "h7F80".U,
-          res_is_negInf_low_S2 -> "hFF80".U,
-          isInf_res_low -> sign_res_extSig_fp19 ## ~0.U(8.W) ## 0.U(7.W)
+  val resFinal_bf16_low = MuxCase(resFinal_bf16_low_S3, Seq(
+          res_is_nan_low_S3 -> "h7FC0".U,
+          res_is_posInf_low_S3 -> "h7F80".U,
+          res_is_negInf_low_S3 -> "hFF80".U,
+          isInf_res_low_S3 -> sign_res_fp19_S3 ## ~0.U(8.W) ## 0.U(7.W)
   ))
-  val resFinal_fp16_low = MuxCase(resFinal_fp16_low_tmp, Seq(
-          res_is_nan_low_S2 -> "h7E00".U,
-          res_is_posInf_low_S2 -> "h7C00".U,
-          res_is_negInf_low_S2 -> "hFC00".U,
-          isInf_res_low -> sign_res_extSig_fp19 ## ~0.U(5.W) ## 0.U(10.W)
+  val resFinal_fp16_low = MuxCase(resFinal_fp16_low_S3, Seq(
+          res_is_nan_low_S3 -> "h7E00".U,
+          res_is_posInf_low_S3 -> "h7C00".U,
+          res_is_negInf_low_S3 -> "hFC00".U,
+          isInf_res_low_S3 -> sign_res_fp19_S3 ## ~0.U(5.W) ## 0.U(10.W)
   ))
 
   // val resFinal_bf16_high = Mux(res_is_nan_high_S2, "h7FC0".U, Mux(resFinal_is_posInf_high, "h7F80".U, Mux(resFinal_is_negInf_high, "hFF80".U, resFinal_bf16_high_tmp)))
@@ -292,10 +498,16 @@ class FAdd_16_32(
   // val resFinal_bf16_low = Mux(res_is_nan_low_S2, "h7FC0".U, Mux(resFinal_is_posInf_low, "h7F80".U, Mux(resFinal_is_negInf_low, "hFF80".U, resFinal_bf16_low_tmp)))
   // val resFinal_fp16_low = Mux(res_is_nan_low_S2, "h7E00".U, Mux(resFinal_is_posInf_low, "h7C00".U, Mux(resFinal_is_negInf_low, "hFC00".U, resFinal_fp16_low_tmp)))
 
-  io.res := Mux(res_is_32_S2, resFinal_32_high,
-            Mux(res_is_fp16_S2, Cat(resFinal_fp16_high, resFinal_fp16_low),
-                Cat(resFinal_bf16_high, resFinal_bf16_low)))
-  io.valid_out := valid_S2
+  val res = Mux(res_is_32_S3, resFinal_32_high,
+            Mux(res_is_fp16_S3, Cat(resFinal_fp16_high, Mux(narrow_S3, 0.U(16.W), resFinal_fp16_low)),
+                Cat(resFinal_bf16_high, Mux(narrow_S3, 0.U(16.W), resFinal_bf16_low))))
+  io.res := (if (NStages == 4 && RetimeS3) RegEnable(res, valid_S2) else res)
+  val fflags = VecInit(Mux(res_is_32_S3, fflags_high_S3, Mux(narrow_S3, 0.U, fflags_low_S3)),
+                       Mux(res_is_32_S3, 0.U, fflags_high_S3))
+  io.fflags := (if (NStages == 4 && RetimeS3) RegEnable(fflags, valid_S2) else fflags)
+  io.err.foreach(_ := (if (NStages == 4 && RetimeS3) RegEnable(err_S3, valid_S2) else err_S3))
+  io.valid_out := valid_S3
+  io.robIdx_out.foreach(_ := robIdx_S3.get)
   io.valid_S1 := valid_S1
 }
 
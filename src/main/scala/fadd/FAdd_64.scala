@@ -0,0 +1,144 @@
+/**
+  * FAdd for fp64 (one element), the sew = 64 adder of VFAddWrapper. Same structure and pipeline as FAdd_16_32:
+  *   FAdd_extSig (11-bit exponent, 53-bit significand) in S0/S1, RNE rounding in S2.
+  * Note:
+  *   1) Rounding mode only supports RNE
+  *   2) fflags: NV DZ OF UF NX, as FAdd_16_32
+  *   3) ExtendedWidth = 3 (guard, round and the jammed sticky bit) already rounds exactly, a wider
+  *      extension only costs adder width
+  * Pipeline (NStages = 3, default VParams.faddStages): |      |
+  *      ---->|----->|----->
+  *       S0  |  S1  |  S2
+  *   NStages = 2: S1 and S2 merged, NStages = 4: S3 = final result select after rounding
+  *   Latency (valid_in -> valid_out) = NStages - 1, the same as FAdd_16_32
+  */
+
+package race.vpu.exu.laneexu.fp
+
+import chisel3._
+import chisel3.util._
+import race.vpu._
+import race.vpu.yunsuan.util._
+
+class FAdd_64(
+  ExtendedWidth: Int = 3,
+  NStages: Int = VParams.faddStages  // keep it equal to the NStages of FAdd_16_32 in the same wrapper
+) extends Module {
+  require(NStages >= 2 && NStages <= 4, "FAdd_64: NStages must be 2, 3 or 4")
+  require(ExtendedWidth >= 3, "FAdd_64: ExtendedWidth must be at least 3")
+  val ExpWidth = 11  // Fixed
+  val SigWidth = 52 + 1  // Fixed
+  val io = IO(new Bundle {
+    val valid_in = Input(Bool())
+    val a, b = Input(UInt(64.W))  // a: vs2   b: vs1/rs1
+    val res = Output(UInt(64.W))
+    val fflags = Output(UInt(5.W))
+    val valid_out = Output(Bool())
+  })
+
+  val (sign_a, sign_b) = (io.a(63), io.b(63))
+  val (exp_a, exp_b) = (io.a(62, 52), io.b(62, 52))
+  val (frac_a, frac_b) = (io.a(51, 0), io.b(51, 0))
+
+  //----   a, b = 0, 1   ----
+  val exp_in = Seq(exp_a, exp_b)
+  val frac_in = Seq(frac_a, frac_b)
+  val is_subnorm = exp_in.map(_ === 0.U) // Subnormal and Zero (treat Zero as subnormal)
+  val exp_is_all1s = exp_in.map(_.andR)
+  val frac_is_0 = frac_in.map(_ === 0.U)
+  val is_inf = exp_is_all1s zip frac_is_0 map {case (is_all1s, is_0_frac) => is_all1s && is_0_frac}
+  val is_nan = exp_is_all1s zip frac_is_0 map {case (is_all1s, is_0_frac) => is_all1s && !is_0_frac}
+
+  val exp_adjust_subnorm = exp_in zip is_subnorm map {case (exp, sub) => Mux(sub, 1.U(ExpWidth.W), exp)}
+  //  x.xxxx...x   fp64 (1 + 52)
+  val sig_adjust_subnorm = frac_in zip is_subnorm map {case (frac, sub) => Mux(sub, 0.U(1.W), 1.U(1.W)) ## frac}
+
+  val fadd_extSig = Module(new FAdd_extSig(ExpWidth = ExpWidth, SigWidth = SigWidth, ExtendedWidth = ExtendedWidth,
+                                           ExtAreZeros = true, UseShiftRightJam = true))
+  fadd_extSig.io.valid_in := io.valid_in
+  fadd_extSig.io.is_fp16 := false.B
+  fadd_extSig.io.a.sign := sign_a
+  fadd_extSig.io.a.exp := exp_adjust_subnorm(0)
+  fadd_extSig.io.a.sig := sig_adjust_subnorm(0) ## 0.U(ExtendedWidth.W)
+  fadd_extSig.io.b.sign := sign_b
+  fadd_extSig.io.b.exp := exp_adjust_subnorm(1)
+  fadd_extSig.io.b.sig := sig_adjust_subnorm(1) ## 0.U(ExtendedWidth.W)
+  fadd_extSig.io.a_is_inf := is_inf(0)
+  fadd_extSig.io.b_is_inf := is_inf(1)
+  fadd_extSig.io.a_is_nan := is_nan(0)
+  fadd_extSig.io.b_is_nan := is_nan(1)
+
+  //---- Exception flags known from the operands (see FAdd_16_32) ----
+  val is_snan = is_nan zip frac_in map {case (nan, frac) => nan && !frac.head(1).asBool}
+  val invalid = is_snan(0) || is_snan(1) || is_inf(0) && is_inf(1) && sign_a =/= sign_b
+  val special = is_inf(0) || is_inf(1) || is_nan(0) || is_nan(1)
+
+  //-----------------------------------------
+  //---- Second stage: S1 (pipeline 1)   ----
+  //-----------------------------------------
+  val valid_S1 = fadd_extSig.io.valid_out
+  val invalid_S1 = RegEnable(invalid, io.valid_in)
+  val special_S1 = RegEnable(special, io.valid_in)
+
+  //-----------------------------------------
+  //---- Third stage: S2 (pipeline 2)   ----
+  //-----------------------------------------
+  // NStages = 2: no register here, S2 logic follows S1 in the same cycle
+  def regS2[T <: Data](x: T): T = if (NStages >= 3) RegEnable(x, valid_S1) else x
+  val valid_S2 = if (NStages >= 3) RegNext(valid_S1) else valid_S1
+  val res_extSig_S2 = regS2(fadd_extSig.io.res)
+  val res_is_posInf_S2 = regS2(fadd_extSig.io.res_is_posInf)
+  val res_is_negInf_S2 = regS2(fadd_extSig.io.res_is_negInf)
+  val res_is_nan_S2 = regS2(fadd_extSig.io.res_is_nan)
+  val (invalid_S2, special_S2) = (regS2(invalid_S1), regS2(special_S1))
+
+  val (sign_res_extSig, exp_res_extSig, sig_res_extSig) = (res_extSig_S2.sign, res_extSig_S2.exp, res_extSig_S2.sig)
+
+  //---- Rouding (only RNE) of adder out ----
+  val lsb_adderOut = sig_res_extSig(ExtendedWidth + 1)
+  val g_adderOut = sig_res_extSig(ExtendedWidth)
+  val s_adderOut = sig_res_extSig(ExtendedWidth - 1, 0).orR
+  val sig_adderOut = sig_res_extSig.head(SigWidth)
+
+  val rnd_cin = Mux(!g_adderOut, false.B, Mux(s_adderOut, true.B, lsb_adderOut))
+  val sig_res_tmp = sig_adderOut +& rnd_cin.asUInt // SigWidth + 1 bits
+  val sig_res = Mux(sig_res_tmp(SigWidth), sig_res_tmp(SigWidth, 1), sig_res_tmp(SigWidth - 1, 0)) // SigWidth bits
+  val exp_adjust_res = exp_res_extSig + sig_res_tmp(SigWidth).asUInt // 11 bits
+  val isInf_res = sig_res_tmp(SigWidth) && exp_res_extSig === ~1.U(ExpWidth.W)
+  val exp_res = Mux(exp_adjust_res === 1.U && !sig_res(SigWidth - 1), 0.U, exp_adjust_res) // 11 bits
+
+  //---- Exception flags: NV DZ OF UF NX ----
+  val overflow = !special_S2 && (isInf_res || res_is_posInf_S2 || res_is_negInf_S2)
+  val nx = overflow || !special_S2 && (g_adderOut || s_adderOut)
+  val uf = nx && !overflow && exp_res === 0.U
+  val fflags = Cat(invalid_S2, false.B, overflow, uf, nx)
+
+  //-----------------------------------------
+  //---- Final result -----
+  //-----------------------------------------
+  val resFinal_tmp = Cat(sign_res_extSig, exp_res, sig_res(SigWidth - 2, 0))
+
+  //---- S3 (NStages = 4): register between rounding and the final result select ----
+  def regS3[T <: Data](x: T): T = if (NStages == 4) RegEnable(x, valid_S2) else x
+  val valid_S3 = if (NStages == 4) RegNext(valid_S2) else valid_S2
+  val resFinal_S3 = regS3(resFinal_tmp)
+  val sign_res_S3 = regS3(sign_res_extSig)
+  val isInf_res_S3 = regS3(isInf_res)
+  val res_is_posInf_S3 = regS3(res_is_posInf_S2)
+  val res_is_negInf_S3 = regS3(res_is_negInf_S2)
+  val res_is_nan_S3 = regS3(res_is_nan_S2)
+
+  io.res := MuxCase(resFinal_S3, Seq(
+          res_is_nan_S3 -> "h7FF8000000000000".U,
+          res_is_posInf_S3 -> "h7FF0000000000000".U,
+          res_is_negInf_S3 -> "hFFF0000000000000".U,
+          isInf_res_S3 -> sign_res_S3 ## ~0.U(ExpWidth.W) ## 0.U((SigWidth - 1).W)
+  ))
+  io.fflags := regS3(fflags)
+  io.valid_out := valid_S3
+}
+
+object VerilogFAdd_64 extends App {
+  println("Generating the FAdd_64 hardware")
+  emitVerilog(new FAdd_64, Array("--target-dir", "build/verilog_fadd_64"))
+}
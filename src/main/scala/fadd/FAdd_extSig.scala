@@ -30,8 +30,8 @@ class FpExtFormat(ExpWidth: Int, SigWidth: Int, ExtendedWidth: Int) extends Bund
 }
 
 class FAdd_extSig(
-    ExpWidth: Int, // fp16: 5   bf16: 8   fp32: 8
-    SigWidth: Int, // fp16: 11  bf16: 8   fp32: 24
+    ExpWidth: Int, // fp16: 5   bf16: 8   fp32: 8   fp64: 11
+    SigWidth: Int, // fp16: 11  bf16: 8   fp32: 24  fp64: 53
     ExtendedWidth: Int, // default: SigWidth + 2 (not necessary)
     // If you only do fp addition one time and the ExtAreZeros & UseShiftRightJam are true, you can set ExtendedWidth to 3
     ExtAreZeros: Boolean = false,
@@ -48,8 +48,11 @@ class FAdd_extSig(
     val valid_out = Output(Bool())
   })
 
-  require(ExpWidth == 5 || ExpWidth == 8, "Typical ExpWidth of FAdd_extSig is 5 (fp16) or 8 (fp32/bf16)")
-  require(SigWidth == 8 || SigWidth == 11 || SigWidth == 24, "Typical SigWidth of FAdd_extSig is 8 (fp16) or 11 (bf16) or 24 (fp32)")
+  // Typical: ExpWidth 5 (fp16) or 8 (fp32/bf16) or 11 (fp64), SigWidth 8 (bf16) or 11 (fp16) or 24 (fp32) or 53 (fp64).
+  // Smaller formats are allowed so that topFAddExtSig can be swept exhaustively.
+  require(ExpWidth >= 3 && ExpWidth <= 11, "ExpWidth of FAdd_extSig must be 3 .. 11")
+  require(SigWidth >= 3 && SigWidth <= 53, "SigWidth of FAdd_extSig must be 3 .. 53")
+  require(ExtendedWidth >= 1, "ExtendedWidth of FAdd_extSig must be at least 1")
 
   val sign_a = io.a.sign
   val sign_b = io.b.sign
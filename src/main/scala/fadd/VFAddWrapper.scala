@@ -5,6 +5,9 @@
   * 13.12 vfsgnj vfsgnjn vfsgnjx
   * 13.13 vmfeq vmfne vmflt vmfle vmfgt vmfge
   * 13.16 vfmv
+  * vfnadd vfnsub (uop.ctrl.narrow, custom): sew = 2*sew op 2*sew, fp32 sum rounded once to bf16/fp16
+  * sew = 64: one element per lane, add/sub by FAdd_64 (no widen/narrow), the others on the fast path
+  * Latency: add/sub (incl. widen/narrow) faddDelay, min/max/sgnj/compare/move fcmpDelay (no FAdd_16_32)
   */
 //TODO: compare output valid only on uopEnd
 //TODO: compare output 32b: last 2 bits   16b: last 4 bits (dirty code)
@@ -26,7 +29,7 @@ class LaneInput extends Bundle {
 class LaneOutput extends Bundle {
   val uop = new VUop
   val vd = UInt(LaneWidth.W)
-  val fflags = Vec(LaneWidth/16, UInt(5.W)) // For eew=32, fflags valid pattern is 0101
+  val fflags = Vec(LaneWidth/16, UInt(5.W)) // For eew=32, fflags valid pattern is 0101, for eew=64 0001
 }
 
 class VFAddWrapper extends Module {
@@ -34,15 +37,20 @@ class VFAddWrapper extends Module {
     val in = Input(ValidIO(new LaneInput))
     val sewIn = Input(new SewFpOH)
     val out = ValidIO(new LaneOutput)
+    // A fast-path op (compare/min/max/sgnj/move) may issue this cycle: no add completes in it
+    val fastReady = Output(Bool())
   })
 
   val vfadd0 = Module(new FAdd_16_32)
   val vfadd1 = Module(new FAdd_16_32)
+  val vfadd64 = Module(new FAdd_64)
 
   val uop = io.in.bits.uop
   val (vs1, vs2, vs3) = (io.in.bits.vs1, io.in.bits.vs2, io.in.bits.vs3)
-  val rs1 = Mux(io.sewIn.is16, Fill(4, io.in.bits.rs1(15, 0)), Fill(2, io.in.bits.rs1(31, 0)))
-  val res_is_16b = io.sewIn.is16 && !uop.ctrl.widen2 && !uop.ctrl.widen
+  val narrow = uop.ctrl.narrow
+  val in16 = io.sewIn.is16 && !narrow // 16-bit operands
+  val isFp64 = io.sewIn.isFp64
+  val rs1 = Mux(in16, Fill(4, io.in.bits.rs1(15, 0)), Mux(isFp64, io.in.bits.rs1, Fill(2, io.in.bits.rs1(31, 0))))
   
   // Widen case:
   //       32         32
@@ -65,12 +73,25 @@ class VFAddWrapper extends Module {
     Cat(fadd1_high, fadd1_low, fadd0_high, fadd0_low)
   }
   
+  val funct6 = uop.ctrl.funct6
+  val is16In = io.sewIn.is16
+  val isAdd = funct6 === 0.U || funct6(5, 4) === 3.U && !funct6(1)
+  val isMinMax = funct6(5, 2) === 1.U
+  val isCmp = funct6(5, 3) === 3.U
+  val isSub = funct6(5, 4) === 0.U && funct6(1) || funct6(5, 4) === 3.U && funct6(1)
+  val isRSub = funct6 === "b100111".U
+  val isSgn = funct6(5, 3) === 1.U
+  val isMove = funct6(5, 2) === "b0101".U && uop.ctrl.vm
+  // Compare, min/max, sign injection and move bypass the adder (see Fast path below)
+  val isFast = isMinMax || isCmp || isSgn || isMove
+
   Seq(vfadd0, vfadd1).foreach { vfadd =>
-    vfadd.io.valid_in := io.in.valid
+    vfadd.io.valid_in := io.in.valid && !isFast && !isFp64
     vfadd.io.is_bf16 := io.sewIn.isBf16
     vfadd.io.is_fp16 := io.sewIn.isFp16
     vfadd.io.is_fp32 := io.sewIn.isFp32
     vfadd.io.is_widen := uop.ctrl.widen || uop.ctrl.widen2
+    vfadd.io.is_narrow := narrow
     vfadd.io.a_already_widen := uop.ctrl.widen2
   }
 
@@ -80,115 +101,125 @@ class VFAddWrapper extends Module {
     vs1_32b(i) := Mux(uop.ctrl.vx, rs1, widen_sel(vs1)(i*32+31, i*32))
   }
 
-  val funct6 = uop.ctrl.funct6
-  val is16In = io.sewIn.is16
-  val isAdd = funct6 === 0.U || funct6(5, 4) === 3.U && !funct6(1)
-  val isMinMax = funct6(5, 2) === 1.U
-  val isCmp = funct6(5, 3) === 3.U
-  val isSub = isMinMax || isCmp ||
-              funct6(5, 4) === 0.U && funct6(1) || funct6(5, 4) === 3.U && funct6(1)
-  val isRSub = funct6 === "b100111".U
-  val isSgn = funct6(5, 3) === 1.U
-  val isMove = funct6(5, 2) === "b0101".U && uop.ctrl.vm
-
   Seq(vfadd0, vfadd1).zipWithIndex.foreach { case (vfadd, i) =>
-    vfadd.io.b := inv(vs1_32b(i), isSub, io.sewIn.is16)
-    vfadd.io.a := inv(vs2_32b(i), isRSub, io.sewIn.is16)
+    vfadd.io.b := inv(vs1_32b(i), isSub, in16)
+    vfadd.io.a := inv(vs2_32b(i), isRSub, in16)
   }
 
-  val faddOut_32b = Seq(vfadd0.io.res, vfadd1.io.res)
-  val faddOut_16b = Seq(faddOut_32b(0)(15, 0), faddOut_32b(0)(31, 16), faddOut_32b(1)(15, 0), faddOut_32b(1)(31, 16))
-  //  3,2,1,0 -> 63 47 31 15
-  val cmp_gte = Seq(faddOut_16b(0)(15), faddOut_16b(1)(15), faddOut_16b(2)(15), faddOut_16b(3)(15))
+  val vs1_op = Mux(uop.ctrl.vx, rs1, vs1)
+  vfadd64.io.valid_in := io.in.valid && !isFast && isFp64
+  vfadd64.io.b := inv(vs1_op, isSub)
+  vfadd64.io.a := inv(vs2, isRSub)
 
-  // Output
-  val out_valid = vfadd0.io.valid_out
-  val out_bits = Wire(new LaneOutput)
-  out_bits.fflags := VecInit(Seq.fill(LaneWidth/16)(0.U(5.W)))
-  out_bits.uop := RegEnable(RegEnable(uop, io.in.valid), vfadd0.io.valid_S1)
-  val funct6_S2 = out_bits.uop.ctrl.funct6
-  val vs1_S2 = RegEnable(RegEnable(vs1, io.in.valid), vfadd0.io.valid_S1)
-  val vs2_S2 = RegEnable(RegEnable(vs2, io.in.valid), vfadd0.io.valid_S1)
-  val rs1_S2 = RegEnable(RegEnable(rs1, io.in.valid), vfadd0.io.valid_S1)
-  val vs1_S2_16b = UIntSplit(vs1_S2, 16)
-  val vs2_S2_16b = UIntSplit(vs2_S2, 16)
-  val res_is_16b_S2 = RegEnable(RegEnable(res_is_16b, io.in.valid), vfadd0.io.valid_S1)
-  val isMinMax_S2 = RegEnable(RegEnable(isMinMax, io.in.valid), vfadd0.io.valid_S1)
-  val isSgn_S2 = RegEnable(RegEnable(isSgn, io.in.valid), vfadd0.io.valid_S1)
-  val isCmp_S2 = RegEnable(RegEnable(isCmp, io.in.valid), vfadd0.io.valid_S1)
-  val isMove_S2 = RegEnable(RegEnable(isMove, io.in.valid), vfadd0.io.valid_S1)
-
-  val vd_minmax, vd_sgn = Wire(Vec(4, UInt(16.W)))
-  val isMax_S2 = isMinMax_S2 && funct6_S2(1)
-  val isMin_S2 = isMinMax_S2 && !funct6_S2(1)
+  /**
+    * Fast path: vd = vs2 op vs1 (or rs1) from a comparator on the operand bits, no FAdd_16_32.
+    *   Latency = fcmpDelay (the output register only) instead of faddDelay. An add issued faddStages - 1
+    *   cycles earlier completes in the same cycle and owns the output register: io.fastReady is low and
+    *   the scheduler holds the fast op (adds may always issue).
+    *   Compares are false on NaN (vmfne true), -0 == +0.  Min/max are IEEE 754-2019 minimumNumber/
+    *   maximumNumber: a NaN operand returns the other one, two NaNs the canonical NaN, -0 < +0.
+    */
+  val isFp16 = io.sewIn.isFp16
+  def isNaN16(x: UInt): Bool = Mux(isFp16, x(14, 10).andR && x(9, 0).orR, x(14, 7).andR && x(6, 0).orR)
+  def isSNaN16(x: UInt): Bool = isNaN16(x) && !Mux(isFp16, x(9), x(6))
+  def isNaN32(x: UInt): Bool = x(30, 23).andR && x(22, 0).orR
+  def isSNaN32(x: UInt): Bool = isNaN32(x) && !x(22)
+  def isNaN64(x: UInt): Bool = x(62, 52).andR && x(51, 0).orR
+  def isSNaN64(x: UInt): Bool = isNaN64(x) && !x(51)
+  val qNaN16 = Mux(isFp16, "h7e00".U(16.W), "h7fc0".U(16.W))
+  val qNaN32 = "h7fc00000".U(32.W)
+  val qNaN64 = "h7ff8000000000000".U(64.W)
+  val (eq, le, lt, ne, gt, ge) = (funct6(2, 0) === 0.U, funct6(2, 0) === 1.U, funct6(2, 0) === 3.U,
+                                  funct6(2, 0) === 4.U, funct6(2, 0) === 5.U, funct6(2, 0) === 7.U)
+  val isOrderedCmp = isCmp && funct6(0)
+
+  // One element, x = vs2, y = vs1/rs1. Returns (min/max, sign injection, compare bit, NV)
+  def fastElem(x: UInt, y: UInt, isNaN: UInt => Bool, isSNaN: UInt => Bool, qNaN: UInt): (UInt, UInt, Bool, Bool) = {
+    val (x_nan, y_nan) = (isNaN(x), isNaN(y))
+    val (x_neg, y_neg) = (x.head(1).asBool, y.head(1).asBool)
+    val (x_mag, y_mag) = (x.tail(1), y.tail(1))
+    val mag_lt = x_mag < y_mag
+    val mag_eq = x_mag === y_mag
+    // x < y with -0 < +0 (NaNs excluded by the callers)
+    val lt_total = Mux(x_neg =/= y_neg, x_neg, Mux(x_neg, !mag_lt && !mag_eq, mag_lt))
+    val both_zero = x_mag === 0.U && y_mag === 0.U
+    val ordered = !x_nan && !y_nan
+    val cmp_eq = ordered && (x === y || both_zero)
+    val cmp_lt = ordered && lt_total && !both_zero
+    val cmp = Mux1H(Seq(
+      eq -> cmp_eq,
+      le -> (cmp_lt || cmp_eq),
+      lt -> cmp_lt,
+      ne -> !cmp_eq,
+      gt -> (ordered && !cmp_lt && !cmp_eq),
+      ge -> (ordered && !cmp_lt)
+    ))
+    val minmax = Mux(x_nan && y_nan, qNaN,
+                 Mux(x_nan, y,
+                 Mux(y_nan, x,
+                 Mux(lt_total =/= funct6(1), x, y))))
+    val sgn = Mux(funct6(1, 0) === 0.U, y_neg,
+              Mux(funct6(1, 0) === 1.U, !y_neg, x_neg ^ y_neg)) ## x_mag
+    val nv = Mux(isOrderedCmp, !ordered, isSNaN(x) || isSNaN(y))
+    (minmax, sgn, cmp, nv)
+  }
+  val fast16 = UIntSplit(vs2, 16).zip(UIntSplit(vs1_op, 16)).map { case (x, y) =>
+    fastElem(x, y, isNaN16, isSNaN16, qNaN16) }
+  val fast32 = UIntSplit(vs2, 32).zip(UIntSplit(vs1_op, 32)).map { case (x, y) =>
+    fastElem(x, y, isNaN32, isSNaN32, qNaN32) }
+  val fast64 = Seq(fastElem(vs2, vs1_op, isNaN64, isSNaN64, qNaN64))
+  def fastVd(res: Seq[(UInt, UInt, Bool, Bool)]): UInt = Mux1H(Seq(
+    isMinMax -> VecInit(res.map(_._1)).asUInt,
+    isSgn -> VecInit(res.map(_._2)).asUInt,
+    isCmp -> VecInit(res.map(_._3)).asUInt.pad(LaneWidth), // mask bits in the LSBs
+    isMove -> rs1
+  ))
+
+  val fast_valid = io.in.valid && isFast
+  val fast_bits = Wire(new LaneOutput)
+  fast_bits.uop := uop
+  fast_bits.vd := Mux(is16In, fastVd(fast16), Mux(isFp64, fastVd(fast64), fastVd(fast32)))
+  // fflags: min/max and compares only raise NV (signaling NaN operand, any NaN for the ordered
+  //   compares lt/le/gt/ge); sgnj and move raise nothing
   for (i <- 0 until 4) {
-    if (i % 2 == 1) {
-      vd_minmax(i) :=  Mux(cmp_gte(i) && isMax_S2 || !cmp_gte(i) && isMin_S2,
-                           vs1_S2_16b(i), vs2_S2_16b(i))
-      vd_sgn(i) := Mux(funct6_S2(1, 0) === 0.U, vs2_S2_16b(i)(15),
-                   Mux(funct6_S2(1, 0) === 1.U, !vs2_S2_16b(i)(15),
-                       vs1_S2_16b(i)(15) ^ vs2_S2_16b(i)(15))) ## vs1_S2_16b(i)(14, 0)
-    } else {
-      when (res_is_16b_S2) {
-        vd_minmax(i) :=  Mux(cmp_gte(i) && isMax_S2 || !cmp_gte(i) && isMin_S2,
-                             vs1_S2_16b(i), vs2_S2_16b(i))
-        vd_sgn(i) := Mux(funct6_S2(1, 0) === 0.U, vs2_S2_16b(i)(15),
-                     Mux(funct6_S2(1, 0) === 1.U, !vs2_S2_16b(i)(15),
-                         vs1_S2_16b(i)(15) ^ vs2_S2_16b(i)(15))) ## vs1_S2_16b(i)(14, 0)
-      }.otherwise {
-        vd_minmax(i) := Mux(cmp_gte(i+1) && isMax_S2 || !cmp_gte(i+1) && isMin_S2,
-                            vs1_S2_16b(i), vs2_S2_16b(i))
-        vd_sgn(i) := vs1_S2_16b(i)
-      }
-    }
+    val nv = Mux(is16In, fast16(i)._4, Mux(isFp64, if (i == 0) fast64(0)._4 else false.B,
+                                           if (i % 2 == 0) fast32(i / 2)._4 else false.B))
+    fast_bits.fflags(i) := Mux(isMinMax || isCmp, nv ## 0.U(4.W), 0.U)
   }
 
-  // Compare output
-  val cmp_eq_32b = faddOut_32b.map(x => x.tail(1) === 0.U)
-  val cmp_eq_16b = faddOut_16b.map(x => x.tail(1) === 0.U)
-  val cmp_ge_32b = Seq(cmp_gte(1), cmp_gte(3))
-  val cmp_ge_16b = cmp_gte
-  val cmp_ne_32b = cmp_eq_32b.map(!_)
-  val cmp_ne_16b = cmp_eq_16b.map(!_)
-  val cmp_lt_32b = cmp_ge_32b zip cmp_ne_32b map { case (ge, ne) => !ge && ne }
-  val cmp_lt_16b = cmp_ge_16b zip cmp_ne_16b map { case (ge, ne) => !ge && ne }
-  val cmp_le_32b = cmp_ge_32b zip cmp_eq_32b map { case (ge, eq) => !ge || eq }
-  val cmp_le_16b = cmp_ge_16b zip cmp_eq_16b map { case (ge, eq) => !ge || eq }
-  val cmp_gt_32b = cmp_ge_32b zip cmp_ne_32b map { case (ge, ne) => ge && ne }
-  val cmp_gt_16b = cmp_ge_16b zip cmp_ne_16b map { case (ge, ne) => ge && ne }
+  // Output of the adder path
+  // Side data follows FAdd_16_32 (faddStages - 1 cycles)
+  def pipeS2[T <: Data](x: T): T = ValidPipe(x, io.in.valid, faddStages - 1)
+  val out_valid = vfadd0.io.valid_out || vfadd64.io.valid_out
+  val fp64_S2 = vfadd64.io.valid_out
+  io.fastReady := !out_valid // valid_out of the adders is a stage register, no path from io.in
+  val out_bits = Wire(new LaneOutput)
+  out_bits.uop := pipeS2(uop)
+  val vs3_S2 = pipeS2(vs3)
+  val narrow_S2 = out_bits.uop.ctrl.narrow
+  val uopIdx0_S2 = out_bits.uop.uopIdx(0)
 
-  val (eq, le, lt, ne, gt, ge) = (funct6(2, 0) === 0.U, funct6(2, 0) === 1.U, funct6(2, 0) === 3.U,
-                                  funct6(2, 0) === 4.U, funct6(2, 0) === 5.U, funct6(2, 0) === 7.U)
-  val vd_cmp_32b = Mux1H(Seq(
-    eq -> VecInit(cmp_eq_32b).asUInt,
-    le -> VecInit(cmp_le_32b).asUInt,
-    lt -> VecInit(cmp_lt_32b).asUInt,
-    ne -> VecInit(cmp_ne_32b).asUInt,
-    gt -> VecInit(cmp_gt_32b).asUInt,
-    ge -> VecInit(cmp_ge_32b).asUInt
-  ))
-  val vd_cmp_16b = Mux1H(Seq(
-    eq -> VecInit(cmp_eq_16b).asUInt,
-    le -> VecInit(cmp_le_16b).asUInt,
-    lt -> VecInit(cmp_lt_16b).asUInt,
-    ne -> VecInit(cmp_ne_16b).asUInt,
-    gt -> VecInit(cmp_gt_16b).asUInt,
-    ge -> VecInit(cmp_ge_16b).asUInt
-  ))
-  val vd_cmp = Mux(res_is_16b_S2, vd_cmp_16b.pad(LaneWidth), vd_cmp_32b.pad(LaneWidth))
+  val fflags_fadd = vfadd0.io.fflags ++ vfadd1.io.fflags
+  val fflags_narrow = Seq(vfadd0.io.fflags(1), vfadd1.io.fflags(1))
+  for (i <- 0 until 4) {
+    out_bits.fflags(i) := Mux(fp64_S2, if (i == 0) vfadd64.io.fflags else 0.U,
+                          Mux(narrow_S2, Mux(uopIdx0_S2 === (i >= 2).B, fflags_narrow(i % 2), 0.U), fflags_fadd(i)))
+  }
 
-  out_bits.vd := MuxCase(Cat(vfadd1.io.res, vfadd0.io.res), Seq(
-    isMinMax_S2 -> vd_minmax.asUInt,
-    isSgn_S2 -> vd_sgn.asUInt,
-    isMove_S2 -> rs1_S2,
-    isCmp_S2 -> vd_cmp
-  ))
+  // Narrow case (reverse of widen): each FAdd_16_32 returns its 16-bit result in the high half,
+  //   the two results fill the half of vd selected by uopIdx(0), the other half keeps the old vd (vs3)
+  val vd_narrow_32b = Cat(vfadd1.io.res(31, 16), vfadd0.io.res(31, 16))
+  val vd_narrow = Mux(uopIdx0_S2, Cat(vd_narrow_32b, vs3_S2(31, 0)), Cat(vs3_S2(63, 32), vd_narrow_32b))
+
+  out_bits.vd := Mux(fp64_S2, vfadd64.io.res, Mux(narrow_S2, vd_narrow, Cat(vfadd1.io.res, vfadd0.io.res)))
 
   /**
-    *  Put a register on the output of FAdd_16_32, since the FAdd_16_32 output rounding has some dealy of combinational logic
+    *  Put a register on the output of FAdd_16_32, since the FAdd_16_32 output rounding has some dealy of combinational logic.
+    *  The fast path shares this register (one write-back port).
     */
-  io.out.valid := RegNext(out_valid)
-  io.out.bits := RegEnable(out_bits, out_valid)
+  assert(!(fast_valid && out_valid), "VFAddWrapper: fast-path op issued while io.fastReady is low")
+  io.out.valid := RegNext(out_valid || fast_valid)
+  io.out.bits := RegEnable(Mux(fast_valid, fast_bits, out_bits), out_valid || fast_valid)
   
   def inv(fp: UInt, inv_bit: Bool): UInt = {
     Cat(inv_bit ^ fp(fp.getWidth - 1), fp(fp.getWidth - 2, 0))
@@ -0,0 +1,172 @@
+/**
+  * 14.3 vfredusum vfredosum    14.4 vfwredusum vfwredosum
+  *   vd[0] = sum(vs2[*]) + vs1[0] over one whole vector register (vl = VLMAX, no mask)
+  * Formats: fp32, fp16, bf16 and widening fp16/bf16 -> fp32 (vs1[0] and vd[0] are fp32)
+  *
+  * Unordered: tree of FAdd_16_32, fully pipelined, one reduction per cycle.
+  *   Level 0 (VLEN/32 FAdds):  elem i + elem i + N/2  (widen: 16b -> fp32 here)
+  *   Level 1..log2(VLEN/32):   halving, the last level adds the two 16b halves of one word
+  *                             (fp32: adds -0, so every format has the same latency)
+  *   Scalar level:             + vs1[0]
+  *   Latency = (log2(VLEN/32) + 2) * (faddStages - 1) cycles = VParams.fredFp16Delay/fredFp32Delay - delayBias,
+  *   control travels with the data.
+  * Ordered: one FAdd_16_32 accumulating element by element (strict order), faddStages - 1 cycles per element.
+  *   ready is low while an ordered reduction is running.
+  */
+package race.vpu.exu.laneexu.fp
+
+import chisel3._
+import chisel3.util._
+import race.vpu._
+import VParams._
+
+class FRedCtrl extends Bundle {
+  val is_bf16, is_fp16, is_fp32 = Bool()
+  val is_widen = Bool()
+  val vs1 = UInt(32.W)  // vs1[0], added at the scalar level
+}
+
+class VFRed extends Module {
+  val NFAdd = VLEN / 32
+  val NHalve = log2Up(NFAdd)
+  val io = IO(new Bundle {
+    val valid_in = Input(Bool())
+    val is_bf16, is_fp16, is_fp32 = Input(Bool())
+    val is_widen = Input(Bool())
+    val is_ordered = Input(Bool())
+    val vs2 = Input(UInt(VLEN.W))
+    val vs1 = Input(UInt(32.W))  // 16b formats: vs1[0] in the low half
+    val ready = Output(Bool())
+    val res = Output(UInt(32.W)) // 16b formats: vd[0] in the low half
+    val valid_out = Output(Bool())
+  })
+
+  val negZero32 = "h80000000".U(32.W)
+
+  // One level of n FAdd_16_32 (faddStages - 1 cycles), ctrl follows the data like the S1/S2 registers in FAdd_16_32
+  def faddLevel(n: Int, valid: Bool, ctrl: FRedCtrl, fmt: (Bool, Bool, Bool, Bool),
+                a: Seq[UInt], b: Seq[UInt]): (Bool, FRedCtrl, Seq[UInt]) = {
+    val fadd = Seq.fill(n)(Module(new FAdd_16_32))
+    val (is_bf16, is_fp16, is_fp32, is_widen) = fmt
+    for (i <- 0 until n) {
+      fadd(i).io.valid_in := valid
+      fadd(i).io.is_bf16 := is_bf16
+      fadd(i).io.is_fp16 := is_fp16
+      fadd(i).io.is_fp32 := is_fp32
+      fadd(i).io.is_widen := is_widen
+      fadd(i).io.is_narrow := false.B
+      fadd(i).io.a_already_widen := false.B
+      fadd(i).io.a := a(i)
+      fadd(i).io.b := b(i)
+    }
+    (fadd(0).io.valid_out, ValidPipe(ctrl, valid, faddStages - 1), fadd.map(_.io.res))
+  }
+  // Format of the partial sums after level 0
+  def sumFmt(c: FRedCtrl) = (c.is_bf16 && !c.is_widen, c.is_fp16 && !c.is_widen, c.is_fp32 || c.is_widen, false.B)
+  def res16(c: FRedCtrl) = !c.is_fp32 && !c.is_widen
+  def low16(x: UInt) = Cat(0.U(16.W), x(15, 0))
+
+  /**
+    * Unordered (tree)
+    */
+  val ordBusy = RegInit(false.B)
+  io.ready := !ordBusy
+
+  val ctrl_in = Wire(new FRedCtrl)
+  ctrl_in.is_bf16 := io.is_bf16
+  ctrl_in.is_fp16 := io.is_fp16
+  ctrl_in.is_fp32 := io.is_fp32
+  ctrl_in.is_widen := io.is_widen
+  ctrl_in.vs1 := io.vs1
+  val tree_valid_in = io.valid_in && !io.is_ordered && !ordBusy
+
+  // Level 0:  fp32/fp16/bf16: word j + word j + NFAdd/2 (j < NFAdd/2)
+  //           widen: 16b elem j + elem j + NFAdd -> fp32 (all NFAdd FAdds)
+  val vs2_32b = UIntSplit(io.vs2, 32)
+  val vs2_16b = UIntSplit(io.vs2, 16)
+  val a_L0 = Seq.tabulate(NFAdd)(j => Mux(io.is_widen, Cat(vs2_16b(j), 0.U(16.W)),
+                                           if (j < NFAdd/2) vs2_32b(j) else 0.U))
+  val b_L0 = Seq.tabulate(NFAdd)(j => Mux(io.is_widen, Cat(vs2_16b(j + NFAdd), 0.U(16.W)),
+                                           if (j < NFAdd/2) vs2_32b(j + NFAdd/2) else 0.U))
+  var (valid, ctrl, sum) = faddLevel(NFAdd, tree_valid_in, ctrl_in,
+                                     (io.is_bf16, io.is_fp16, io.is_fp32, io.is_widen), a_L0, b_L0)
+
+  // Level k: n = NFAdd >> k FAdds. Widen has 2n partial sums left, the others n.
+  for (k <- 1 to NHalve) {
+    val n = NFAdd >> k
+    val (a, b) = if (n > 1) {
+      (Seq.tabulate(n)(j => sum(j)),
+       Seq.tabulate(n)(j => if (j < n/2) Mux(ctrl.is_widen, sum(j + n), sum(j + n/2)) else sum(j + n)))
+    } else {
+      (Seq(Mux(res16(ctrl), low16(sum(0)), sum(0))),
+       Seq(Mux(res16(ctrl), low16(sum(0) >> 16), Mux(ctrl.is_widen, sum(1), negZero32))))
+    }
+    val lvl = faddLevel(n, valid, ctrl, sumFmt(ctrl), a, b)
+    valid = lvl._1
+    ctrl = lvl._2
+    sum = lvl._3
+  }
+
+  // Scalar level: + vs1[0]
+  val (tree_valid_out, tree_ctrl_out, tree_res) = faddLevel(1, valid, ctrl, sumFmt(ctrl),
+    Seq(sum(0)), Seq(Mux(res16(ctrl), low16(ctrl.vs1), ctrl.vs1)))
+
+  /**
+    * Ordered (sequential)
+    */
+  val ordFAdd = Module(new FAdd_16_32)
+  val ordCtrl = Reg(new FRedCtrl)
+  val ordVs2 = Reg(UInt(VLEN.W))
+  val ordAcc = Reg(UInt(32.W))
+  val ordIdx = Reg(UInt(log2Up(2 * NFAdd).W))  // element in flight (or next to issue)
+  val ordInFlight = RegInit(false.B)
+
+  val ordStart = io.valid_in && io.is_ordered && !ordBusy
+  val ordResValid = ordFAdd.io.valid_out
+  val ordAccNow = Mux(ordResValid, ordFAdd.io.res, ordAcc)
+  val ordLast = Mux(ordCtrl.is_fp32, (NFAdd - 1).U, (2 * NFAdd - 1).U)
+  val ordFinish = ordResValid && ordIdx === ordLast
+  val ordNextIdx = Mux(ordResValid, ordIdx + 1.U, ordIdx)
+  // The next element is issued in the cycle the previous sum comes out
+  val ordIssue = ordBusy && !ordFinish && (!ordInFlight || ordResValid)
+
+  when (ordStart) {
+    ordBusy := true.B
+    ordCtrl := ctrl_in
+    ordVs2 := io.vs2
+    ordAcc := Mux(!io.is_fp32 && !io.is_widen, low16(io.vs1), io.vs1)
+    ordIdx := 0.U
+  }.elsewhen (ordFinish) {
+    ordBusy := false.B
+  }
+  when (ordResValid) {
+    ordAcc := ordAccNow
+    ordIdx := ordNextIdx
+  }
+  ordInFlight := ordIssue || ordInFlight && !ordResValid
+
+  val ordElem16 = VecInit(UIntSplit(ordVs2, 16))(ordNextIdx)
+  val ordElem32 = VecInit(UIntSplit(ordVs2, 32))(ordNextIdx(log2Up(NFAdd) - 1, 0))
+  ordFAdd.io.valid_in := ordIssue
+  ordFAdd.io.is_bf16 := ordCtrl.is_bf16
+  ordFAdd.io.is_fp16 := ordCtrl.is_fp16
+  ordFAdd.io.is_fp32 := ordCtrl.is_fp32
+  ordFAdd.io.is_widen := ordCtrl.is_widen
+  ordFAdd.io.is_narrow := false.B
+  ordFAdd.io.a_already_widen := ordCtrl.is_widen  // fp32 accumulator + 16b element
+  ordFAdd.io.a := Mux(res16(ordCtrl), low16(ordAccNow), ordAccNow)
+  ordFAdd.io.b := Mux(ordCtrl.is_fp32, ordElem32,
+                  Mux(ordCtrl.is_widen, Cat(ordElem16, 0.U(16.W)), Cat(0.U(16.W), ordElem16)))
+
+  /**
+    * Output (an ordered reduction only starts when ready, and takes longer than the tree to drain)
+    */
+  io.valid_out := tree_valid_out || ordFinish
+  io.res := Mux(ordFinish, Mux(res16(ordCtrl), low16(ordAccNow), ordAccNow),
+                Mux(res16(tree_ctrl_out), low16(tree_res(0)), tree_res(0)))
+}
+
+object VFRed extends App {
+  println("Generating the VFRed hardware")
+  emitVerilog(new VFRed(), Array("--target-dir", "build/verilog_fadd"))
+}
@@ -66,6 +66,7 @@ class VFMAWrapper extends Module {
     vfma.io.is_fp16 := io.sewIn.isFp16
     vfma.io.is_fp32 := io.sewIn.isFp32
     vfma.io.is_widen := uop.ctrl.widen
+    vfma.io.acc_fwd := false.B
   }
 
   val vs1_32b, vs2_32b, vd_32b = Wire(Vec(2, UInt(32.W)))
@@ -14,6 +14,11 @@
   *   5) wResMul32 is tunable parameter: larger wResMul32 means better precision and higher hardware cost
   *      TODO: if wResMul32 < 48 and you care about precision, rounding after a*b result truncation should be added !
   *   6) Note: the shifting blocks have no sticky-bit logic
+  *   7) Accumulator forwarding (acc_fwd): c of this op is the previous res_out of this unit instead of c_in,
+  *      taken into the S2 addend register, so a dependent c = a*b + c chain can issue every 2 cycles.
+  *      A forwarded op may only issue when acc_ready is high (no op in S1).
+  *   8) Flush = true: io.robIdx_in travels with the op (io.robIdx_out). An op covered by io.flush is dropped from
+  *      whatever stage it is in during that cycle (valid_in included), so it never raises valid_out
   */
 
 package race.vpu.exu.laneexu.fp
@@ -24,7 +29,7 @@ import race.vpu._
 import VParams._
 import race.vpu.yunsuan.util._
 
-class VFMA_16_32 extends Module {
+class VFMA_16_32(Flush: Boolean = false) extends Module {
   val wResMul32 = 48  // Bits to reserve for the significand of the a*b (range: 28 ~ 48)
   val wResMul16 = wResMul32 / 2  // Bits (FP/BF16) to reserve for the significand of the a*b
   //  TODO: if wResMul32 < 48 and you care about precision, rounding after a*b result truncation should be added !
@@ -36,11 +41,20 @@ class VFMA_16_32 extends Module {
     val a_in = Input(UInt(32.W))
     val b_in = Input(UInt(32.W))
     val c_in = Input(UInt(32.W))
+    val acc_fwd = Input(Bool())
+    val acc_ready = Output(Bool())
     val res_out = Output(UInt(32.W))
     val valid_out = Output(Bool())
     val valid_S1, valid_S2 = Output(Bool())
+    val flush = if (Flush) Some(Input(new VFlush)) else None
+    val robIdx_in = if (Flush) Some(Input(new RobPtr)) else None
+    val robIdx_out = if (Flush) Some(Output(new RobPtr)) else None
   })
 
+  // Flush: an op is killed in the stage it is in, the valid of that stage is cleared
+  def killed(robIdx: Option[RobPtr]): Bool = io.flush.map(_.needFlush(robIdx.get)).getOrElse(false.B)
+  val valid_S0 = io.valid_in && !killed(io.robIdx_in)
+
   val (is_bf16, is_fp16, is_fp32) = (io.is_bf16, io.is_fp16, io.is_fp32)
   val is_16 = is_fp16 || is_bf16
   val widen = io.is_widen
@@ -113,10 +127,11 @@ class VFMA_16_32 extends Module {
                           Cat(sig_adjust_subnorm_16(2), false.B, sig_adjust_subnorm_16(0), false.B))
   intMul_12_24.io.b_in := Mux(!is_16, sig_adjust_subnorm_32(1),
                           Cat(sig_adjust_subnorm_16(3), false.B, sig_adjust_subnorm_16(1), false.B))
-  intMul_12_24.io.valid_in := io.valid_in
+  intMul_12_24.io.valid_in := valid_S0
   intMul_12_24.io.is_16 := is_16
-  val widen_S1 = RegEnable(widen, io.valid_in)
-  val valid_S1 = intMul_12_24.io.valid_out
+  val widen_S1 = RegEnable(widen, valid_S0)
+  val robIdx_S1 = io.robIdx_in.map(RegEnable(_, valid_S0))
+  val valid_S1 = intMul_12_24.io.valid_out && !killed(robIdx_S1)
   val res_intMul_S1 = intMul_12_24.io.res_out
 
   /**
@@ -145,20 +160,20 @@ class VFMA_16_32 extends Module {
   //----------------------------------------
   //---- Below is S1 (pipeline 1) stage ----
   //----------------------------------------
-  val input_is_16_S1 = RegEnable(is_16, io.valid_in)
-  val res_is_32_S1 = RegEnable(res_is_32, io.valid_in)
-  val res_is_bf16_S1 = RegEnable(res_is_bf16, io.valid_in)
-  val res_is_fp16_S1 = RegEnable(res_is_fp16, io.valid_in)
-  val is_zero_16_S1 = is_zero_16.map(RegEnable(_, io.valid_in))
-  val is_zero_32_S1 = is_zero_32.map(RegEnable(_, io.valid_in))
-  val is_inf_16_S1 = is_inf_16.map(RegEnable(_, io.valid_in))
-  val is_inf_32_S1 = is_inf_32.map(RegEnable(_, io.valid_in))
-  val exp_res_adjsubn_high_S1 = RegEnable(exp_res_adjsubn_high, io.valid_in)  // 10 bits
-  val exp_res_adjsubn_low_S1 = RegEnable(exp_res_adjsubn_low, io.valid_in)    // 10 bits
-  val res_is_inf_high_S1 = RegEnable(res_is_inf_high, io.valid_in)
-  val res_is_inf_low_S1 = RegEnable(res_is_inf_low, io.valid_in)
-  val res_sign_high_S1 = RegEnable(res_sign_high, io.valid_in)
-  val res_sign_low_S1 = RegEnable(res_sign_low, io.valid_in)
+  val input_is_16_S1 = RegEnable(is_16, valid_S0)
+  val res_is_32_S1 = RegEnable(res_is_32, valid_S0)
+  val res_is_bf16_S1 = RegEnable(res_is_bf16, valid_S0)
+  val res_is_fp16_S1 = RegEnable(res_is_fp16, valid_S0)
+  val is_zero_16_S1 = is_zero_16.map(RegEnable(_, valid_S0))
+  val is_zero_32_S1 = is_zero_32.map(RegEnable(_, valid_S0))
+  val is_inf_16_S1 = is_inf_16.map(RegEnable(_, valid_S0))
+  val is_inf_32_S1 = is_inf_32.map(RegEnable(_, valid_S0))
+  val exp_res_adjsubn_high_S1 = RegEnable(exp_res_adjsubn_high, valid_S0)  // 10 bits
+  val exp_res_adjsubn_low_S1 = RegEnable(exp_res_adjsubn_low, valid_S0)    // 10 bits
+  val res_is_inf_high_S1 = RegEnable(res_is_inf_high, valid_S0)
+  val res_is_inf_low_S1 = RegEnable(res_is_inf_low, valid_S0)
+  val res_sign_high_S1 = RegEnable(res_sign_high, valid_S0)
+  val res_sign_low_S1 = RegEnable(res_sign_low, valid_S0)
 
   // Int MUL result format (when wResMul32 = 48, wResMul16 = 24):
   // xx.xxxxxxxxxxxxxx00000000  bf16 (2 + 14 + "000000" + "00")
@@ -283,7 +298,8 @@ class VFMA_16_32 extends Module {
   //-----------------------------------------
   //---- Below is S2 (pipeline 2) stage:
   //-----------------------------------------
-  val valid_S2 = RegNext(valid_S1)
+  val robIdx_S2 = robIdx_S1.map(RegEnable(_, valid_S1))
+  val valid_S2 = RegNext(valid_S1) && !killed(robIdx_S2)
   val input_is_16_S2 = RegEnable(is_16, valid_S1)
   val res_is_32_S2 = RegEnable(res_is_32, valid_S1)
   val res_is_bf16_S2 = RegEnable(res_is_bf16, valid_S1)
@@ -305,12 +321,16 @@ class VFMA_16_32 extends Module {
   //-------------------------------------------------------
   //---- Here is S2 (pipeline 2) stage of addend (c) ------
   //-------------------------------------------------------
-  val c_in_S1 = RegEnable(io.c_in, io.valid_in)
-  val c_in_S2 = RegEnable(c_in_S1, valid_S1)
+  val c_in_S1 = RegEnable(io.c_in, valid_S0)
+  // Accumulator forwarding: the previous result (just out of S3, or held since) replaces c
+  val acc_fwd_S1 = RegEnable(io.acc_fwd, false.B, valid_S0)
+  val res_last = RegEnable(io.res_out, io.valid_out)
+  val c_fwd = Mux(io.valid_out, io.res_out, res_last)
+  val c_in_S2 = RegEnable(Mux(acc_fwd_S1, c_fwd, c_in_S1), valid_S1)
   val (sign_c_high, sign_c_low) = (c_in_S2(31), c_in_S2(15))
   val widen_S2 = RegEnable(widen, valid_S1)
   val c_is_32 = !input_is_16_S2 || widen_S2
-  val c_is_fp16 = RegEnable(RegEnable(is_fp16, io.valid_in), valid_S1)
+  val c_is_fp16 = RegEnable(RegEnable(is_fp16, valid_S0), valid_S1)
   val exp_high_c, exp_low_c = Wire(UInt(8.W))
   exp_high_c := Mux(c_is_fp16 && !widen_S2, c_in_S2(30, 30-5+1), c_in_S2(30, 30-8+1))
   exp_low_c := Mux(c_is_fp16 && !widen_S2, c_in_S2(14, 14-5+1), c_in_S2(14, 14-8+1))
@@ -507,7 +527,8 @@ class VFMA_16_32 extends Module {
   //---- Below is S3 (pipeline 3) stage:
   //       Adder result shifting and rounding
   //--------------------------------------------------
-  val valid_S3 = RegNext(valid_S2)
+  val robIdx_S3 = robIdx_S2.map(RegEnable(_, valid_S2))
+  val valid_S3 = RegNext(valid_S2) && !killed(robIdx_S3)
   val c_in_S3 = RegEnable(c_in_S2, valid_S2)
   val input_is_16_S3 = RegEnable(input_is_16_S2, valid_S2)
   val res_is_32_S3 = RegEnable(res_is_32_S2, valid_S2)
@@ -749,6 +770,8 @@ class VFMA_16_32 extends Module {
   
   io.res_out := Mux(res_is_32_S3, res_out_whole32, res_out_high16 ## res_out_low16)
   io.valid_out := valid_S3
+  io.robIdx_out.foreach(_ := robIdx_S3.get)
+  io.acc_ready := !valid_S1
   io.valid_S1 := valid_S1
   io.valid_S2 := valid_S2
 
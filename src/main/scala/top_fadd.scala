@@ -12,6 +12,7 @@ class top extends Module{
     val valid_in = Input(Bool())
     val is_bf16, is_fp16, is_fp32 = Input(Bool())
     val is_widen, a_already_widen = Input(Bool())
+    val is_narrow = Input(Bool()) // a_in_32 + b_in_32 -> res_out_16(1), is_bf16/is_fp16 give the format
     val a_in_32 = Input(UInt(32.W))
     val b_in_32 = Input(UInt(32.W))
     val a_in_16 = Input(Vec(2, UInt(16.W)))
@@ -19,18 +20,22 @@ class top extends Module{
 
     val res_out_32 = Output(UInt(32.W))
     val res_out_16 = Output(Vec(2, UInt(16.W)))
+    val fflags_out = Output(Vec(2, UInt(5.W))) // NV DZ OF UF NX: 16-bit results 0/1, 32-bit result in 0, narrowed in 1
     val valid_out = Output(Bool())
+    // VParams constants for the harness latency check
+    val fadd_delay, delay_bias = Output(UInt(8.W))
   })
 
-  val fadd = Module(new FAdd_16_32(3, 3))
+  val fadd = Module(new FAdd_16_32(3, 3, faddStages))
   fadd.io.valid_in := io.valid_in
   fadd.io.is_bf16 := io.is_bf16
   fadd.io.is_fp16 := io.is_fp16
   fadd.io.is_fp32 := io.is_fp32
   fadd.io.is_widen := io.is_widen
+  fadd.io.is_narrow := io.is_narrow
   fadd.io.a_already_widen := io.a_already_widen
 
-  when(io.is_fp32) {
+  when(io.is_fp32 || io.is_narrow) {
     fadd.io.a := io.a_in_32
     fadd.io.b := io.b_in_32
   }.otherwise {
@@ -40,7 +45,10 @@ class top extends Module{
 
   io.res_out_32 := fadd.io.res
   io.res_out_16 := VecInit(fadd.io.res(15, 0), fadd.io.res(31, 16))
+  io.fflags_out := fadd.io.fflags
   io.valid_out := fadd.io.valid_out
+  io.fadd_delay := faddDelay.U
+  io.delay_bias := delayBias.U
 }
 
 object top extends App {
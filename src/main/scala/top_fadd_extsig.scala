@@ -0,0 +1,66 @@
+package top
+
+import chisel3._
+import chisel3.util._
+import chisel3.stage._
+import race.vpu._
+import race.vpu.VParams._
+import race.vpu.exu.laneexu.fp._
+
+// FAdd_extSig alone, on its FpExtFormat interface. The configuration is also
+// driven out as constants so the harness can build its reference from it.
+class topFAddExtSig(ExpWidth: Int, SigWidth: Int, ExtendedWidth: Int,
+                    ExtAreZeros: Boolean, UseShiftRightJam: Boolean) extends Module{
+  val io = IO(new Bundle {
+    val valid_in = Input(Bool())
+    val is_fp16 = Input(Bool())
+    val a, b = Input(new FpExtFormat(ExpWidth, SigWidth, ExtendedWidth))
+    val a_is_inf, b_is_inf = Input(Bool())
+    val a_is_nan, b_is_nan = Input(Bool())
+
+    val res = Output(new FpExtFormat(ExpWidth, SigWidth, ExtendedWidth + 1))
+    val res_is_posInf, res_is_negInf, res_is_nan = Output(Bool())
+    val valid_out = Output(Bool())
+    val cfg_exp_width, cfg_sig_width, cfg_ext_width = Output(UInt(8.W))
+    val cfg_ext_are_zeros, cfg_shift_right_jam = Output(Bool())
+  })
+
+  val fadd = Module(new FAdd_extSig(ExpWidth, SigWidth, ExtendedWidth, ExtAreZeros, UseShiftRightJam))
+  fadd.io.valid_in := io.valid_in
+  fadd.io.is_fp16 := io.is_fp16
+  fadd.io.a := io.a
+  fadd.io.b := io.b
+  fadd.io.a_is_inf := io.a_is_inf
+  fadd.io.b_is_inf := io.b_is_inf
+  fadd.io.a_is_nan := io.a_is_nan
+  fadd.io.b_is_nan := io.b_is_nan
+
+  io.res := fadd.io.res
+  io.res_is_posInf := fadd.io.res_is_posInf
+  io.res_is_negInf := fadd.io.res_is_negInf
+  io.res_is_nan := fadd.io.res_is_nan
+  io.valid_out := fadd.io.valid_out
+  io.cfg_exp_width := ExpWidth.U
+  io.cfg_sig_width := SigWidth.U
+  io.cfg_ext_width := ExtendedWidth.U
+  io.cfg_ext_are_zeros := ExtAreZeros.B
+  io.cfg_shift_right_jam := UseShiftRightJam.B
+}
+
+// Configuration as Key=Value arguments before the ChiselStage ones, e.g.
+//   runMain top.topFAddExtSig ExpWidth=5 SigWidth=8 ExtendedWidth=2 ExtAreZeros=0 -td build
+object topFAddExtSig extends App {
+  val (cfgArgs, stageArgs) = args.partition(_.contains("="))
+  val cfg = cfgArgs.map(_.split("=", 2)).map(kv => kv(0) -> kv(1)).toMap
+  def int(key: String, default: Int) = cfg.get(key).map(_.toInt).getOrElse(default)
+  def bool(key: String, default: Boolean) = cfg.get(key).map(v => v == "1" || v == "true").getOrElse(default)
+  val expWidth = int("ExpWidth", 8)
+  val sigWidth = int("SigWidth", 24)
+  val extWidth = int("ExtendedWidth", 3)
+  val extAreZeros = bool("ExtAreZeros", true)
+  val useShiftRightJam = bool("UseShiftRightJam", extAreZeros)
+  println(s"Generating the top FAdd_extSig hardware: ExpWidth=$expWidth SigWidth=$sigWidth " +
+          s"ExtendedWidth=$extWidth ExtAreZeros=$extAreZeros UseShiftRightJam=$useShiftRightJam")
+  (new ChiselStage).emitVerilog(new topFAddExtSig(expWidth, sigWidth, extWidth, extAreZeros, useShiftRightJam),
+                                stageArgs)
+}
@@ -0,0 +1,76 @@
+package top
+
+import chisel3._
+import chisel3.util._
+import chisel3.stage._
+import race.vpu._
+import race.vpu.VParams._
+import race.vpu.exu.laneexu.fp._
+
+// One op for a unit of topFlush; 16-bit formats: two elements in the halves of a/b/c, c is FMA only
+class FlushTopIn extends Bundle {
+  val valid = Bool()
+  val is_bf16, is_fp16, is_fp32 = Bool()
+  val robIdx = new RobPtr
+  val a, b, c = UInt(32.W)
+}
+
+class FlushTopOut extends Bundle {
+  val valid = Bool()
+  val robIdx = new RobPtr
+  val res = UInt(32.W)
+}
+
+/**
+  * FAdd_16_32 and VFMA_16_32 with Flush = true side by side, one flush for both (like a squash of the lane EXU).
+  */
+class topFlush extends Module {
+  val io = IO(new Bundle {
+    val flush = Input(new VFlush)
+    val fadd_in, fma_in = Input(new FlushTopIn)
+    val fadd_out, fma_out = Output(new FlushTopOut)
+    // VParams constants for the harness latency check
+    val fadd_delay, fma_delay, delay_bias = Output(UInt(8.W))
+  })
+
+  val fadd = Module(new FAdd_16_32(NStages = faddStages, Flush = true))
+  fadd.io.valid_in := io.fadd_in.valid
+  fadd.io.is_bf16 := io.fadd_in.is_bf16
+  fadd.io.is_fp16 := io.fadd_in.is_fp16
+  fadd.io.is_fp32 := io.fadd_in.is_fp32
+  fadd.io.is_widen := false.B
+  fadd.io.is_narrow := false.B
+  fadd.io.a_already_widen := false.B
+  fadd.io.a := io.fadd_in.a
+  fadd.io.b := io.fadd_in.b
+  fadd.io.flush.get := io.flush
+  fadd.io.robIdx_in.get := io.fadd_in.robIdx
+
+  val fma = Module(new VFMA_16_32(Flush = true))
+  fma.io.valid_in := io.fma_in.valid
+  fma.io.is_bf16 := io.fma_in.is_bf16
+  fma.io.is_fp16 := io.fma_in.is_fp16
+  fma.io.is_fp32 := io.fma_in.is_fp32
+  fma.io.is_widen := false.B
+  fma.io.a_in := io.fma_in.a
+  fma.io.b_in := io.fma_in.b
+  fma.io.c_in := io.fma_in.c
+  fma.io.acc_fwd := false.B
+  fma.io.flush.get := io.flush
+  fma.io.robIdx_in.get := io.fma_in.robIdx
+
+  io.fadd_out.valid := fadd.io.valid_out
+  io.fadd_out.robIdx := fadd.io.robIdx_out.get
+  io.fadd_out.res := fadd.io.res
+  io.fma_out.valid := fma.io.valid_out
+  io.fma_out.robIdx := fma.io.robIdx_out.get
+  io.fma_out.res := fma.io.res_out
+  io.fadd_delay := faddDelay.U
+  io.fma_delay := fmaDelay.U
+  io.delay_bias := delayBias.U
+}
+
+object topFlush extends App {
+  println("Generating the top flush (FAdd + FMA) hardware")
+  (new ChiselStage).emitVerilog(new topFlush, args)
+}
@@ -19,10 +19,12 @@ class topFMA extends Module{
     val a_in_16 = Input(Vec(2, UInt(16.W)))
     val b_in_16 = Input(Vec(2, UInt(16.W)))
     val c_in_16 = Input(Vec(2, UInt(16.W)))
+    val acc_fwd = Input(Bool())   // c = previous result (accumulation chain), c_in ignored
 
     val res_out_32 = Output(UInt(32.W))
     val res_out_16 = Output(Vec(2, UInt(16.W)))
     val valid_out = Output(Bool())
+    val acc_ready = Output(Bool()) // an acc_fwd op may issue this cycle
   })
 
   val fma = Module(new VFMA_16_32)
@@ -31,6 +33,7 @@ class topFMA extends Module{
   fma.io.is_fp16 := io.is_fp16
   fma.io.is_fp32 := io.is_fp32
   fma.io.is_widen := io.is_widen
+  fma.io.acc_fwd := io.acc_fwd
 
   when(io.is_fp32) {
     fma.io.a_in := io.a_in_32
@@ -45,6 +48,7 @@ class topFMA extends Module{
   io.res_out_32 := fma.io.res_out
   io.res_out_16 := VecInit(fma.io.res_out(15, 0), fma.io.res_out(31, 16))
   io.valid_out := fma.io.valid_out
+  io.acc_ready := fma.io.acc_ready
 }
 
 object topFMA extends App {
@@ -0,0 +1,41 @@
+package top
+
+import chisel3._
+import chisel3.util._
+import chisel3.stage._
+import race.vpu._
+import race.vpu.VParams._
+import race.vpu.exu.laneexu.fp._
+
+class topFRed extends Module{
+  val io = IO(new Bundle {
+    val valid_in = Input(Bool())
+    val is_bf16, is_fp16, is_fp32 = Input(Bool())
+    val is_widen, is_ordered = Input(Bool())
+    val vs2 = Input(UInt(VLEN.W))
+    val vs1 = Input(UInt(32.W))
+
+    val ready = Output(Bool())
+    val res_out = Output(UInt(32.W))
+    val valid_out = Output(Bool())
+  })
+
+  val fred = Module(new VFRed)
+  fred.io.valid_in := io.valid_in
+  fred.io.is_bf16 := io.is_bf16
+  fred.io.is_fp16 := io.is_fp16
+  fred.io.is_fp32 := io.is_fp32
+  fred.io.is_widen := io.is_widen
+  fred.io.is_ordered := io.is_ordered
+  fred.io.vs2 := io.vs2
+  fred.io.vs1 := io.vs1
+
+  io.ready := fred.io.ready
+  io.res_out := fred.io.res
+  io.valid_out := fred.io.valid_out
+}
+
+object topFRed extends App {
+  println("Generating the top FRed hardware")
+  (new ChiselStage).emitVerilog(new topFRed, args)
+}
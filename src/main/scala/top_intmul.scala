@@ -0,0 +1,34 @@
+package top
+
+import chisel3._
+import chisel3.util._
+import chisel3.stage._
+import race.vpu._
+import race.vpu.VParams._
+import race.vpu.exu.laneexu.fp._
+
+class topIntMul extends Module{
+  val io = IO(new Bundle {
+    val valid_in = Input(Bool())
+    val is_16 = Input(Bool())
+    val a_in = Input(UInt(24.W))
+    val b_in = Input(UInt(24.W))
+
+    val res_out = Output(UInt(48.W))
+    val valid_out = Output(Bool())
+  })
+
+  val mul = Module(new IntMUL_12_24)
+  mul.io.valid_in := io.valid_in
+  mul.io.is_16 := io.is_16
+  mul.io.a_in := io.a_in
+  mul.io.b_in := io.b_in
+
+  io.res_out := mul.io.res_out
+  io.valid_out := mul.io.valid_out
+}
+
+object topIntMul extends App {
+  println("Generating the top IntMul hardware")
+  (new ChiselStage).emitVerilog(new topIntMul, args)
+}
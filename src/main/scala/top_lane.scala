@@ -0,0 +1,68 @@
+package top
+
+import chisel3._
+import chisel3.util._
+import chisel3.stage._
+import race.vpu._
+import race.vpu.VParams._
+import race.vpu.exu.laneexu.fp._
+
+/**
+  * One 64-bit lane of VFAddWrapper (vfadd/vfsub/vfrsub, widen, narrow, vfmin/vfmax, vfsgnj*, vmf*, vfmv)
+  * with the uop flattened to the fields the wrapper decodes. The other uop fields are 0.
+  *   vsew: 1 fp16, 2 fp32, 3 fp64, 5 bf16 (SewFpOH)
+  *   vd of a compare: mask bits in the LSBs, 1 (fp64), 2 (fp32) or 4 (fp16/bf16)
+  */
+class topLane extends Module {
+  val io = IO(new Bundle {
+    val valid_in = Input(Bool())
+    val funct6 = Input(UInt(6.W))
+    val funct3 = Input(UInt(3.W))  // OPFVV 1, OPFVF 5 (rs1 operand)
+    val vm = Input(Bool())
+    val widen, widen2, narrow = Input(Bool())
+    val uop_idx = Input(UInt(3.W))
+    val vsew = Input(UInt(3.W))
+    val vs1, vs2, vs3 = Input(UInt(LaneWidth.W))
+    val rs1 = Input(UInt(xLen.W))
+
+    val vd = Output(UInt(LaneWidth.W))
+    val fflags_out = Output(Vec(LaneWidth/16, UInt(5.W)))
+    val funct6_out = Output(UInt(6.W))
+    val valid_out = Output(Bool())
+    val fast_ready = Output(Bool())  // VFAddWrapper.io.fastReady: a fast op issued now is not dropped
+    // VParams constants for the harness latency check
+    val fadd_delay, fcmp_delay, delay_bias = Output(UInt(8.W))
+  })
+
+  val lane = Module(new VFAddWrapper)
+  val uop = WireInit(0.U.asTypeOf(new VUop))
+  uop.ctrl.funct6 := io.funct6
+  uop.ctrl.funct3 := io.funct3
+  uop.ctrl.vm := io.vm
+  uop.ctrl.widen := io.widen
+  uop.ctrl.widen2 := io.widen2
+  uop.ctrl.narrow := io.narrow
+  uop.uopIdx := io.uop_idx
+
+  lane.io.in.valid := io.valid_in
+  lane.io.in.bits.uop := uop
+  lane.io.in.bits.vs1 := io.vs1
+  lane.io.in.bits.vs2 := io.vs2
+  lane.io.in.bits.vs3 := io.vs3
+  lane.io.in.bits.rs1 := io.rs1
+  lane.io.sewIn := SewFpOH(io.vsew)
+
+  io.vd := lane.io.out.bits.vd
+  io.fflags_out := lane.io.out.bits.fflags
+  io.funct6_out := lane.io.out.bits.uop.ctrl.funct6
+  io.valid_out := lane.io.out.valid
+  io.fast_ready := lane.io.fastReady
+  io.fadd_delay := faddDelay.U
+  io.fcmp_delay := fcmpDelay.U
+  io.delay_bias := delayBias.U
+}
+
+object topLane extends App {
+  println("Generating the top VFAddWrapper lane hardware")
+  (new ChiselStage).emitVerilog(new topLane, args)
+}
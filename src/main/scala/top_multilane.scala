@@ -0,0 +1,60 @@
+package top
+
+import chisel3._
+import chisel3.util._
+import chisel3.stage._
+import race.vpu._
+import race.vpu.VParams._
+import race.vpu.exu.laneexu.fp._
+
+/**
+  * VLEN-wide FAdd: VLEN/32 FAdd_16_32 lanes driven as one vector register per cycle.
+  * Element i of a_in/b_in/res_out sits at bits [i*sew+sew-1, i*sew] as in the VRF.
+  *   fp32:          VLEN/32 elements in, VLEN/32 out
+  *   fp16/bf16:     VLEN/16 elements in, VLEN/16 out
+  *   widen:         16-bit elements 0 until VLEN/32 (low half of a_in/b_in) -> VLEN/32 fp32 results
+  *   widen + a_already_widen: a_in holds VLEN/32 fp32 elements
+  */
+class topMultiLane extends Module {
+  val NFAdd = VLEN / 32
+
+  val io = IO(new Bundle {
+    val valid_in = Input(Bool())
+    val is_bf16, is_fp16, is_fp32 = Input(Bool())
+    val is_widen, a_already_widen = Input(Bool())
+    val a_in = Input(UInt(VLEN.W))
+    val b_in = Input(UInt(VLEN.W))
+
+    val res_out = Output(UInt(VLEN.W))
+    val fflags_out = Output(UInt(5.W)) // NV DZ OF UF NX accrued over all elements of the vector
+    val valid_out = Output(Bool())
+  })
+
+  val fadd = Seq.fill(NFAdd)(Module(new FAdd_16_32(3, 3)))
+
+  val (a_32b, b_32b) = (UIntSplit(io.a_in, 32), UIntSplit(io.b_in, 32))
+  val (a_16b, b_16b) = (UIntSplit(io.a_in, 16), UIntSplit(io.b_in, 16))
+
+  for (i <- 0 until NFAdd) {
+    fadd(i).io.valid_in := io.valid_in
+    fadd(i).io.is_bf16 := io.is_bf16
+    fadd(i).io.is_fp16 := io.is_fp16
+    fadd(i).io.is_fp32 := io.is_fp32
+    fadd(i).io.is_widen := io.is_widen
+    fadd(i).io.is_narrow := false.B
+    fadd(i).io.a_already_widen := io.a_already_widen
+
+    // Widen: the 16-bit operand goes to the high half of the FAdd input (same as `top`)
+    fadd(i).io.a := Mux(io.is_widen && !io.a_already_widen, Cat(a_16b(i), 0.U(16.W)), a_32b(i))
+    fadd(i).io.b := Mux(io.is_widen, Cat(b_16b(i), 0.U(16.W)), b_32b(i))
+  }
+
+  io.res_out := Cat(fadd.map(_.io.res).reverse)
+  io.fflags_out := fadd.flatMap(_.io.fflags).reduce(_ | _)
+  io.valid_out := fadd(0).io.valid_out
+}
+
+object topMultiLane extends App {
+  println("Generating the VLEN-wide multi-lane FAdd hardware")
+  (new ChiselStage).emitVerilog(new topMultiLane, args)
+}
@@ -0,0 +1,48 @@
+package top
+
+import chisel3._
+import chisel3.util._
+import chisel3.stage._
+import race.vpu._
+import race.vpu.VParams._
+import race.vpu.exu.laneexu.fp._
+
+// FAdd_16_32 with stochastic rounding, fp16/bf16 only (two elements per cycle).
+// Default ExtendedWidths: the discarded part keeps >= 14 bits in both halves, so
+// P(round up) is resolved well below the statistical error of the harness.
+class topSR extends Module{
+  val io = IO(new Bundle {
+    val valid_in = Input(Bool())
+    val is_bf16, is_fp16 = Input(Bool())
+    val rm_sr = Input(Bool()) // 0: RNE
+    val sr_seed_valid = Input(Bool())
+    val sr_seed = Input(UInt(32.W))
+    val a_in_16 = Input(Vec(2, UInt(16.W)))
+    val b_in_16 = Input(Vec(2, UInt(16.W)))
+
+    val res_out_16 = Output(Vec(2, UInt(16.W)))
+    val valid_out = Output(Bool())
+  })
+
+  val fadd = Module(new FAdd_16_32(NStages = faddStages, StochasticRounding = true))
+  fadd.io.valid_in := io.valid_in
+  fadd.io.is_bf16 := io.is_bf16
+  fadd.io.is_fp16 := io.is_fp16
+  fadd.io.is_fp32 := false.B
+  fadd.io.is_widen := false.B
+  fadd.io.is_narrow := false.B
+  fadd.io.a_already_widen := false.B
+  fadd.io.rm_sr.get := io.rm_sr
+  fadd.io.sr_seed_valid.get := io.sr_seed_valid
+  fadd.io.sr_seed.get := io.sr_seed
+  fadd.io.a := Cat(io.a_in_16(1), io.a_in_16(0))
+  fadd.io.b := Cat(io.b_in_16(1), io.b_in_16(0))
+
+  io.res_out_16 := VecInit(fadd.io.res(15, 0), fadd.io.res(31, 16))
+  io.valid_out := fadd.io.valid_out
+}
+
+object topSR extends App {
+  println("Generating the stochastic-rounding FAdd hardware")
+  (new ChiselStage).emitVerilog(new topSR, args)
+}
@@ -0,0 +1,56 @@
+package top
+
+import chisel3._
+import chisel3.util._
+import chisel3.stage._
+import race.vpu._
+import race.vpu.VParams._
+import race.vpu.exu.laneexu.fp._
+
+// FAdd_16_32 with the TwoSum error output, fp32 / fp16 / bf16 (no widen or narrow).
+// Default ExtendedWidths, which TwoSum requires (>= SigWidth + 1).
+class topTwoSum extends Module{
+  val io = IO(new Bundle {
+    val valid_in = Input(Bool())
+    val is_bf16, is_fp16, is_fp32 = Input(Bool())
+    val a_in_32 = Input(UInt(32.W))
+    val b_in_32 = Input(UInt(32.W))
+    val a_in_16 = Input(Vec(2, UInt(16.W)))
+    val b_in_16 = Input(Vec(2, UInt(16.W)))
+
+    val res_out_32 = Output(UInt(32.W))
+    val res_out_16 = Output(Vec(2, UInt(16.W)))
+    val err_out_32 = Output(UInt(32.W)) // res + err == a + b
+    val err_out_16 = Output(Vec(2, UInt(16.W)))
+    val valid_out = Output(Bool())
+  })
+
+  val fadd = Module(new FAdd_16_32(NStages = faddStages, TwoSum = true))
+  fadd.io.valid_in := io.valid_in
+  fadd.io.is_bf16 := io.is_bf16
+  fadd.io.is_fp16 := io.is_fp16
+  fadd.io.is_fp32 := io.is_fp32
+  fadd.io.is_widen := false.B
+  fadd.io.is_narrow := false.B
+  fadd.io.a_already_widen := false.B
+
+  when(io.is_fp32) {
+    fadd.io.a := io.a_in_32
+    fadd.io.b := io.b_in_32
+  }.otherwise {
+    fadd.io.a := Cat(io.a_in_16(1), io.a_in_16(0))
+    fadd.io.b := Cat(io.b_in_16(1), io.b_in_16(0))
+  }
+
+  val err = fadd.io.err.get
+  io.res_out_32 := fadd.io.res
+  io.res_out_16 := VecInit(fadd.io.res(15, 0), fadd.io.res(31, 16))
+  io.err_out_32 := err
+  io.err_out_16 := VecInit(err(15, 0), err(31, 16))
+  io.valid_out := fadd.io.valid_out
+}
+
+object topTwoSum extends App {
+  println("Generating the TwoSum FAdd hardware")
+  (new ChiselStage).emitVerilog(new topTwoSum, args)
+}
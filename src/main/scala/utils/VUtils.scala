@@ -27,6 +27,14 @@ object UIntSplit {
   }
 }
 
+// Side data of an n-stage valid pipeline: stage k is RegEnable(x, valid of stage k-1),
+// as the _S1/_S2 registers in FAdd_16_32 and VFMA_16_32
+object ValidPipe {
+  def apply[T <: Data](x: T, valid: Bool, n: Int): T = {
+    (0 until n).foldLeft((x, valid)) { case ((d, v), _) => (RegEnable(d, v), RegNext(v, false.B)) }._1
+  }
+}
+
 object BitsExtend {
   def apply(data: UInt, extLen: Int, signed: Bool): UInt = {
     val width = data.getWidth
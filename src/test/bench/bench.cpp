@@ -0,0 +1,305 @@
+// Microbenchmarks for fp_utils.h and softfloat_ref.h
+//   Reports ns/op and GB/s per function and input distribution, writes a CSV
+//   and compares against a stored baseline CSV (if given).
+//
+// Usage: bench [--out results.csv] [--baseline baseline.csv] [--min-ms N] [--threshold PCT]
+#include "fp_utils.h"
+#include "softfloat_ref.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+static const size_t kN = 4096; // working set stays in L1/L2
+static volatile uint32_t g_sink;
+
+struct BenchResult {
+    std::string name;
+    std::string dist;
+    double ns_per_op;
+    double gbps;
+};
+
+// Input distributions (bit patterns)
+enum class Dist { Normal, Subnormal, Special };
+static const char* dist_name(Dist d) {
+    switch (d) {
+        case Dist::Normal: return "normal";
+        case Dist::Subnormal: return "subnormal";
+        case Dist::Special: return "special";
+    }
+    return "?";
+}
+
+static uint32_t rand32() { return ((uint32_t)rand() << 16) ^ (uint32_t)rand(); }
+
+static std::vector<uint16_t> make_fp16(Dist d) {
+    std::vector<uint16_t> v(kN);
+    static const uint16_t specials[] = {0x0000, 0x8000, 0x7c00, 0xfc00, 0x7e00, 0x7bff, 0x0400, 0x03ff};
+    for (size_t i = 0; i < kN; ++i) {
+        switch (d) {
+            case Dist::Normal: v[i] = gen_random_fp16(-14, 15); break;
+            case Dist::Subnormal: v[i] = (uint16_t)((rand32() & 0x8000) | (1 + rand32() % 0x3ff)); break;
+            case Dist::Special: v[i] = specials[rand32() % 8]; break;
+        }
+    }
+    return v;
+}
+
+static std::vector<uint16_t> make_bf16(Dist d) {
+    std::vector<uint16_t> v(kN);
+    static const uint16_t specials[] = {0x0000, 0x8000, 0x7f80, 0xff80, 0x7fc0, 0x7f7f, 0x0080, 0x007f};
+    for (size_t i = 0; i < kN; ++i) {
+        switch (d) {
+            case Dist::Normal: v[i] = gen_random_bf16(-126, 127); break;
+            case Dist::Subnormal: v[i] = (uint16_t)((rand32() & 0x8000) | (1 + rand32() % 0x7f)); break;
+            case Dist::Special: v[i] = specials[rand32() % 8]; break;
+        }
+    }
+    return v;
+}
+
+static std::vector<uint32_t> make_fp32(Dist d) {
+    std::vector<uint32_t> v(kN);
+    static const uint32_t specials[] = {0x00000000, 0x80000000, 0x7f800000, 0xff800000,
+                                        0x7fc00000, 0x7f7fffff, 0x00800000, 0x007fffff};
+    for (size_t i = 0; i < kN; ++i) {
+        switch (d) {
+            case Dist::Normal: v[i] = gen_random_fp32(-126, 127); break;
+            case Dist::Subnormal: v[i] = (rand32() & 0x80000000u) | (1 + rand32() % 0x7fffff); break;
+            case Dist::Special: v[i] = specials[rand32() % 8]; break;
+        }
+    }
+    return v;
+}
+
+// FP32 inputs for fp32 -> 16-bit conversions: values inside the target range
+static std::vector<float> make_fp32_for16(Dist d, bool to_fp16) {
+    // Specials are the fp32 ones, drawn once for the whole vector
+    std::vector<uint32_t> bits = d == Dist::Special ? make_fp32(Dist::Special) : std::vector<uint32_t>(kN);
+    for (size_t i = 0; i < kN; ++i) {
+        switch (d) {
+            case Dist::Normal: bits[i] = to_fp16 ? gen_random_fp32(-14, 15) : gen_random_fp32(-126, 127); break;
+            case Dist::Subnormal: bits[i] = to_fp16 ? gen_random_fp32(-24, -15)
+                                                    : (rand32() & 0x80000000u) | (1 + rand32() % 0x7fffff); break;
+            case Dist::Special: break;
+        }
+    }
+    std::vector<float> v(kN);
+    memcpy(v.data(), bits.data(), kN * sizeof(float));
+    return v;
+}
+
+// Calls body() until min_ms elapsed; each call processes ops_per_call elements
+template <typename F>
+static double time_ns_per_op(F body, size_t ops_per_call, double min_ms) {
+    using clock = std::chrono::steady_clock;
+    body(); // warm up
+    uint64_t ops = 0;
+    auto t0 = clock::now();
+    double elapsed_ms = 0;
+    do {
+        body();
+        ops += ops_per_call;
+        elapsed_ms = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+    } while (elapsed_ms < min_ms);
+    return elapsed_ms * 1e6 / (double)ops;
+}
+
+static std::vector<BenchResult> g_results;
+
+static void record(const char* name, const char* dist, size_t bytes_per_op, double ns) {
+    g_results.push_back({name, dist, ns, (double)bytes_per_op / ns});
+    printf("%-26s %-10s %10.3f ns/op %10.3f GB/s\n", name, dist, ns, (double)bytes_per_op / ns);
+}
+
+// Scalar functions: body(i) handles element i of the kN-element inputs
+template <typename F>
+static void run(const char* name, const char* dist, size_t bytes_per_op, double min_ms, F body) {
+    double ns = time_ns_per_op([&]() {
+        for (size_t i = 0; i < kN; ++i) body(i);
+    }, kN, min_ms);
+    record(name, dist, bytes_per_op, ns);
+}
+
+// Batch kernels: one body() call converts all kN elements
+template <typename F>
+static void run_batch(const char* name, const char* dist, size_t bytes_per_op, double min_ms, F body) {
+    record(name, dist, bytes_per_op, time_ns_per_op(body, kN, min_ms));
+}
+
+static void bench_all(double min_ms) {
+    const Dist dists[] = {Dist::Normal, Dist::Subnormal, Dist::Special};
+    uint32_t acc = 0;
+
+    // ---- Conversions ----
+    for (Dist d : dists) {
+        auto h = make_fp16(d);
+        run("fp16_to_fp32", dist_name(d), 2 + 4, min_ms, [&](size_t i) {
+            float f = fp16_to_fp32(h[i]);
+            uint32_t u;
+            memcpy(&u, &f, 4);
+            acc += u;
+        });
+    }
+    for (Dist d : dists) {
+        auto f = make_fp32_for16(d, true);
+        run("fp32_to_fp16", dist_name(d), 4 + 2, min_ms, [&](size_t i) { acc += fp32_to_fp16(f[i]); });
+    }
+    for (Dist d : dists) {
+        auto h = make_bf16(d);
+        run("bf16_to_fp32", dist_name(d), 2 + 4, min_ms, [&](size_t i) {
+            float f = bf16_to_fp32(h[i]);
+            uint32_t u;
+            memcpy(&u, &f, 4);
+            acc += u;
+        });
+    }
+    for (Dist d : dists) {
+        auto f = make_fp32_for16(d, false);
+        run("fp32_to_bf16", dist_name(d), 4 + 2, min_ms, [&](size_t i) { acc += fp32_to_bf16(f[i]); });
+    }
+
+    // ---- Batch conversions (whole buffer per call, reported per element) ----
+    std::vector<float> fbuf(kN);
+    std::vector<uint16_t> hbuf(kN);
+    for (Dist d : dists) {
+        auto h = make_fp16(d);
+        run_batch("fp16_to_fp32_batch", dist_name(d), 2 + 4, min_ms, [&]() {
+            fp16_to_fp32_batch(h.data(), fbuf.data(), kN);
+            acc += (uint32_t)fbuf[kN - 1];
+        });
+    }
+    for (Dist d : dists) {
+        auto f = make_fp32_for16(d, true);
+        run_batch("fp32_to_fp16_batch", dist_name(d), 4 + 2, min_ms, [&]() {
+            fp32_to_fp16_batch(f.data(), hbuf.data(), kN);
+            acc += hbuf[kN - 1];
+        });
+    }
+    for (Dist d : dists) {
+        auto h = make_bf16(d);
+        run_batch("bf16_to_fp32_batch", dist_name(d), 2 + 4, min_ms, [&]() {
+            bf16_to_fp32_batch(h.data(), fbuf.data(), kN);
+            acc += (uint32_t)fbuf[kN - 1];
+        });
+    }
+    for (Dist d : dists) {
+        auto f = make_fp32_for16(d, false);
+        run_batch("fp32_to_bf16_batch", dist_name(d), 4 + 2, min_ms, [&]() {
+            fp32_to_bf16_batch(f.data(), hbuf.data(), kN);
+            acc += hbuf[kN - 1];
+        });
+    }
+
+    // ---- Generators (distribution = exponent window) ----
+    run("gen_random_fp32", "normal", 4, min_ms, [&](size_t) { acc += gen_random_fp32(-126, 127); });
+    run("gen_random_fp32", "subnormal", 4, min_ms, [&](size_t) { acc += gen_random_fp32(-127, -126); });
+    run("gen_random_fp16", "normal", 2, min_ms, [&](size_t) { acc += gen_random_fp16(-14, 15); });
+    run("gen_random_fp16", "subnormal", 2, min_ms, [&](size_t) { acc += gen_random_fp16(-15, -14); });
+    run("gen_random_bf16", "normal", 2, min_ms, [&](size_t) { acc += gen_random_bf16(-126, 127); });
+    run("gen_random_bf16", "subnormal", 2, min_ms, [&](size_t) { acc += gen_random_bf16(-127, -126); });
+    run("gen_any_fp32", "any", 4, min_ms, [&](size_t) { acc += gen_any_fp32(); });
+    run("gen_any_fp16", "any", 2, min_ms, [&](size_t) { acc += gen_any_fp16(); });
+    run("gen_any_bf16", "any", 2, min_ms, [&](size_t) { acc += gen_any_bf16(); });
+
+    // ---- SoftFloat reference ----
+    for (Dist d : dists) {
+        auto a = make_fp32(d), b = make_fp32(d);
+        run("softfloat_add_fp32", dist_name(d), 4 * 3, min_ms, [&](size_t i) { acc += softfloat_add_fp32(a[i], b[i]); });
+    }
+    for (Dist d : dists) {
+        auto a = make_fp16(d), b = make_fp16(d);
+        run("softfloat_add_fp16", dist_name(d), 2 * 3, min_ms, [&](size_t i) { acc += softfloat_add_fp16(a[i], b[i]); });
+    }
+    for (Dist d : dists) {
+        auto a = make_bf16(d), b = make_bf16(d);
+        run("softfloat_add_bf16", dist_name(d), 2 * 3, min_ms, [&](size_t i) { acc += softfloat_add_bf16(a[i], b[i]); });
+    }
+
+    g_sink = acc;
+}
+
+static bool write_csv(const char* path) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        printf("Cannot write %s\n", path);
+        return false;
+    }
+    fprintf(fp, "name,dist,ns_per_op,gbps\n");
+    for (const auto& r : g_results) {
+        fprintf(fp, "%s,%s,%.4f,%.4f\n", r.name.c_str(), r.dist.c_str(), r.ns_per_op, r.gbps);
+    }
+    fclose(fp);
+    return true;
+}
+
+// Returns number of regressions beyond threshold_pct
+static int compare_baseline(const char* path, double threshold_pct) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        printf("\nNo baseline at %s (run 'make bench_baseline' to store one)\n", path);
+        return 0;
+    }
+    std::map<std::string, double> base;
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        char name[96], dist[32];
+        double ns, gbps;
+        if (sscanf(line, "%95[^,],%31[^,],%lf,%lf", name, dist, &ns, &gbps) == 4) {
+            base[std::string(name) + "/" + dist] = ns;
+        }
+    }
+    fclose(fp);
+
+    int regressions = 0;
+    printf("\n---- Compared with baseline %s (threshold %.1f%%) ----\n", path, threshold_pct);
+    for (const auto& r : g_results) {
+        auto it = base.find(r.name + "/" + r.dist);
+        if (it == base.end()) {
+            printf("%-26s %-10s %10.3f ns/op   (new)\n", r.name.c_str(), r.dist.c_str(), r.ns_per_op);
+            continue;
+        }
+        double delta = 100.0 * (r.ns_per_op - it->second) / it->second;
+        const char* tag = delta > threshold_pct ? "REGRESSION" : (delta < -threshold_pct ? "speedup" : "");
+        if (delta > threshold_pct) regressions++;
+        printf("%-26s %-10s %10.3f -> %10.3f ns/op %+8.1f%% %s\n", r.name.c_str(), r.dist.c_str(),
+               it->second, r.ns_per_op, delta, tag);
+    }
+    printf("%d regression(s)\n", regressions);
+    return regressions;
+}
+
+int main(int argc, char* argv[]) {
+    const char* out = "bench.csv";
+    const char* baseline = nullptr;
+    double min_ms = 50.0;
+    double threshold = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--out") && i + 1 < argc) out = argv[++i];
+        else if (!strcmp(argv[i], "--baseline") && i + 1 < argc) baseline = argv[++i];
+        else if (!strcmp(argv[i], "--min-ms") && i + 1 < argc) min_ms = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--threshold") && i + 1 < argc) threshold = atof(argv[++i]);
+        else {
+            printf("Usage: %s [--out file.csv] [--baseline file.csv] [--min-ms N] [--threshold PCT]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    srand(1);
+    printf("FP16 batch conversion backend: %s\n", fp_conv_backend());
+    printf("%-26s %-10s %16s %15s\n", "function", "dist", "time", "throughput");
+    bench_all(min_ms);
+    if (!write_csv(out)) {
+        return 1;
+    }
+    printf("\nResults written to %s\n", out);
+    if (baseline) {
+        compare_baseline(baseline, threshold);
+    }
+    return 0;
+}
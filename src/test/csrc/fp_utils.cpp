@@ -4,194 +4,240 @@
 #include <cstring>
 #include <ctime>
 
-// FP16（半精度浮点数）格式：1位符号，5位指数，10位尾数
-// 将FP16转换为FP32（float）
-float fp16_to_fp32(fp16_t h) {
-    uint32_t sign = (h >> 15) & 0x01;
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+// ===================================================================
+//  Scalar conversions (bit-exact IEEE 754, round-to-nearest-even)
+//  NaN handling matches x86 F16C: NaNs are quieted and the payload is
+//  truncated/extended, so the scalar, table and SIMD paths agree bit for bit.
+// ===================================================================
+
+// FP16 -> FP32 bit conversion, used to fill the lookup table
+static uint32_t fp16_bits_to_fp32_bits(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
     uint32_t exp = (h >> 10) & 0x1f;
     uint32_t mant = h & 0x3ff;
-    
-    uint32_t f;
-    
-    if (exp == 0) {
-        // 非规格化数或零
-        if (mant == 0) {
-            // 零
-            f = sign << 31;
-        } else {
-            // 非规格化数：指数为1-15，尾数隐含0
-            while (!(mant & 0x400)) {
-                mant <<= 1;
-                exp--;
-            }
-            exp++;
-            mant &= 0x3ff;
-            exp = 127 - 15 + exp;
-            mant <<= 13;
-            f = (sign << 31) | (exp << 23) | mant;
-        }
-    } else if (exp == 0x1f) {
-        // 无穷大或NaN
-        if (mant == 0) {
-            // 无穷大
-            f = (sign << 31) | (0xff << 23);
-        } else {
-            // NaN
-            f = (sign << 31) | (0xff << 23) | (mant << 13);
-        }
-    } else {
+
+    if (exp == 0x1f) {
+        // 无穷大或NaN (NaN置quiet位)
+        return sign | 0x7f800000 | (mant << 13) | (mant ? 0x00400000 : 0);
+    }
+    if (exp != 0) {
         // 规格化数
-        exp = 127 - 15 + exp;
-        mant <<= 13;
-        f = (sign << 31) | (exp << 23) | mant;
+        return sign | ((exp + 112) << 23) | (mant << 13);
     }
-    
-    float result;
-    memcpy(&result, &f, sizeof(result));
-    return result;
+    if (mant == 0) {
+        return sign;
+    }
+    // 非规格化数：按前导零个数一次归一化
+    int shift = __builtin_clz(mant) - 21; // mant的最高位移到bit 10
+    mant = (mant << shift) & 0x3ff;
+    return sign | ((uint32_t)(113 - shift) << 23) | (mant << 13);
 }
 
+// FP32 -> FP16 bit conversion with RNE, FP16 subnormals and overflow to Inf
+static inline uint16_t fp32_bits_to_fp16_bits(uint32_t x) {
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t abs = x & 0x7fffffff;
 
-// 将FP32（float）转换为FP16
-uint16_t fp32_to_fp16(float fp32) {
-    // 将float转换为位表示
-    uint32_t fp32_bits;
-    memcpy(&fp32_bits, &fp32, sizeof(fp32_bits));
-    
-    // 提取FP32的各个字段
-    uint32_t sign = (fp32_bits >> 31) & 0x1;        // 符号位
-    uint32_t exp = (fp32_bits >> 23) & 0xFF;        // 8位指数
-    uint32_t frac = fp32_bits & 0x7FFFFF;           // 23位尾数
-    
-    uint16_t fp16_bits;
-    
-    if (exp == 0) {
-        // 处理零和非规格化数
-        if (frac == 0) {
-            // 零值
-            fp16_bits = (sign << 15);
-        } else {
-            // FP32的非规格化数转换为FP16的零（通常太小了）
-            fp16_bits = (sign << 15);
-        }
-    } else if (exp == 255) {
-        // 处理无穷大和NaN
-        if (frac == 0) {
-            // 无穷大
-            fp16_bits = (sign << 15) | 0x7C00;  // 指数全1，尾数为0
-        } else {
-            // NaN：保持符号位，指数全1，尾数非零
-            uint16_t fp16_frac = (frac >> (23 - 10)) & 0x3FF;
-            if (fp16_frac == 0) fp16_frac = 1;  // 确保NaN的尾数非零
-            fp16_bits = (sign << 15) | 0x7C00 | fp16_frac;
-        }
-    } else {
-        // 正常数转换
-        // 指数转换：FP32指数 - FP32偏置(127) + FP16偏置(15) = exp - 112
-        int32_t fp16_exp = (int32_t)exp - 112;
-        
-        // 检查指数是否溢出或下溢
-        if (fp16_exp >= 31) {
-            // 上溢：转换为无穷大
-            fp16_bits = (sign << 15) | 0x7C00;
-        } else if (fp16_exp <= 0) {
-            // 下溢：尝试转换为非规格化数
-            if (fp16_exp < -10) {
-                // 太小，转换为零
-                fp16_bits = (sign << 15);
-            } else {
-                // 转换为非规格化数
-                // 需要将隐含的1位加入尾数，然后右移
-                uint32_t full_frac = 0x800000 | frac;  // 加入隐含的1位
-                int shift = 1 - fp16_exp;               // 需要右移的位数
-                
-                // 执行右移，包含舍入
-                uint32_t shifted_frac = full_frac >> (shift + (23 - 10));
-                
-                // 简单的舍入到最近偶数
-                if (full_frac & (1 << (shift + (23 - 10) - 1))) {
-                    shifted_frac++;
-                }
-                
-                // 检查舍入后是否溢出
-                if (shifted_frac > 0x3FF) {
-                    // 舍入导致溢出，变成最小的规格化数
-                    fp16_bits = (sign << 15) | (1 << 10);
-                } else {
-                    fp16_bits = (sign << 15) | (shifted_frac & 0x3FF);
-                }
-            }
-        } else {
-            // 正常的规格化数转换
-            // 尾数转换：从23位缩减到10位，包含舍入
-            uint32_t fp16_frac = frac >> (23 - 10);  // 截取高10位
-            
-            // 简单的舍入到最近偶数
-            if (frac & (1 << (23 - 10 - 1))) {  // 检查被截掉的最高位
-                fp16_frac++;
-                
-                // 检查舍入后是否溢出
-                if (fp16_frac > 0x3FF) {
-                    fp16_frac = 0;
-                    fp16_exp++;
-                    
-                    // 检查指数是否因舍入而溢出
-                    if (fp16_exp >= 31) {
-                        fp16_bits = (sign << 15) | 0x7C00;  // 无穷大
-                    } else {
-                        fp16_bits = (sign << 15) | (fp16_exp << 10) | fp16_frac;
-                    }
-                } else {
-                    fp16_bits = (sign << 15) | (fp16_exp << 10) | fp16_frac;
-                }
-            } else {
-                fp16_bits = (sign << 15) | (fp16_exp << 10) | fp16_frac;
+    if (abs > 0x7f800000) {
+        // NaN: quiet, keep the upper 9 payload bits
+        return (uint16_t)(sign | 0x7e00 | ((abs >> 13) & 0x3ff));
+    }
+    if (abs >= 0x47800000) {
+        // >= 2^16 (including Inf): overflow to Inf
+        return (uint16_t)(sign | 0x7c00);
+    }
+    if (abs >= 0x38800000) {
+        // FP16规格化范围 [2^-14, 2^16)：重新偏置指数后对低13位做RNE
+        // 舍入进位会自然进入指数域 (最大值进位得到Inf)
+        uint32_t h = abs - (112u << 23);
+        uint32_t rem = h & 0x1fff;
+        h >>= 13;
+        h += (rem > 0x1000) || (rem == 0x1000 && (h & 1));
+        return (uint16_t)(sign | h);
+    }
+    if (abs <= 0x33000000) {
+        // <= 2^-25 (含FP32非规格化数)：RNE到零
+        return (uint16_t)sign;
+    }
+    // FP16非规格化范围 (2^-25, 2^-14)
+    uint32_t e = abs >> 23;                 // 102..112
+    uint32_t m = (abs & 0x7fffff) | 0x800000;
+    uint32_t shift = 126 - e;               // 14..24
+    uint32_t h = m >> shift;
+    uint32_t rem = m & ((1u << shift) - 1);
+    uint32_t half = 1u << (shift - 1);
+    h += (rem > half) || (rem == half && (h & 1));
+    return (uint16_t)(sign | h);
+}
+
+// FP32 -> BF16 bit conversion with RNE (NaN stays NaN)
+static inline uint16_t fp32_bits_to_bf16_bits(uint32_t x) {
+    if ((x & 0x7fffffff) > 0x7f800000) {
+        return (uint16_t)((x >> 16) | 0x0040);
+    }
+    return (uint16_t)((x + 0x7fff + ((x >> 16) & 1)) >> 16);
+}
+
+// 65536-entry FP16 -> FP32 table (256 KB), built on first use
+static const uint32_t* fp16_table() {
+    struct Table {
+        uint32_t v[65536];
+        Table() {
+            for (uint32_t i = 0; i < 65536; ++i) {
+                v[i] = fp16_bits_to_fp32_bits((uint16_t)i);
             }
         }
-    }
-    
-    return fp16_bits;
+    };
+    static const Table table;
+    return table.v;
+}
+
+float fp16_to_fp32(fp16_t h) {
+    float result;
+    memcpy(&result, &fp16_table()[h], sizeof(result));
+    return result;
 }
 
+uint16_t fp32_to_fp16(float fp32) {
+    uint32_t bits;
+    memcpy(&bits, &fp32, sizeof(bits));
+    return fp32_bits_to_fp16_bits(bits);
+}
 
-// 将BF16转换为FP32（float）
+// BF16到FP32：左移16位，尾数低位补0
 float bf16_to_fp32(bf16_t h) {
-    // BF16到FP32的转换非常简单：
-    // BF16格式: 1位符号 + 8位指数 + 7位尾数
-    // FP32格式: 1位符号 + 8位指数 + 23位尾数
-    // 只需要将BF16左移16位，在尾数低位补0即可
     uint32_t f = ((uint32_t)h) << 16;
     float result;
     memcpy(&result, &f, sizeof(result));
     return result;
 }
 
-// 将FP32（float）转换为BF16
 uint16_t fp32_to_bf16(float fp32) {
-    // 将float转换为位表示
-    uint32_t fp32_bits;
-    memcpy(&fp32_bits, &fp32, sizeof(fp32_bits));
-    
-    // FP32到BF16的转换：
-    // 1. 取FP32的高16位（已经是BF16格式）
-    // 2. 根据低16位进行RNE舍入
-    uint16_t high16 = (uint16_t)(fp32_bits >> 16);
-    uint16_t low16 = (uint16_t)(fp32_bits & 0xFFFF);
-    
-    // RNE舍入逻辑：需要检查guard, round, sticky位
-    uint32_t guard_bit = (low16 >> 15) & 1;        // 低16位的最高位
-    uint32_t round_bit = (low16 >> 14) & 1;        // 低16位的第二高位
-    uint32_t sticky_bit = (low16 & 0x3FFF) ? 1 : 0; // 低16位的其余14位
-    
-    // RNE舍入：当guard位为1时
-    if (guard_bit) {
-        // 如果round或sticky位有任何一个为1，或者结果为奇数，则向上舍入
-        if (round_bit || sticky_bit || (high16 & 1)) {
-            high16++;
+    uint32_t bits;
+    memcpy(&bits, &fp32, sizeof(bits));
+    return fp32_bits_to_bf16_bits(bits);
+}
+
+// ===================================================================
+//  Batch conversions
+//  x86: runtime dispatch to AVX-512F (16 lanes) or F16C (8 lanes) for
+//  FP16 <-> FP32; other paths are plain loops the compiler vectorizes.
+//  AVX512-BF16 (vcvtneps2bf16) is not used: it flushes subnormals.
+// ===================================================================
+
+static void fp16_to_fp32_batch_generic(const fp16_t* src, float* dst, size_t n) {
+    const uint32_t* table = fp16_table();
+    for (size_t i = 0; i < n; ++i) {
+        memcpy(&dst[i], &table[src[i]], sizeof(float));
+    }
+}
+
+static void fp32_to_fp16_batch_generic(const float* src, fp16_t* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t bits;
+        memcpy(&bits, &src[i], sizeof(bits));
+        dst[i] = fp32_bits_to_fp16_bits(bits);
+    }
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define FP_UTILS_X86_DISPATCH
+
+__attribute__((target("avx512f")))
+static void fp16_to_fp32_batch_avx512(const fp16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i h = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(h));
+    }
+    fp16_to_fp32_batch_generic(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static void fp32_to_fp16_batch_avx512(const float* src, fp16_t* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 f = _mm512_loadu_ps(src + i);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm512_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+    }
+    fp32_to_fp16_batch_generic(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx,f16c")))
+static void fp16_to_fp32_batch_f16c(const fp16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+    fp16_to_fp32_batch_generic(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx,f16c")))
+static void fp32_to_fp16_batch_f16c(const float* src, fp16_t* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 f = _mm256_loadu_ps(src + i);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+    }
+    fp32_to_fp16_batch_generic(src + i, dst + i, n - i);
+}
+#endif
+
+struct ConvKernels {
+    void (*h2f)(const fp16_t*, float*, size_t);
+    void (*f2h)(const float*, fp16_t*, size_t);
+    const char* name;
+};
+
+// Set FP_UTILS_NO_SIMD=1 to force the portable path (e.g. for benchmarking)
+static const ConvKernels& conv_kernels() {
+    static const ConvKernels kernels = []() -> ConvKernels {
+#ifdef FP_UTILS_X86_DISPATCH
+        if (!getenv("FP_UTILS_NO_SIMD")) {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                return {fp16_to_fp32_batch_avx512, fp32_to_fp16_batch_avx512, "avx512f"};
+            }
+            if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c")) {
+                return {fp16_to_fp32_batch_f16c, fp32_to_fp16_batch_f16c, "f16c"};
+            }
         }
+#endif
+        return {fp16_to_fp32_batch_generic, fp32_to_fp16_batch_generic, "generic"};
+    }();
+    return kernels;
+}
+
+const char* fp_conv_backend() {
+    return conv_kernels().name;
+}
+
+void fp16_to_fp32_batch(const fp16_t* src, float* dst, size_t n) {
+    conv_kernels().h2f(src, dst, n);
+}
+
+void fp32_to_fp16_batch(const float* src, fp16_t* dst, size_t n) {
+    conv_kernels().f2h(src, dst, n);
+}
+
+void bf16_to_fp32_batch(const bf16_t* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t f = ((uint32_t)src[i]) << 16;
+        memcpy(&dst[i], &f, sizeof(float));
+    }
+}
+
+void fp32_to_bf16_batch(const float* src, bf16_t* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t bits;
+        memcpy(&bits, &src[i], sizeof(bits));
+        dst[i] = fp32_bits_to_bf16_bits(bits);
     }
-    
-    return high16;
 }
 
 uint32_t gen_random_fp32(int exp_min, int exp_max) {
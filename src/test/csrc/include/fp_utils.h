@@ -1,6 +1,7 @@
 #ifndef __FP_UTILS_H__
 #define __FP_UTILS_H__
 
+#include <cstddef>
 #include <cstdint>
 
 // FP16 (half-precision) format: 1 sign, 5 exponent, 10 mantissa
@@ -14,6 +15,17 @@ uint16_t fp32_to_fp16(float fp32);
 float bf16_to_fp32(bf16_t h);
 uint16_t fp32_to_bf16(float fp32);
 
+// --- Batch conversions over [src, src + n) ---
+// Bit-exact with the scalar functions above (RNE, subnormals, quiet NaN).
+// FP16 <-> FP32 use AVX-512F / F16C when the CPU has them.
+void fp16_to_fp32_batch(const fp16_t* src, float* dst, size_t n);
+void fp32_to_fp16_batch(const float* src, fp16_t* dst, size_t n);
+void bf16_to_fp32_batch(const bf16_t* src, float* dst, size_t n);
+void fp32_to_bf16_batch(const float* src, bf16_t* dst, size_t n);
+
+// Name of the selected FP16 batch kernel: "avx512f", "f16c" or "generic"
+const char* fp_conv_backend();
+
 // --- Random floating-point generation functions ---
 
 // Generates a random FP32 number within a specified exponent range
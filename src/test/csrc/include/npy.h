@@ -0,0 +1,42 @@
+#ifndef __NPY_H__
+#define __NPY_H__
+
+#include <cstddef>
+#include <string>
+
+// ===================================================================
+// NpyFile: 只读mmap方式打开 .npy (v1/v2/v3) 或原始二进制张量
+// ===================================================================
+class NpyFile {
+public:
+    NpyFile() = default;
+    ~NpyFile();
+    NpyFile(const NpyFile&) = delete;
+    NpyFile& operator=(const NpyFile&) = delete;
+
+    // .npy files are parsed; anything else is mapped as raw data with
+    // raw_elem_size-byte elements. Returns false and sets error() on failure.
+    bool open(const char* path, size_t raw_elem_size);
+
+    const void* data() const { return data_; }
+    size_t count() const { return count_; }
+    size_t elem_size() const { return elem_size_; }
+    // numpy dtype string, e.g. "<f2", "<u2", "<f4" ("" for raw files)
+    const std::string& descr() const { return descr_; }
+    bool fortran_order() const { return fortran_order_; }
+    const std::string& error() const { return error_; }
+
+private:
+    bool parse_header(const char* path);
+
+    void* map_ = nullptr;
+    size_t map_len_ = 0;
+    const void* data_ = nullptr;
+    size_t count_ = 0;
+    size_t elem_size_ = 0;
+    std::string descr_;
+    bool fortran_order_ = false;
+    std::string error_;
+};
+
+#endif // __NPY_H__
@@ -0,0 +1,37 @@
+#ifndef __OPTIONS_H__
+#define __OPTIONS_H__
+
+#include <vector>
+
+#include "replay.h"
+
+class ResultChecker;
+
+// ===================================================================
+// 仿真程序命令行选项
+//   --keep-going              run every test; report the error distribution at the end
+//   --quiet                   only print failing tests
+//   --max-ulp <mode>=<n>      ULP tolerance   (mode: fp32 fp16 bf16 fp16w bf16w fp16n bf16n)
+//   --max-rel <mode>=<x>      relative error tolerance
+//   --max-rel-tiny <mode>=<x> relative error tolerance for tiny operands (max(|a|, |b|) < tiny_scale)
+//   --server <path|->         serve batches on a Unix socket (or stdin/stdout), see server.h
+//   --models <n>              Verilated models kept warm in server mode (default 1)
+//   --replay <a> <b>          stream a[i] + b[i] of two .npy/raw tensors through the DUT (repeatable)
+//   --replay-mode <mode>      operand format of the replayed tensors (default: from the .npy dtype)
+// Verilator plusargs (+verilator+...) are passed through untouched.
+// ===================================================================
+struct HarnessOptions {
+    bool keep_going = false;
+    bool quiet = false;
+    const char* server = nullptr;
+    int models = 1;
+    std::vector<ReplayPair> replay;
+    bool has_replay_mode = false;
+    TestMode replay_mode = TestMode::FP16;
+};
+
+// Returns false (after printing usage) on an unknown or malformed option.
+// Tolerance overrides are applied to checker.
+bool parse_options(int argc, char* argv[], HarnessOptions& opts, ResultChecker& checker);
+
+#endif // __OPTIONS_H__
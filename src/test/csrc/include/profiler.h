@@ -0,0 +1,58 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <cstdint>
+
+// Harness hot-path phases. Time is charged exclusively: a nested scope
+// (e.g. Ref inside Gen) pauses the enclosing phase.
+enum class ProfPhase {
+    Gen,    // test-case generation (gen_* and TestCase construction)
+    Ref,    // SoftFloat reference (softfloat_add_*)
+    Poke,   // driving DUT input ports
+    Eval,   // top_->eval()
+    Trace,  // VCD dump
+    Check,  // check_result
+    Print,  // printf of test details / results
+    Count
+};
+
+#ifdef PROFILE
+
+// ===================================================================
+// Profiler: TSC-based scoped timers, optionally with perf_event_open
+// counters (instructions, cache misses) when built with PROFILE_PERF.
+// The report is printed at exit.
+// ===================================================================
+class Profiler {
+public:
+    static void init();
+    static void push(ProfPhase phase);
+    static void pop();
+    static void add_vectors(uint64_t n) { vectors_ += n; }
+    static void report();
+
+private:
+    static uint64_t vectors_;
+};
+
+class ProfScope {
+public:
+    explicit ProfScope(ProfPhase phase) { Profiler::push(phase); }
+    ~ProfScope() { Profiler::pop(); }
+    ProfScope(const ProfScope&) = delete;
+    ProfScope& operator=(const ProfScope&) = delete;
+};
+
+#define PROF_SCOPE(phase) ProfScope prof_scope_(phase)
+#define PROF_INIT() Profiler::init()
+#define PROF_ADD_VECTORS(n) Profiler::add_vectors(n)
+
+#else
+
+#define PROF_SCOPE(phase) ((void)0)
+#define PROF_INIT() ((void)0)
+#define PROF_ADD_VECTORS(n) ((void)0)
+
+#endif // PROFILE
+
+#endif // __PROFILER_H__
@@ -0,0 +1,27 @@
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+#include <vector>
+
+#include "test_case.h"
+
+class Simulator;
+class ResultChecker;
+
+// ===================================================================
+// 真实负载回放: 将两个张量 (.npy 或原始二进制) 按元素配对, 像残差加法
+// 一样 a[i] + b[i] 流式送入DUT, 并按张量统计相对SoftFloat参考的误差
+// ===================================================================
+struct ReplayPair {
+    const char* a;
+    const char* b;
+};
+
+// .npy dtypes: '<f2' -> FP16, '<f4' -> FP32, '<u2'/'<i2'/'<V2'/'bfloat16' -> BF16.
+// has_mode overrides the inferred mode (required for raw files, and the
+// only way to select the widening modes). Returns the number of failing
+// elements over all pairs, or -1 if a file could not be used.
+long run_replay(Simulator& sim, const ResultChecker& tolerances, const std::vector<ReplayPair>& pairs,
+                bool has_mode, TestMode mode);
+
+#endif // __REPLAY_H__
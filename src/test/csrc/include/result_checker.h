@@ -0,0 +1,137 @@
+#ifndef __RESULT_CHECKER_H__
+#define __RESULT_CHECKER_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "test_case.h"
+
+// 结果/操作数的浮点格式 (16位格式的值存放在uint32_t的低16位)
+enum class FpFormat { FP32, FP16, BF16 };
+
+FpFormat result_format(TestMode mode);
+FpFormat operand_format(TestMode mode);
+const char* mode_name(TestMode mode);
+// FP16/BF16: two elements per op, every other mode one
+int elems_per_op(TestMode mode);
+const int kNumTestModes = 7;
+
+// --- Error metrics ---
+
+// Maps a bit pattern onto a signed integer line on which neighbouring
+// representable values differ by 1 and +0/-0 coincide.
+int32_t fp_ordered(uint32_t bits, FpFormat fmt);
+
+// |ordered(a) - ordered(b)|. 0 if both are NaN, UINT32_MAX if only one is.
+uint32_t fp_ulp_distance(uint32_t a, uint32_t b, FpFormat fmt);
+
+// ulp[i] = fp_ulp_distance(a[i], b[i], fmt); AVX2 when the CPU has it
+void fp_ulp_distance_batch(const uint32_t* a, const uint32_t* b, uint32_t* ulp, size_t n, FpFormat fmt);
+
+double fp_to_double(uint32_t bits, FpFormat fmt);
+
+// --- Tolerances ---
+// ULP:           ulp <= max_ulp
+// RelativeError: |dut - ref| / max(|a|, |b|) < max_rel
+//                (< max_rel_tiny when max(|a|, |b|) < tiny_scale)
+struct Tolerance {
+    uint32_t max_ulp;
+    double max_rel;
+    double max_rel_tiny;
+    double tiny_scale;
+};
+
+Tolerance default_tolerance(TestMode mode);
+
+// ===================================================================
+// ErrorStats: 流式误差统计 (ULP / 相对误差直方图 + 最大误差样例)
+// ===================================================================
+struct ErrorWitness {
+    uint32_t a, b, dut, ref;
+    uint32_t ulp;
+    double rel;
+};
+
+struct FlagWitness {
+    uint32_t a, b;
+    uint8_t dut, ref;
+};
+
+class ErrorStats {
+public:
+    // ULP bins: 0, 1, [2,3], [4,7], ..., [2^31, 2^32)
+    static const int kUlpBins = 33;
+    // Relative error bins: 0, <1e-13, one per decade [1e-13, 1e-12) .. [0.1, 1), >= 1
+    static const int kRelBins = 16;
+
+    void add(uint32_t a, uint32_t b, uint32_t dut, uint32_t ref, uint32_t ulp, double rel, bool pass);
+    void add_flags(uint32_t a, uint32_t b, uint8_t dut, uint8_t ref);
+    void merge(const ErrorStats& other);
+    void print(const char* name) const;
+
+    uint64_t count = 0;
+    uint64_t failures = 0;
+    uint64_t exact = 0;
+    uint64_t ulp_hist[kUlpBins] = {};
+    uint64_t rel_hist[kRelBins] = {};
+    bool has_witness = false;
+    ErrorWitness max_ulp = {};
+    ErrorWitness max_rel = {};
+    ErrorWitness first_failure = {};
+
+    // fflags: per bit (NX UF OF DZ NV) how often the reference raised it, and how
+    // often the DUT missed it or raised it spuriously
+    uint64_t flag_count = 0;
+    uint64_t flag_failures = 0;
+    uint64_t flag_raised[5] = {};
+    uint64_t flag_missed[5] = {};
+    uint64_t flag_spurious[5] = {};
+    FlagWitness first_flag_failure = {};
+};
+
+// 批量检查的输入 (struct of arrays, 每个数组n个元素)
+struct CheckInputs {
+    const uint32_t* a;    // operands, in operand_format(mode)
+    const uint32_t* b;
+    const uint32_t* dut;  // results, in result_format(mode)
+    const uint32_t* ref;
+};
+
+// 单个元素的检查结果
+struct LaneError {
+    uint32_t ulp;
+    double rel;
+    bool pass;
+};
+
+// ===================================================================
+// ResultChecker: 按模式的容差 + 统计
+// ===================================================================
+class ResultChecker {
+public:
+    ResultChecker();
+
+    // Checks n results, updates the per-mode statistics and returns the
+    // number of failures. err (optional) receives per-element metrics.
+    size_t check_batch(TestMode mode, ErrorType error_type, const CheckInputs& in, size_t n,
+                       LaneError* err = nullptr);
+
+    // Compares n DUT fflags with the reference (exact match), updates the
+    // per-mode statistics and returns the number of mismatches
+    size_t check_flags(TestMode mode, const uint32_t* a, const uint32_t* b, const uint8_t* dut, const uint8_t* ref,
+                       size_t n);
+
+    Tolerance& tolerance(TestMode mode) { return tol_[(int)mode]; }
+    const Tolerance& tolerance(TestMode mode) const { return tol_[(int)mode]; }
+    const ErrorStats& stats(TestMode mode) const { return stats_[(int)mode]; }
+    uint64_t total_failures() const;
+
+    // Prints histograms and witnesses of every mode that saw results
+    void report() const;
+
+private:
+    Tolerance tol_[kNumTestModes];
+    ErrorStats stats_[kNumTestModes];
+};
+
+#endif // __RESULT_CHECKER_H__
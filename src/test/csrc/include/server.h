@@ -0,0 +1,43 @@
+#ifndef __SERVER_H__
+#define __SERVER_H__
+
+#include <cstdint>
+
+// ===================================================================
+// 仿真服务器: 常驻的Verilated模型, 通过Unix socket或stdin/stdout
+// 接收批量操作数并返回DUT结果 (可选附带SoftFloat参考结果和fflags)
+//
+// Frames are little-endian, element types as in Simulator::run_stream:
+//   request : ServerRequest,  a[n], b[n]                          (operand width)
+//   response: ServerResponse, out[n] [, ref[n]] [, fflags[n], ref_fflags[n]]
+// out/ref have the result width, fflags one byte per element (NV DZ OF UF NX,
+// bit 4..0) from the DUT and from SoftFloat. mode uses the TestMode numbering:
+// 0 FP32, 1 FP16, 2 BF16, 3 FP16_Widen, 4 BF16_Widen, 5 FP16_Narrow,
+// 6 BF16_Narrow. A malformed request gets status -1 and the connection is closed.
+// ===================================================================
+const uint32_t kServerMagic = 0x53414656; // "VFAS"
+const uint32_t kServerWantRef = 1u << 0;  // request/response flag: reference results
+const uint32_t kServerWantFlags = 1u << 1; // request/response flag: DUT and reference fflags
+const uint32_t kServerMaxBatch = 1u << 24;
+
+struct ServerRequest {
+    uint32_t magic;
+    uint32_t mode;
+    uint32_t flags;
+    uint32_t n;
+};
+
+struct ServerResponse {
+    uint32_t magic;
+    int32_t status;   // 0 ok, -1 bad request, -2 DUT timeout
+    uint32_t flags;   // kServerWantRef / kServerWantFlags: which optional arrays follow out[]
+    uint32_t n;
+};
+
+// path "-" serves a single stream on stdin/stdout with one model.
+// Otherwise listens on a Unix socket; each of `models` threads owns a
+// Verilated model and serves one connection at a time. Does not return
+// unless setup fails.
+int run_server(const char* path, int models);
+
+#endif // __SERVER_H__
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include "test_case.h"
+#include "result_checker.h"
 
 // 前向声明Verilator相关类
 class Vtop;
@@ -17,15 +18,38 @@ class VerilatedVcdC;
 // ===================================================================
 class Simulator {
 public:
-    Simulator(int argc, char* argv[]);
+    // trace = false skips the VCD dump even in a VCD build (server models)
+    Simulator(int argc, char* argv[], bool trace = true);
     ~Simulator();
 
-    bool run_test(const TestCase& test);
+    bool run_test(const TestCase& test, ResultChecker& checker);
     void reset(int n);
 
+    // Streams n elements through the pipeline, one issue per cycle, reading
+    // and writing the caller's buffers directly. Element types by mode:
+    //   FP32: a, b, out uint32_t | FP16/BF16: uint16_t (two per cycle)
+    //   FP16_Widen/BF16_Widen: a, b uint16_t, out uint32_t
+    //   FP16_Narrow/BF16_Narrow: a, b uint32_t, out uint16_t
+    // flags (optional) receives the fflags of every element.
+    // Returns the number of results written (< n only on timeout).
+    size_t run_stream(TestMode mode, const void* a, const void* b, void* out, size_t n, uint8_t* flags = nullptr);
+
+    // Cycles from valid_in to valid_out of a single op in mode (-1 on timeout)
+    int measure_latency(TestMode mode);
+    // Latency the RTL was built for: VParams.faddDelay - delayBias
+    int expected_latency() const;
+
+    // Clock cycles simulated so far
+    uint64_t cycles() const;
+    // verbose=false: only failing tests are printed
+    void set_verbose(bool verbose) { verbose_ = verbose; }
+
 private:
     void init_vcd();
     void single_cycle();
+    void poke_inputs(const TestCase& test);
+    void set_mode(TestMode mode);
+    void poke_operands(TestMode mode, uint32_t a0, uint32_t b0, uint32_t a1, uint32_t b1);
     
     // Verilator核心对象
     std::unique_ptr<VerilatedContext> contextp_;
@@ -35,6 +59,7 @@ private:
 #ifdef VCD
     VerilatedVcdC* tfp_ = nullptr;
 #endif
+    bool verbose_ = true;
 };
 
 #endif // __SIMULATOR_H__
\ No newline at end of file
@@ -1,8 +1,11 @@
 #ifndef __SOFTFLOAT_REF_H__
 #define __SOFTFLOAT_REF_H__
 
+#include <cstddef>
 #include <cstdint>
 
+#include "test_case.h"
+
 // FP32 a + b, inputs and output are in uint32_t bit format
 uint32_t softfloat_add_fp32(uint32_t a, uint32_t b);
 
@@ -12,4 +15,35 @@ uint16_t softfloat_add_fp16(uint16_t a, uint16_t b);
 // BF16 a + b, inputs and output are in uint16_t bit format
 uint16_t softfloat_add_bf16(uint16_t a, uint16_t b);
 
+// FP32 a + b rounded once (RNE) to FP16 / BF16, i.e. without the intermediate FP32 rounding
+uint16_t softfloat_add_fp32_to_fp16(uint32_t a, uint32_t b);
+uint16_t softfloat_add_fp32_to_bf16(uint32_t a, uint32_t b);
+
+// FP32 a * b + c with a single rounding (RNE), bit format as above
+uint32_t softfloat_fma_fp32(uint32_t a, uint32_t b, uint32_t c);
+
+// FP64 a + b (RNE), inputs and output are in uint64_t bit format.
+// flags (optional) receives the exception flags of the addition.
+uint64_t softfloat_add_fp64(uint64_t a, uint64_t b, uint8_t* flags = nullptr);
+
+// RISC-V fflags bits, same values as SoftFloat's softfloat_flag_*
+enum FFlag : uint8_t { kFlagNX = 1, kFlagUF = 2, kFlagOF = 4, kFlagDZ = 8, kFlagNV = 16 };
+
+// Exception flags raised by one element a + b of mode (16-bit operands in the
+// low bits). BF16 is added exactly in FP64 and rounded to BF16 here, FP32/FP16
+// and the widen modes (including the conversion of the operands) by SoftFloat.
+// The narrowing modes take FP32 operands and use the rounding of the functions above.
+uint8_t softfloat_add_flags(TestMode mode, uint32_t a, uint32_t b);
+
+// Names of the set flags, e.g. "NV|NX", or "-" for none
+const char* fflags_str(uint8_t flags, char buf[16]);
+
+// Reference for a whole buffer, element types as in Simulator::run_stream.
+// Widen modes extend the 16-bit operands to FP32 exactly, then add in FP32.
+// Narrowing modes: a, b uint32_t, out uint16_t.
+// flags (optional) receives softfloat_add_flags() of every element.
+// Not thread-safe (SoftFloat state is global): callers serialize.
+void softfloat_add_stream(TestMode mode, const void* a, const void* b, void* out, size_t n,
+                          uint8_t* flags = nullptr);
+
 #endif // __SOFTFLOAT_REF_H__ 
\ No newline at end of file
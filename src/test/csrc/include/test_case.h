@@ -26,6 +26,12 @@ struct FADD_Operands_FP16_Widen {
 struct FADD_Operands_BF16_Widen {
     uint16_t a_hex, b_hex;
 };
+struct FADD_Operands_FP16_Narrow {
+    uint32_t a_hex, b_hex;
+};
+struct FADD_Operands_BF16_Narrow {
+    uint32_t a_hex, b_hex;
+};
 
 // 定义测试模式的枚举类型
 enum class TestMode {
@@ -33,7 +39,9 @@ enum class TestMode {
     FP16,
     BF16,
     FP16_Widen,
-    BF16_Widen
+    BF16_Widen,
+    FP16_Narrow, // FP32 a + b, rounded once to FP16
+    BF16_Narrow  // FP32 a + b, rounded once to BF16
 };
 
 // 定义测试结果允许误差范围
@@ -48,9 +56,13 @@ enum class ErrorType {
 struct DutOutputs {
     uint32_t res_out_32;
     uint16_t res_out_16_0;
-    uint16_t res_out_16_1;
+    uint16_t res_out_16_1; // also the narrowed result
+    uint8_t fflags_0;  // NV DZ OF UF NX of res_out_16_0, or of res_out_32
+    uint8_t fflags_1;  // of res_out_16_1
 };
 
+class ResultChecker;
+
 // ===================================================================
 // TestCase 类: 封装单个测试用例
 // ===================================================================
@@ -70,18 +82,26 @@ public:
     
     // 构造函数 for BF16 widen operation using hexadecimal input (a,b are BF16, result is FP32)
     TestCase(const FADD_Operands_BF16_Widen& ops_widen, ErrorType error_type = ErrorType::ULP);
+
+    // 构造函数 for FP32 + FP32 -> FP16 narrowing operation (single rounding)
+    TestCase(const FADD_Operands_FP16_Narrow& ops_narrow, ErrorType error_type = ErrorType::ULP);
+
+    // 构造函数 for FP32 + FP32 -> BF16 narrowing operation (single rounding)
+    TestCase(const FADD_Operands_BF16_Narrow& ops_narrow, ErrorType error_type = ErrorType::ULP);
     
     void print_details() const;
-    bool check_result(const DutOutputs& dut_res) const;
+    // Checks the DUT outputs with the checker's per-mode tolerances and
+    // accumulates accuracy statistics. Passing results are only printed when verbose.
+    bool check_result(const DutOutputs& dut_res, ResultChecker& checker, bool verbose = true) const;
 
     TestMode mode;
     ErrorType error_type;
 
     // --- 公共数据成员，供 Simulator 直接访问 ---
     // 控制信号
-    bool is_fp32, is_fp16, is_bf16, is_widen;
+    bool is_fp32, is_fp16, is_bf16, is_widen, is_narrow = false;
 
-    // FP32 模式数据
+    // FP32 模式数据 (narrowing 的操作数也在这里)
     uint32_t a_fp32_bits, b_fp32_bits;
 
     // FP16 模式数据
@@ -103,6 +123,8 @@ private:
     uint32_t expected_res_fp32;
     uint16_t expected_res1_fp16, expected_res2_fp16;
     uint16_t expected_res1_bf16, expected_res2_bf16;
+    // 期望的异常标志 (fflags), [1]仅用于FP16/BF16双路
+    uint8_t expected_flags[2] = {};
 };
 
 #endif // __TEST_CASE_H__ 
\ No newline at end of file
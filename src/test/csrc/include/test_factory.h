@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "test_case.h"
+#include "workload_dist.h"
 
 // Creates and returns a vector of all test cases.
 std::vector<TestCase> create_all_tests();
@@ -13,5 +14,12 @@ void add_fp16_tests(std::vector<TestCase>& tests);
 void add_bf16_tests(std::vector<TestCase>& tests);
 void add_fp16_widen_tests(std::vector<TestCase>& tests);
 void add_bf16_widen_tests(std::vector<TestCase>& tests);
+void add_fp16_narrow_tests(std::vector<TestCase>& tests);
+void add_bf16_narrow_tests(std::vector<TestCase>& tests);
+
+// Appends `count` test cases of `mode` whose operands follow the workload
+// distribution p (FP16/BF16 cases carry two independent pairs).
+void add_workload_tests(std::vector<TestCase>& tests, TestMode mode, const WorkloadParams& p, int count,
+                        ErrorType error_type);
 
 #endif // __TEST_FACTORY_H__ 
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef __VERILATED_FIXTURE_H__
+#define __VERILATED_FIXTURE_H__
+
+#include <verilated.h>
+
+#include <cstdint>
+#include <memory>
+
+// ===================================================================
+// VerilatedFixture: 单个 Verilated 模型的时钟/复位/流水发射骨架
+//   各测试台继承它, 只保留自己的端口映射
+// ===================================================================
+template <class Model>
+class VerilatedFixture {
+public:
+    // argc = 0: no plusargs (library use)
+    VerilatedFixture(int argc, char* argv[]) : contextp_(new VerilatedContext) {
+        if (argc > 0) {
+            contextp_->commandArgs(argc, argv);
+        }
+        top_.reset(new Model(contextp_.get()));
+    }
+
+    // Two cycles of reset with valid_in low
+    void reset() {
+        top_->io_valid_in = 0;
+        top_->reset = 1;
+        single_cycle();
+        single_cycle();
+        top_->reset = 0;
+    }
+    void single_cycle() {
+        top_->clock = 0;
+        top_->eval();
+        contextp_->timeInc(1);
+        top_->clock = 1;
+        top_->eval();
+        contextp_->timeInc(1);
+    }
+    // Cycles from issuing the poked operands alone until valid_out, -1 on timeout
+    int single_op_latency() {
+        top_->io_valid_in = 1;
+        single_cycle();
+        top_->io_valid_in = 0;
+        for (int latency = 1; latency <= 100; ++latency) {
+            if (top_->io_valid_out) {
+                return latency;
+            }
+            single_cycle();
+        }
+        return -1;
+    }
+    // Clock cycles simulated so far
+    uint64_t cycles() const { return contextp_->time() / 2; }
+    Model* top() { return top_.get(); }
+
+protected:
+    // Pipelined stream of n elements, one issue per cycle while any are left.
+    // issue(i) pokes the operands starting at element i and returns how many
+    // elements that issue carries; collect(i) reads a valid_out cycle into
+    // element i onward and returns how many it wrote. Gives up after idle_limit
+    // cycles without valid_out once everything is issued.
+    // Returns the number of elements collected (< n only on timeout).
+    template <class IssueFn, class CollectFn>
+    uint64_t stream(uint64_t n, IssueFn issue, CollectFn collect, int idle_limit = 100) {
+        uint64_t issued = 0, done = 0;
+        int idle = 0;
+        while (done < n) {
+            top_->io_valid_in = issued < n;
+            if (issued < n) {
+                issued += issue(issued);
+            }
+            single_cycle();
+            if (top_->io_valid_out) {
+                done += collect(done);
+                idle = 0;
+            } else if (issued >= n && ++idle > idle_limit) {
+                break;
+            }
+        }
+        top_->io_valid_in = 0;
+        return done < n ? done : n;
+    }
+
+    std::unique_ptr<VerilatedContext> contextp_;
+    std::unique_ptr<Model> top_;
+};
+
+#endif // __VERILATED_FIXTURE_H__
@@ -0,0 +1,49 @@
+#ifndef __WORKLOAD_DIST_H__
+#define __WORKLOAD_DIST_H__
+
+#include <cstdint>
+
+#include "result_checker.h"
+
+// ===================================================================
+// AI负载形状的操作数分布 (补充 gen_random_* / gen_any_* 的均匀位模式)
+// ===================================================================
+enum class WorkloadDist {
+    Gaussian,        // 激活值: N(0, scale)
+    LogNormal,       // 梯度: |x| = scale * 2^N(0, spread), 随机符号
+    OutlierChannels, // 激活值, 其中 fraction 比例的通道放大 spread 倍
+    Cancelling       // 残差对: b ≈ -a, |a| 与 |b| 相差 0 .. 2^spread ulp
+};
+
+struct WorkloadParams {
+    WorkloadDist dist;
+    double scale;
+    double spread;
+    double fraction;
+};
+
+inline WorkloadParams workload_gaussian(double sigma) {
+    return {WorkloadDist::Gaussian, sigma, 0, 0};
+}
+inline WorkloadParams workload_log_normal(double median, double sigma_octaves) {
+    return {WorkloadDist::LogNormal, median, sigma_octaves, 0};
+}
+inline WorkloadParams workload_outliers(double sigma, double gain, double fraction) {
+    return {WorkloadDist::OutlierChannels, sigma, gain, fraction};
+}
+inline WorkloadParams workload_cancelling(double sigma, int max_ulp_log2) {
+    return {WorkloadDist::Cancelling, sigma, (double)max_ulp_log2, 0};
+}
+
+const char* workload_name(WorkloadDist dist);
+
+// Reseeds the mt19937 behind gen_workload_pair. Without a call it is
+// seeded from rand() on first use, so it follows the harness's srand().
+void workload_seed(uint32_t seed);
+
+// Samples one operand pair in fmt (FP16/BF16 in the low 16 bits).
+// Values are drawn in double and rounded to fmt with RNE; out-of-range
+// samples saturate to Inf as they would in a real tensor.
+void gen_workload_pair(const WorkloadParams& p, FpFormat fmt, uint32_t& a, uint32_t& b);
+
+#endif // __WORKLOAD_DIST_H__
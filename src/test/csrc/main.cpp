@@ -1,32 +1,104 @@
 #include "include/simulator.h"
 #include "include/test_factory.h"
+#include "include/profiler.h"
+#include "include/result_checker.h"
+#include "include/options.h"
+#include "include/server.h"
+#include "include/replay.h"
 #include <vector>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
 
+// valid_in -> valid_out of every mode must equal VParams.faddDelay - delayBias
+static bool check_latency(Simulator& sim) {
+  int expected = sim.expected_latency();
+  bool ok = true;
+  printf("--- Latency check (faddDelay - delayBias = %d cycles) ---\n", expected);
+  for (int m = 0; m < kNumTestModes; ++m) {
+    TestMode mode = (TestMode)m;
+    int latency = sim.measure_latency(mode);
+    printf("  %-11s %d cycles%s\n", mode_name(mode), latency, latency == expected ? "" : "  <-- MISMATCH");
+    ok &= latency == expected;
+  }
+  if (!ok) {
+    printf("FAdd_16_32 latency does not match VParams.faddDelay.\n");
+  }
+  return ok;
+}
+
 int main(int argc, char *argv[]) {
   // 1. 初始化随机数生成器种子
   srand(time(NULL)); 
+  PROF_INIT();
+
+  HarnessOptions opts;
+  ResultChecker checker;
+  if (!parse_options(argc, argv, opts, checker)) {
+    return 1;
+  }
+  if (opts.server) {
+    return run_server(opts.server, opts.models);
+  }
 
   // 2. 初始化仿真器
   Simulator sim(argc, argv);
+  sim.set_verbose(!opts.quiet);
+  if (!check_latency(sim)) {
+    return 1;
+  }
+
+  if (!opts.replay.empty()) {
+    long failures = run_replay(sim, checker, opts.replay, opts.has_replay_mode, opts.replay_mode);
+    if (failures < 0) {
+      printf("\nReplay aborted.\n");
+      return 1;
+    }
+    if (failures > 0) {
+      printf("\nReplay found %ld elements out of tolerance.\n", failures);
+      return 1;
+    }
+    printf("\nReplay passed.\n");
+    return 0;
+  }
 
   // 3. 使用 TestFactory 创建所有测试用例
   printf("--- Creating all test cases ---\n");
-  std::vector<TestCase> tests = create_all_tests();
+  std::vector<TestCase> tests;
+  {
+    PROF_SCOPE(ProfPhase::Gen);
+    tests = create_all_tests();
+  }
   printf("--- All test cases created ---\n\n");
 
-  // 4. 执行所有测试，遇到错误即停止
+  // 4. 执行所有测试，遇到错误即停止 (--keep-going 时跑完全部再统计)
+  size_t failed_tests = 0;
   for (size_t i = 0; i < tests.size(); ++i) {
-    printf("--- Running test case %zu of %zu ---\n", i + 1, tests.size());
-    if (!sim.run_test(tests[i])) {
-      printf("\n=================================\n");
-      printf("      TEST FAILED!\n");
-      printf("=================================\n");
-      printf("Failed on test case %zu.\n", i + 1);
-      return 1; // 返回非零值表示失败
+    if (!opts.quiet) {
+      PROF_SCOPE(ProfPhase::Print);
+      printf("--- Running test case %zu of %zu ---\n", i + 1, tests.size());
     }
+    if (!sim.run_test(tests[i], checker)) {
+      failed_tests++;
+      if (!opts.keep_going) {
+        printf("\n=================================\n");
+        printf("      TEST FAILED!\n");
+        printf("=================================\n");
+        printf("Failed on test case %zu.\n", i + 1);
+        checker.report();
+        return 1; // 返回非零值表示失败
+      }
+      printf("Test case %zu failed, continuing (--keep-going)\n", i + 1);
+    }
+  }
+
+  checker.report();
+  if (failed_tests) {
+    printf("\n=================================\n");
+    printf("      TEST FAILED!\n");
+    printf("=================================\n");
+    printf("%zu of %zu test cases failed.\n", failed_tests, tests.size());
+    return 1;
   }
 
   // 5. 如果所有测试都通过，打印成功信息
@@ -0,0 +1,124 @@
+#include "include/npy.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+NpyFile::~NpyFile() {
+    if (map_) {
+        munmap(map_, map_len_);
+    }
+}
+
+bool NpyFile::open(const char* path, size_t raw_elem_size) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        error_ = std::string("cannot open ") + path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        close(fd);
+        error_ = std::string("empty or unreadable file ") + path;
+        return false;
+    }
+    map_len_ = (size_t)st.st_size;
+    map_ = mmap(nullptr, map_len_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        error_ = std::string("mmap failed for ") + path;
+        return false;
+    }
+    madvise(map_, map_len_, MADV_SEQUENTIAL);
+
+    const char* p = (const char*)map_;
+    if (map_len_ >= 6 && !memcmp(p, "\x93NUMPY", 6)) {
+        return parse_header(path);
+    }
+    // 原始二进制
+    elem_size_ = raw_elem_size;
+    data_ = map_;
+    count_ = map_len_ / elem_size_;
+    return true;
+}
+
+// Header: magic(6) major(1) minor(1) len(2 or 4) dict-string, e.g.
+// {'descr': '<f2', 'fortran_order': False, 'shape': (4, 1024), }
+bool NpyFile::parse_header(const char* path) {
+    const uint8_t* p = (const uint8_t*)map_;
+    if (map_len_ < 10) {
+        error_ = std::string("truncated npy header in ") + path;
+        return false;
+    }
+    int major = p[6];
+    size_t header_len, header_off;
+    if (major == 1) {
+        header_len = p[8] | (p[9] << 8);
+        header_off = 10;
+    } else {
+        if (map_len_ < 12) {
+            error_ = std::string("truncated npy header in ") + path;
+            return false;
+        }
+        header_len = p[8] | (p[9] << 8) | ((size_t)p[10] << 16) | ((size_t)p[11] << 24);
+        header_off = 12;
+    }
+    if (header_off + header_len > map_len_) {
+        error_ = std::string("truncated npy header in ") + path;
+        return false;
+    }
+    std::string header((const char*)p + header_off, header_len);
+
+    size_t d = header.find("'descr'");
+    size_t q1 = d == std::string::npos ? d : header.find('\'', d + 7);
+    size_t q2 = q1 == std::string::npos ? q1 : header.find('\'', q1 + 1);
+    if (q2 == std::string::npos) {
+        error_ = std::string("no dtype in npy header of ") + path;
+        return false;
+    }
+    descr_ = header.substr(q1 + 1, q2 - q1 - 1);
+    fortran_order_ = header.find("'fortran_order': True") != std::string::npos;
+
+    size_t s = header.find("'shape'");
+    size_t lp = s == std::string::npos ? s : header.find('(', s);
+    size_t rp = lp == std::string::npos ? lp : header.find(')', lp);
+    if (rp == std::string::npos) {
+        error_ = std::string("no shape in npy header of ") + path;
+        return false;
+    }
+    count_ = 1;
+    const char* c = header.c_str() + lp + 1;
+    const char* end = header.c_str() + rp;
+    while (c < end) {
+        char* next;
+        unsigned long long dim = strtoull(c, &next, 10);
+        if (next == c) {
+            c++;
+            continue;
+        }
+        count_ *= dim;
+        c = next;
+    }
+
+    // 元素大小取自dtype字符串末尾的数字 ("<f2" -> 2); 'bfloat16'按2字节
+    elem_size_ = descr_ == "bfloat16" ? 2 : (size_t)atoi(descr_.c_str() + strcspn(descr_.c_str(), "0123456789"));
+    if (elem_size_ == 0) {
+        error_ = std::string("unsupported dtype '") + descr_ + "' in " + path;
+        return false;
+    }
+    if (descr_[0] == '>' && elem_size_ > 1) {
+        error_ = std::string("big-endian dtype not supported in ") + path;
+        return false;
+    }
+    data_ = p + header_off + header_len;
+    if (header_off + header_len + count_ * elem_size_ > map_len_) {
+        error_ = std::string("truncated npy data in ") + path;
+        return false;
+    }
+    return true;
+}
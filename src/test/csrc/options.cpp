@@ -0,0 +1,78 @@
+#include "include/options.h"
+#include "include/result_checker.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [--keep-going] [--quiet] [--max-ulp <mode>=<n>] [--max-rel <mode>=<x>]\n", prog);
+    printf("       %*s [--max-rel-tiny <mode>=<x>]\n", (int)strlen(prog), "");
+    printf("       %s --server <socket|-> [--models <n>]\n", prog);
+    printf("       %s --replay <a.npy> <b.npy> [--replay <a> <b> ...] [--replay-mode <mode>]\n", prog);
+    printf("  mode: fp32 fp16 bf16 fp16w bf16w fp16n bf16n\n");
+}
+
+static bool parse_mode(const char* s, size_t len, TestMode& mode) {
+    static const struct { const char* name; TestMode mode; } kModes[] = {
+        {"fp32", TestMode::FP32}, {"fp16", TestMode::FP16}, {"bf16", TestMode::BF16},
+        {"fp16w", TestMode::FP16_Widen}, {"bf16w", TestMode::BF16_Widen},
+        {"fp16n", TestMode::FP16_Narrow}, {"bf16n", TestMode::BF16_Narrow},
+    };
+    for (const auto& m : kModes) {
+        if (strlen(m.name) == len && !strncmp(s, m.name, len)) {
+            mode = m.mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+// "<mode>=<value>" -> mode, value string
+static bool parse_mode_value(const char* arg, TestMode& mode, const char*& value) {
+    const char* eq = strchr(arg, '=');
+    if (!eq || !parse_mode(arg, eq - arg, mode)) {
+        return false;
+    }
+    value = eq + 1;
+    return *value != '\0';
+}
+
+bool parse_options(int argc, char* argv[], HarnessOptions& opts, ResultChecker& checker) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        TestMode mode;
+        const char* value;
+        if (arg[0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(arg, "--keep-going")) {
+            opts.keep_going = true;
+        } else if (!strcmp(arg, "--quiet")) {
+            opts.quiet = true;
+        } else if (!strcmp(arg, "--max-ulp") && i + 1 < argc && parse_mode_value(argv[i + 1], mode, value)) {
+            checker.tolerance(mode).max_ulp = (uint32_t)strtoul(value, nullptr, 0);
+            i++;
+        } else if (!strcmp(arg, "--max-rel") && i + 1 < argc && parse_mode_value(argv[i + 1], mode, value)) {
+            checker.tolerance(mode).max_rel = atof(value);
+            i++;
+        } else if (!strcmp(arg, "--max-rel-tiny") && i + 1 < argc && parse_mode_value(argv[i + 1], mode, value)) {
+            checker.tolerance(mode).max_rel_tiny = atof(value);
+            i++;
+        } else if (!strcmp(arg, "--server") && i + 1 < argc) {
+            opts.server = argv[++i];
+        } else if (!strcmp(arg, "--models") && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            opts.models = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--replay") && i + 2 < argc) {
+            opts.replay.push_back({argv[i + 1], argv[i + 2]});
+            i += 2;
+        } else if (!strcmp(arg, "--replay-mode") && i + 1 < argc &&
+                   parse_mode(argv[i + 1], strlen(argv[i + 1]), opts.replay_mode)) {
+            opts.has_replay_mode = true;
+            i++;
+        } else {
+            printf("Unknown or malformed option: %s\n", arg);
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
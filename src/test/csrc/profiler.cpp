@@ -0,0 +1,170 @@
+#include "include/profiler.h"
+
+#ifdef PROFILE
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef PROFILE_PERF
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* kPhaseNames[] = {"gen", "ref", "poke", "eval", "trace", "check", "print"};
+static_assert(sizeof(kPhaseNames) / sizeof(kPhaseNames[0]) == (size_t)ProfPhase::Count,
+              "kPhaseNames must cover every ProfPhase");
+
+static const int kNumPhases = (int)ProfPhase::Count;
+static const int kMaxDepth = 32;
+// Slot kNumPhases collects time spent outside any scope ("other")
+static const int kOther = kNumPhases;
+
+struct PhaseStats {
+    uint64_t ticks = 0;
+    uint64_t calls = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+};
+
+static PhaseStats g_stats[kNumPhases + 1];
+static int g_stack[kMaxDepth];
+static int g_depth = 0;
+static uint64_t g_last_tick = 0;
+static uint64_t g_start_tick = 0;
+static std::chrono::steady_clock::time_point g_start_time;
+
+uint64_t Profiler::vectors_ = 0;
+
+// rdtsc on x86; steady_clock nanoseconds elsewhere
+static inline uint64_t read_tick() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+#ifdef PROFILE_PERF
+// Counter group: leader = instructions, member = cache misses.
+// Note: every scope transition costs one read() syscall in this mode.
+static int g_perf_fd = -1;
+static uint64_t g_last_instr = 0, g_last_miss = 0;
+
+static int perf_open(uint64_t config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (group_fd == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+static void perf_read(uint64_t& instr, uint64_t& miss) {
+    uint64_t buf[3] = {0, 0, 0}; // nr, instructions, cache misses
+    if (g_perf_fd < 0 || read(g_perf_fd, buf, sizeof(buf)) <= 0) {
+        instr = miss = 0;
+        return;
+    }
+    instr = buf[1];
+    miss = buf[0] > 1 ? buf[2] : 0;
+}
+#endif
+
+// Charge everything since the last transition to the phase on top of the stack
+static inline void charge() {
+    uint64_t now = read_tick();
+    int top = g_depth < kMaxDepth ? g_depth : kMaxDepth;
+    int cur = top > 0 ? g_stack[top - 1] : kOther;
+    g_stats[cur].ticks += now - g_last_tick;
+    g_last_tick = now;
+#ifdef PROFILE_PERF
+    uint64_t instr, miss;
+    perf_read(instr, miss);
+    g_stats[cur].instructions += instr - g_last_instr;
+    g_stats[cur].cache_misses += miss - g_last_miss;
+    g_last_instr = instr;
+    g_last_miss = miss;
+#endif
+}
+
+void Profiler::init() {
+#ifdef PROFILE_PERF
+    g_perf_fd = perf_open(PERF_COUNT_HW_INSTRUCTIONS, -1);
+    if (g_perf_fd >= 0) {
+        if (perf_open(PERF_COUNT_HW_CACHE_MISSES, g_perf_fd) < 0) {
+            printf("[prof] cache-miss counter unavailable\n");
+        }
+        ioctl(g_perf_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(g_perf_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        perf_read(g_last_instr, g_last_miss);
+    } else {
+        printf("[prof] perf_event_open failed, reporting time only\n");
+    }
+#endif
+    g_start_time = std::chrono::steady_clock::now();
+    g_start_tick = read_tick();
+    g_last_tick = g_start_tick;
+    atexit(Profiler::report);
+}
+
+void Profiler::push(ProfPhase phase) {
+    charge();
+    if (g_depth < kMaxDepth) {
+        g_stack[g_depth] = (int)phase;
+    }
+    g_depth++;
+    g_stats[(int)phase].calls++;
+}
+
+void Profiler::pop() {
+    charge();
+    g_depth--;
+}
+
+void Profiler::report() {
+    charge();
+    uint64_t total_ticks = g_last_tick - g_start_tick;
+    double total_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - g_start_time).count();
+    double sec_per_tick = total_ticks ? total_sec / (double)total_ticks : 0.0;
+
+    printf("\n================ Harness profile ================\n");
+    printf("%-8s %12s %8s %14s", "phase", "time(ms)", "share", "calls");
+#ifdef PROFILE_PERF
+    printf(" %14s %12s", "instructions", "cache-miss");
+#endif
+    printf("\n");
+    for (int i = 0; i <= kNumPhases; ++i) {
+        const PhaseStats& s = g_stats[i];
+        if (s.ticks == 0 && s.calls == 0) {
+            continue;
+        }
+        printf("%-8s %12.3f %7.2f%% %14llu", i == kOther ? "other" : kPhaseNames[i],
+               s.ticks * sec_per_tick * 1e3,
+               total_ticks ? 100.0 * (double)s.ticks / (double)total_ticks : 0.0,
+               (unsigned long long)s.calls);
+#ifdef PROFILE_PERF
+        printf(" %14llu %12llu", (unsigned long long)s.instructions, (unsigned long long)s.cache_misses);
+#endif
+        printf("\n");
+    }
+    printf("-------------------------------------------------\n");
+    printf("Total: %.3f s, %llu vectors, %.1f vectors/s\n", total_sec,
+           (unsigned long long)vectors_, total_sec > 0 ? (double)vectors_ / total_sec : 0.0);
+    printf("=================================================\n");
+    fflush(stdout);
+}
+
+#endif // PROFILE
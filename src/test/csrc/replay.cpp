@@ -0,0 +1,142 @@
+#include "include/replay.h"
+#include "include/npy.h"
+#include "include/result_checker.h"
+#include "include/simulator.h"
+#include "include/softfloat_ref.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// 每次送入DUT/参考/检查的元素数, 以限制临时缓冲区大小
+static const size_t kReplayChunk = 1 << 16;
+
+static bool infer_mode(const std::string& descr, TestMode& mode) {
+    if (descr == "<f2" || descr == "|f2") {
+        mode = TestMode::FP16;
+    } else if (descr == "<f4") {
+        mode = TestMode::FP32;
+    } else if (descr == "<u2" || descr == "<i2" || descr == "|V2" || descr == "<V2" || descr == "bfloat16") {
+        mode = TestMode::BF16; // numpy has no native bf16; ml_dtypes/torch exports land here
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static size_t operand_bytes(TestMode mode) {
+    return operand_format(mode) == FpFormat::FP32 ? 4 : 2;
+}
+
+static size_t result_bytes(TestMode mode) {
+    return result_format(mode) == FpFormat::FP32 ? 4 : 2;
+}
+
+static void widen(const void* src, size_t bytes, uint32_t* dst, size_t n) {
+    if (bytes == 4) {
+        memcpy(dst, src, n * 4);
+    } else {
+        const uint16_t* s = (const uint16_t*)src;
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = s[i];
+        }
+    }
+}
+
+static long replay_pair(Simulator& sim, const ResultChecker& tolerances, const ReplayPair& pair,
+                        bool has_mode, TestMode mode) {
+    TestMode mode_a, mode_b;
+    NpyFile a, b;
+    size_t raw_bytes = has_mode ? operand_bytes(mode) : 2;
+    if (!a.open(pair.a, raw_bytes) || !b.open(pair.b, raw_bytes)) {
+        printf("replay: %s\n", !a.error().empty() ? a.error().c_str() : b.error().c_str());
+        return -1;
+    }
+    if (!has_mode) {
+        // Both dtypes must agree: <f2 + bf16 has the same element size but is not an FP16 add
+        if (!infer_mode(a.descr(), mode_a)) {
+            printf("replay: cannot infer format of %s (dtype '%s'), use --replay-mode\n", pair.a, a.descr().c_str());
+            return -1;
+        }
+        if (!infer_mode(b.descr(), mode_b)) {
+            printf("replay: cannot infer format of %s (dtype '%s'), use --replay-mode\n", pair.b, b.descr().c_str());
+            return -1;
+        }
+        if (mode_a != mode_b) {
+            printf("replay: %s (dtype '%s') and %s (dtype '%s') have different formats, use --replay-mode\n",
+                   pair.a, a.descr().c_str(), pair.b, b.descr().c_str());
+            return -1;
+        }
+        mode = mode_a;
+    }
+    if (a.elem_size() != operand_bytes(mode) || b.elem_size() != a.elem_size()) {
+        printf("replay: %s / %s element size does not match mode %s\n", pair.a, pair.b, mode_name(mode));
+        return -1;
+    }
+    if (a.count() != b.count() || a.fortran_order() != b.fortran_order()) {
+        printf("replay: %s (%zu elements) and %s (%zu elements) do not pair up\n",
+               pair.a, a.count(), pair.b, b.count());
+        return -1;
+    }
+
+    ResultChecker checker;
+    checker.tolerance(mode) = tolerances.tolerance(mode);
+
+    size_t n = a.count();
+    size_t in_bytes = operand_bytes(mode), out_bytes = result_bytes(mode);
+    std::vector<uint8_t> dut(kReplayChunk * out_bytes), ref(kReplayChunk * out_bytes);
+    std::vector<uint32_t> ca(kReplayChunk), cb(kReplayChunk), cdut(kReplayChunk), cref(kReplayChunk);
+    std::vector<uint8_t> dut_flags(kReplayChunk), ref_flags(kReplayChunk);
+    std::vector<LaneError> lane_err(kReplayChunk);
+
+    uint64_t start_cycles = sim.cycles();
+    double sim_seconds = 0;
+    // An element wrong in both value and flags is one failing element
+    long failures = 0, value_failures = 0, flag_failures = 0;
+    for (size_t off = 0; off < n; off += kReplayChunk) {
+        size_t len = n - off < kReplayChunk ? n - off : kReplayChunk;
+        const uint8_t* pa = (const uint8_t*)a.data() + off * in_bytes;
+        const uint8_t* pb = (const uint8_t*)b.data() + off * in_bytes;
+
+        auto t0 = std::chrono::steady_clock::now();
+        size_t done = sim.run_stream(mode, pa, pb, dut.data(), len, dut_flags.data());
+        sim_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (done != len) {
+            printf("replay: DUT timed out at element %zu of %s + %s\n", off + done, pair.a, pair.b);
+            return -1;
+        }
+        softfloat_add_stream(mode, pa, pb, ref.data(), len, ref_flags.data());
+
+        widen(pa, in_bytes, ca.data(), len);
+        widen(pb, in_bytes, cb.data(), len);
+        widen(dut.data(), out_bytes, cdut.data(), len);
+        widen(ref.data(), out_bytes, cref.data(), len);
+        CheckInputs in = {ca.data(), cb.data(), cdut.data(), cref.data()};
+        value_failures += (long)checker.check_batch(mode, ErrorType::ULP, in, len, lane_err.data());
+        flag_failures += (long)checker.check_flags(mode, ca.data(), cb.data(), dut_flags.data(), ref_flags.data(), len);
+        for (size_t i = 0; i < len; ++i) {
+            failures += !lane_err[i].pass || dut_flags[i] != ref_flags[i];
+        }
+    }
+    uint64_t cycles = sim.cycles() - start_cycles;
+
+    printf("\n--- Replay %s + %s: %zu elements, %s ---\n", pair.a, pair.b, n, mode_name(mode));
+    printf("  %llu cycles (%.2f elements/cycle), %.3f s simulated, %.2f M elements/s\n",
+           (unsigned long long)cycles, cycles ? (double)n / cycles : 0.0, sim_seconds,
+           sim_seconds > 0 ? n / sim_seconds / 1e6 : 0.0);
+    printf("  %ld failing elements: %ld value, %ld fflags\n", failures, value_failures, flag_failures);
+    checker.report();
+    return failures;
+}
+
+long run_replay(Simulator& sim, const ResultChecker& tolerances, const std::vector<ReplayPair>& pairs,
+                bool has_mode, TestMode mode) {
+    long failures = 0;
+    for (const ReplayPair& pair : pairs) {
+        long f = replay_pair(sim, tolerances, pair, has_mode, mode);
+        if (f < 0) {
+            return -1;
+        }
+        failures += f;
+    }
+    return failures;
+}
@@ -0,0 +1,391 @@
+#include "include/result_checker.h"
+#include "include/fp_utils.h"
+#include "include/softfloat_ref.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+// ===================================================================
+//  Format helpers
+// ===================================================================
+
+FpFormat result_format(TestMode mode) {
+    switch (mode) {
+        case TestMode::FP16:
+        case TestMode::FP16_Narrow: return FpFormat::FP16;
+        case TestMode::BF16:
+        case TestMode::BF16_Narrow: return FpFormat::BF16;
+        default: return FpFormat::FP32;
+    }
+}
+
+FpFormat operand_format(TestMode mode) {
+    switch (mode) {
+        case TestMode::FP16:
+        case TestMode::FP16_Widen: return FpFormat::FP16;
+        case TestMode::BF16:
+        case TestMode::BF16_Widen: return FpFormat::BF16;
+        default: return FpFormat::FP32;
+    }
+}
+
+const char* mode_name(TestMode mode) {
+    switch (mode) {
+        case TestMode::FP32: return "FP32";
+        case TestMode::FP16: return "FP16";
+        case TestMode::BF16: return "BF16";
+        case TestMode::FP16_Widen: return "FP16_Widen";
+        case TestMode::BF16_Widen: return "BF16_Widen";
+        case TestMode::FP16_Narrow: return "FP16_Narrow";
+        case TestMode::BF16_Narrow: return "BF16_Narrow";
+    }
+    return "?";
+}
+
+int elems_per_op(TestMode mode) {
+    return mode == TestMode::FP16 || mode == TestMode::BF16 ? 2 : 1;
+}
+
+struct FmtInfo {
+    uint32_t sign;  // sign bit
+    uint32_t mag;   // magnitude mask
+    uint32_t inf;   // +Inf bit pattern
+};
+
+static FmtInfo fmt_info(FpFormat fmt) {
+    switch (fmt) {
+        case FpFormat::FP16: return {0x8000, 0x7fff, 0x7c00};
+        case FpFormat::BF16: return {0x8000, 0x7fff, 0x7f80};
+        default: return {0x80000000u, 0x7fffffffu, 0x7f800000u};
+    }
+}
+
+int32_t fp_ordered(uint32_t bits, FpFormat fmt) {
+    FmtInfo f = fmt_info(fmt);
+    int32_t mag = (int32_t)(bits & f.mag);
+    return (bits & f.sign) ? -mag : mag;
+}
+
+static inline uint32_t ulp_distance(uint32_t a, uint32_t b, const FmtInfo& f) {
+    uint32_t ma = a & f.mag, mb = b & f.mag;
+    bool nan_a = ma > f.inf, nan_b = mb > f.inf;
+    if (nan_a || nan_b) {
+        return (nan_a && nan_b) ? 0 : UINT32_MAX;
+    }
+    int32_t oa = (a & f.sign) ? -(int32_t)ma : (int32_t)ma;
+    int32_t ob = (b & f.sign) ? -(int32_t)mb : (int32_t)mb;
+    // 两端相距最多约2^32，用无符号差避免溢出
+    return oa > ob ? (uint32_t)oa - (uint32_t)ob : (uint32_t)ob - (uint32_t)oa;
+}
+
+uint32_t fp_ulp_distance(uint32_t a, uint32_t b, FpFormat fmt) {
+    return ulp_distance(a, b, fmt_info(fmt));
+}
+
+static void ulp_distance_batch_generic(const uint32_t* a, const uint32_t* b, uint32_t* ulp, size_t n,
+                                       const FmtInfo& f) {
+    for (size_t i = 0; i < n; ++i) {
+        ulp[i] = ulp_distance(a[i], b[i], f);
+    }
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define RESULT_CHECKER_X86_DISPATCH
+
+__attribute__((target("avx2")))
+static void ulp_distance_batch_avx2(const uint32_t* a, const uint32_t* b, uint32_t* ulp, size_t n,
+                                    const FmtInfo& f) {
+    const __m256i vsign = _mm256_set1_epi32((int)f.sign);
+    const __m256i vmag = _mm256_set1_epi32((int)f.mag);
+    const __m256i vinf = _mm256_set1_epi32((int)f.inf);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        __m256i ma = _mm256_and_si256(va, vmag);
+        __m256i mb = _mm256_and_si256(vb, vmag);
+        __m256i nan_a = _mm256_cmpgt_epi32(ma, vinf);
+        __m256i nan_b = _mm256_cmpgt_epi32(mb, vinf);
+        __m256i neg_a = _mm256_cmpeq_epi32(_mm256_and_si256(va, vsign), vsign);
+        __m256i neg_b = _mm256_cmpeq_epi32(_mm256_and_si256(vb, vsign), vsign);
+        __m256i oa = _mm256_blendv_epi8(ma, _mm256_sub_epi32(zero, ma), neg_a);
+        __m256i ob = _mm256_blendv_epi8(mb, _mm256_sub_epi32(zero, mb), neg_b);
+        __m256i d = _mm256_sub_epi32(_mm256_max_epi32(oa, ob), _mm256_min_epi32(oa, ob));
+        // NaN: both -> 0, one -> UINT32_MAX
+        __m256i nan_any = _mm256_or_si256(nan_a, nan_b);
+        __m256i nan_val = _mm256_andnot_si256(_mm256_and_si256(nan_a, nan_b), ones);
+        d = _mm256_blendv_epi8(d, nan_val, nan_any);
+        _mm256_storeu_si256((__m256i*)(ulp + i), d);
+    }
+    ulp_distance_batch_generic(a + i, b + i, ulp + i, n - i, f);
+}
+#endif
+
+typedef void (*UlpKernel)(const uint32_t*, const uint32_t*, uint32_t*, size_t, const FmtInfo&);
+
+static UlpKernel ulp_kernel() {
+    static const UlpKernel kernel = []() -> UlpKernel {
+#ifdef RESULT_CHECKER_X86_DISPATCH
+        if (!getenv("FP_UTILS_NO_SIMD")) {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return ulp_distance_batch_avx2;
+            }
+        }
+#endif
+        return ulp_distance_batch_generic;
+    }();
+    return kernel;
+}
+
+void fp_ulp_distance_batch(const uint32_t* a, const uint32_t* b, uint32_t* ulp, size_t n, FpFormat fmt) {
+    ulp_kernel()(a, b, ulp, n, fmt_info(fmt));
+}
+
+double fp_to_double(uint32_t bits, FpFormat fmt) {
+    switch (fmt) {
+        case FpFormat::FP16: return fp16_to_fp32((fp16_t)bits);
+        case FpFormat::BF16: return bf16_to_fp32((bf16_t)bits);
+        default: {
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            return f;
+        }
+    }
+}
+
+// ===================================================================
+//  Tolerances (defaults are the limits previously hard-coded in check_result)
+// ===================================================================
+
+Tolerance default_tolerance(TestMode mode) {
+    switch (mode) {
+        case TestMode::FP32: return {8, 1e-5, 1e-3, std::ldexp(1.0, -60)};
+        case TestMode::FP16:
+        case TestMode::FP16_Narrow: return {5, 1e-3, 1e-2, std::ldexp(1.0, -10)};
+        case TestMode::BF16:
+        case TestMode::BF16_Narrow: return {2, 8e-3, 1e-2, std::ldexp(1.0, -30)};
+        default: return {2, 1e-5, 1e-3, std::ldexp(1.0, -60)}; // widen: FP32 result
+    }
+}
+
+// ===================================================================
+//  ErrorStats
+// ===================================================================
+
+static int ulp_bin(uint32_t ulp) {
+    return ulp == 0 ? 0 : 32 - __builtin_clz(ulp);
+}
+
+static int rel_bin(double rel) {
+    if (rel == 0) return 0;
+    if (!(rel < 1)) return ErrorStats::kRelBins - 1; // >= 1, Inf, NaN
+    int decade = (int)std::floor(std::log10(rel));  // -1, -2, ...
+    return std::max(1, decade + ErrorStats::kRelBins - 1);
+}
+
+void ErrorStats::add(uint32_t a, uint32_t b, uint32_t dut, uint32_t ref, uint32_t ulp, double rel, bool pass) {
+    ErrorWitness w = {a, b, dut, ref, ulp, rel};
+    if (!has_witness) {
+        max_ulp = max_rel = w;
+        has_witness = true;
+    } else {
+        if (ulp > max_ulp.ulp) max_ulp = w;
+        if (rel > max_rel.rel) max_rel = w;
+    }
+    if (!pass && failures == 0) {
+        first_failure = w;
+    }
+    count++;
+    failures += !pass;
+    exact += (dut == ref);
+    ulp_hist[ulp_bin(ulp)]++;
+    rel_hist[rel_bin(rel)]++;
+}
+
+void ErrorStats::add_flags(uint32_t a, uint32_t b, uint8_t dut, uint8_t ref) {
+    if (dut != ref && flag_failures == 0) {
+        first_flag_failure = {a, b, dut, ref};
+    }
+    flag_count++;
+    flag_failures += dut != ref;
+    for (int i = 0; i < 5; ++i) {
+        bool d = dut >> i & 1, r = ref >> i & 1;
+        flag_raised[i] += r;
+        flag_missed[i] += r && !d;
+        flag_spurious[i] += d && !r;
+    }
+}
+
+void ErrorStats::merge(const ErrorStats& other) {
+    if (flag_failures == 0 && other.flag_failures != 0) {
+        first_flag_failure = other.first_flag_failure;
+    }
+    flag_count += other.flag_count;
+    flag_failures += other.flag_failures;
+    for (int i = 0; i < 5; ++i) {
+        flag_raised[i] += other.flag_raised[i];
+        flag_missed[i] += other.flag_missed[i];
+        flag_spurious[i] += other.flag_spurious[i];
+    }
+    if (other.count == 0) return;
+    if (!has_witness) {
+        max_ulp = other.max_ulp;
+        max_rel = other.max_rel;
+        has_witness = true;
+    } else {
+        if (other.max_ulp.ulp > max_ulp.ulp) max_ulp = other.max_ulp;
+        if (other.max_rel.rel > max_rel.rel) max_rel = other.max_rel;
+    }
+    if (failures == 0 && other.failures != 0) {
+        first_failure = other.first_failure;
+    }
+    count += other.count;
+    failures += other.failures;
+    exact += other.exact;
+    for (int i = 0; i < kUlpBins; ++i) ulp_hist[i] += other.ulp_hist[i];
+    for (int i = 0; i < kRelBins; ++i) rel_hist[i] += other.rel_hist[i];
+}
+
+static void print_witness(const char* label, const ErrorWitness& w) {
+    printf("  %-14s a=0x%08X b=0x%08X dut=0x%08X ref=0x%08X ulp=%u rel=%.3e\n",
+           label, w.a, w.b, w.dut, w.ref, w.ulp, w.rel);
+}
+
+void ErrorStats::print(const char* name) const {
+    printf("[%s] %llu results, %llu exact, %llu failed\n", name, (unsigned long long)count,
+           (unsigned long long)exact, (unsigned long long)failures);
+    printf("  ULP histogram:\n");
+    for (int i = 0; i < kUlpBins; ++i) {
+        if (!ulp_hist[i]) continue;
+        if (i <= 1) {
+            printf("    %-22u %14llu\n", (unsigned)i, (unsigned long long)ulp_hist[i]);
+        } else {
+            char range[32];
+            snprintf(range, sizeof(range), "[%u, %u]", 1u << (i - 1), (uint32_t)((1ull << i) - 1));
+            printf("    %-22s %14llu\n", range, (unsigned long long)ulp_hist[i]);
+        }
+    }
+    printf("  Relative error histogram:\n");
+    for (int i = 0; i < kRelBins; ++i) {
+        if (!rel_hist[i]) continue;
+        char range[32];
+        if (i == 0) snprintf(range, sizeof(range), "0");
+        else if (i == 1) snprintf(range, sizeof(range), "< %g", std::pow(10.0, 3 - kRelBins));
+        else if (i == kRelBins - 1) snprintf(range, sizeof(range), ">= 1");
+        else snprintf(range, sizeof(range), "[%g, %g)", std::pow(10.0, i + 1 - kRelBins), std::pow(10.0, i + 2 - kRelBins));
+        printf("    %-22s %14llu\n", range, (unsigned long long)rel_hist[i]);
+    }
+    if (has_witness) {
+        print_witness("max ulp:", max_ulp);
+        print_witness("max rel:", max_rel);
+    }
+    if (failures) {
+        print_witness("first failure:", first_failure);
+    }
+    if (flag_count) {
+        static const char* kNames[] = {"NX", "UF", "OF", "DZ", "NV"};
+        printf("  fflags: %llu checked, %llu mismatched\n", (unsigned long long)flag_count,
+               (unsigned long long)flag_failures);
+        for (int i = 4; i >= 0; --i) {
+            if (!flag_raised[i] && !flag_missed[i] && !flag_spurious[i]) continue;
+            printf("    %-4s raised %12llu  missed %10llu  spurious %10llu\n", kNames[i],
+                   (unsigned long long)flag_raised[i], (unsigned long long)flag_missed[i],
+                   (unsigned long long)flag_spurious[i]);
+        }
+        if (flag_failures) {
+            char d[16], r[16];
+            printf("  %-14s a=0x%08X b=0x%08X dut=%s ref=%s\n", "first fflags:", first_flag_failure.a,
+                   first_flag_failure.b, fflags_str(first_flag_failure.dut, d), fflags_str(first_flag_failure.ref, r));
+        }
+    }
+}
+
+// ===================================================================
+//  ResultChecker
+// ===================================================================
+
+ResultChecker::ResultChecker() {
+    for (int i = 0; i < kNumTestModes; ++i) {
+        tol_[i] = default_tolerance((TestMode)i);
+    }
+}
+
+size_t ResultChecker::check_batch(TestMode mode, ErrorType error_type, const CheckInputs& in, size_t n,
+                                  LaneError* err) {
+    const FpFormat rfmt = result_format(mode);
+    const FpFormat ofmt = operand_format(mode);
+    const FmtInfo rinfo = fmt_info(rfmt);
+    const Tolerance& tol = tol_[(int)mode];
+    ErrorStats& stats = stats_[(int)mode];
+
+    const size_t kChunk = 256;
+    uint32_t ulp[kChunk];
+    size_t failures = 0;
+    for (size_t base = 0; base < n; base += kChunk) {
+        size_t len = std::min(kChunk, n - base);
+        fp_ulp_distance_batch(in.dut + base, in.ref + base, ulp, len, rfmt);
+        for (size_t k = 0; k < len; ++k) {
+            size_t i = base + k;
+            uint32_t dut = in.dut[i], ref = in.ref[i];
+            bool exact = (dut == ref);
+            bool both_zero = ((dut & rinfo.mag) == 0) && ((ref & rinfo.mag) == 0);
+
+            double scale = std::max(std::fabs(fp_to_double(in.a[i], ofmt)), std::fabs(fp_to_double(in.b[i], ofmt)));
+            double diff = std::fabs(fp_to_double(dut, rfmt) - fp_to_double(ref, rfmt));
+            double rel = exact ? 0.0 : diff / scale; // Inf/NaN when the result or the scale is degenerate
+
+            bool ulp_pass = ulp[k] <= tol.max_ulp || both_zero;
+            bool rel_pass = rel < (scale < tol.tiny_scale ? tol.max_rel_tiny : tol.max_rel) || exact || both_zero;
+            bool pass = false;
+            switch (error_type) {
+                case ErrorType::Precise: pass = exact || both_zero; break;
+                case ErrorType::ULP: pass = ulp_pass; break;
+                case ErrorType::RelativeError: pass = rel_pass; break;
+                case ErrorType::ULP_or_RelativeError: pass = ulp_pass || rel_pass; break;
+            }
+
+            stats.add(in.a[i], in.b[i], dut, ref, ulp[k], rel, pass);
+            failures += !pass;
+            if (err) {
+                err[i] = {ulp[k], rel, pass};
+            }
+        }
+    }
+    return failures;
+}
+
+size_t ResultChecker::check_flags(TestMode mode, const uint32_t* a, const uint32_t* b, const uint8_t* dut,
+                                  const uint8_t* ref, size_t n) {
+    ErrorStats& stats = stats_[(int)mode];
+    size_t failures = 0;
+    for (size_t i = 0; i < n; ++i) {
+        stats.add_flags(a[i], b[i], dut[i], ref[i]);
+        failures += dut[i] != ref[i];
+    }
+    return failures;
+}
+
+uint64_t ResultChecker::total_failures() const {
+    uint64_t n = 0;
+    for (int i = 0; i < kNumTestModes; ++i) n += stats_[i].failures + stats_[i].flag_failures;
+    return n;
+}
+
+void ResultChecker::report() const {
+    printf("\n================ Accuracy report ================\n");
+    for (int i = 0; i < kNumTestModes; ++i) {
+        if (stats_[i].count) {
+            stats_[i].print(mode_name((TestMode)i));
+        }
+    }
+    printf("=================================================\n");
+}
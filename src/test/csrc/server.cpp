@@ -0,0 +1,154 @@
+#include "include/server.h"
+#include "include/simulator.h"
+#include "include/softfloat_ref.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// SoftFloat keeps its rounding mode and flags in globals
+static std::mutex g_softfloat_mutex;
+
+static bool read_full(int fd, void* buf, size_t len) {
+    uint8_t* p = (uint8_t*)buf;
+    while (len) {
+        ssize_t r = read(fd, p, len);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        len -= (size_t)r;
+    }
+    return true;
+}
+
+static bool write_full(int fd, const void* buf, size_t len) {
+    const uint8_t* p = (const uint8_t*)buf;
+    while (len) {
+        ssize_t r = write(fd, p, len);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        len -= (size_t)r;
+    }
+    return true;
+}
+
+// 处理一个连接上的全部请求, 直到EOF或协议错误
+static void serve_stream(Simulator& sim, int in_fd, int out_fd) {
+    std::vector<uint8_t> a, b, out, ref, dut_flags, ref_flags;
+    for (;;) {
+        ServerRequest req;
+        if (!read_full(in_fd, &req, sizeof(req))) {
+            return;
+        }
+        ServerResponse resp = {kServerMagic, 0, 0, 0};
+        if (req.magic != kServerMagic || req.mode > (uint32_t)TestMode::BF16_Narrow || req.n > kServerMaxBatch) {
+            resp.status = -1;
+            write_full(out_fd, &resp, sizeof(resp));
+            return;
+        }
+
+        TestMode mode = (TestMode)req.mode;
+        const bool narrow = mode == TestMode::FP16_Narrow || mode == TestMode::BF16_Narrow;
+        size_t in_bytes = (size_t)req.n * (mode == TestMode::FP32 || narrow ? 4 : 2);
+        size_t out_bytes = (size_t)req.n * (mode == TestMode::FP16 || mode == TestMode::BF16 || narrow ? 2 : 4);
+        const bool want_ref = req.flags & kServerWantRef;
+        const bool want_flags = req.flags & kServerWantFlags;
+        a.resize(in_bytes);
+        b.resize(in_bytes);
+        out.resize(out_bytes);
+        dut_flags.resize(want_flags ? req.n : 0);
+        if (!read_full(in_fd, a.data(), in_bytes) || !read_full(in_fd, b.data(), in_bytes)) {
+            return;
+        }
+
+        resp.n = req.n;
+        resp.status = sim.run_stream(mode, a.data(), b.data(), out.data(), req.n,
+                                     want_flags ? dut_flags.data() : nullptr) == req.n ? 0 : -2;
+        if (want_ref || want_flags) {
+            ref.resize(out_bytes);
+            ref_flags.resize(want_flags ? req.n : 0);
+            std::lock_guard<std::mutex> lock(g_softfloat_mutex);
+            softfloat_add_stream(mode, a.data(), b.data(), ref.data(), req.n, want_flags ? ref_flags.data() : nullptr);
+        }
+        resp.flags = req.flags & (kServerWantRef | kServerWantFlags);
+
+        if (!write_full(out_fd, &resp, sizeof(resp)) || !write_full(out_fd, out.data(), out_bytes)) {
+            return;
+        }
+        if (want_ref && !write_full(out_fd, ref.data(), out_bytes)) {
+            return;
+        }
+        if (want_flags && (!write_full(out_fd, dut_flags.data(), req.n) || !write_full(out_fd, ref_flags.data(), req.n))) {
+            return;
+        }
+    }
+}
+
+static void socket_worker(int listen_fd) {
+    Simulator sim(0, nullptr, false); // no VCD: workers would share build/vfpu/top.vcd
+    sim.set_verbose(false);
+    for (;;) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            perror("accept");
+            return;
+        }
+        serve_stream(sim, fd, fd);
+        close(fd);
+    }
+}
+
+int run_server(const char* path, int models) {
+    // A client that disconnects mid-batch must only end its connection (write -> EPIPE), not the server
+    signal(SIGPIPE, SIG_IGN);
+    if (!strcmp(path, "-")) {
+        // stdin/stdout: 日志只能写stderr
+        Simulator sim(0, nullptr, false);
+        sim.set_verbose(false);
+        serve_stream(sim, STDIN_FILENO, STDOUT_FILENO);
+        return 0;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    unlink(path);
+    if (bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, 2 * models) < 0) {
+        perror(path);
+        close(listen_fd);
+        return 1;
+    }
+
+    printf("Serving on %s with %d model(s)\n", path, models);
+    fflush(stdout);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < models; ++i) {
+        workers.emplace_back(socket_worker, listen_fd);
+    }
+    for (auto& t : workers) {
+        t.join();
+    }
+    close(listen_fd);
+    return 1;
+}
@@ -1,5 +1,6 @@
 // sim_c/sim.cc
 #include "include/simulator.h"
+#include "include/profiler.h"
 #include <verilated.h>
 #include "Vtop.h"
 #ifdef VCD
@@ -15,13 +16,19 @@ using namespace std;
 // Simulator 类实现
 // ===================================================================
 
-Simulator::Simulator(int argc, char* argv[]) {
+Simulator::Simulator(int argc, char* argv[], bool trace) {
     contextp_ = make_unique<VerilatedContext>();
-    contextp_->commandArgs(argc, argv);
+    if (argc > 0) {
+        contextp_->commandArgs(argc, argv);
+    }
     top_ = make_unique<Vtop>(contextp_.get());
 
 #ifdef VCD
-    init_vcd();
+    if (trace) {
+        init_vcd();
+    }
+#else
+    (void)trace;
 #endif
 }
 
@@ -44,85 +51,124 @@ void Simulator::init_vcd() {
 
 void Simulator::single_cycle() {
     top_->clock = 0;
-    top_->eval();
+    {
+        PROF_SCOPE(ProfPhase::Eval);
+        top_->eval();
+    }
 #ifdef VCD
     if (tfp_) {
+        PROF_SCOPE(ProfPhase::Trace);
         tfp_->dump(contextp_->time());
     }
 #endif
     contextp_->timeInc(1);
 
     top_->clock = 1;
-    top_->eval();
+    {
+        PROF_SCOPE(ProfPhase::Eval);
+        top_->eval();
+    }
 #ifdef VCD
     if (tfp_) {
+        PROF_SCOPE(ProfPhase::Trace);
         tfp_->dump(contextp_->time());
     }
 #endif
     contextp_->timeInc(1);
 }
 
+uint64_t Simulator::cycles() const {
+    return contextp_->time() / 2; // 每周期两个时间单位
+}
+
 void Simulator::reset(int n) {
     top_->reset = 1;
     for (int i = 0; i < n; i++) {
         single_cycle();
     }
     top_->reset = 0;
+    PROF_SCOPE(ProfPhase::Eval);
     top_->eval();
 }
 
-bool Simulator::run_test(const TestCase& test) {
-    test.print_details();
+void Simulator::set_mode(TestMode mode) {
+    top_->io_is_fp32  = mode == TestMode::FP32;
+    top_->io_is_fp16  = mode == TestMode::FP16 || mode == TestMode::FP16_Widen || mode == TestMode::FP16_Narrow;
+    top_->io_is_bf16  = mode == TestMode::BF16 || mode == TestMode::BF16_Widen || mode == TestMode::BF16_Narrow;
+    top_->io_is_widen = mode == TestMode::FP16_Widen || mode == TestMode::BF16_Widen;
+    top_->io_is_narrow = mode == TestMode::FP16_Narrow || mode == TestMode::BF16_Narrow;
+    top_->io_a_already_widen = 0; // 新增信号连接，设为0
+}
 
-    // -- 执行仿真 --
-    // 复位DUT
-    reset(2);
+// 根据模式设置数据输入端口
+//   FP32:     a0/b0 (32位)
+//   FP16/BF16: 双路, a0/b0 -> lane 0, a1/b1 -> lane 1
+//   Widen:    a0/b0 为16位操作数, 放在高半部分 (lane 1)
+//   Narrow:   a0/b0 (32位), 结果在 res_out_16_1
+void Simulator::poke_operands(TestMode mode, uint32_t a0, uint32_t b0, uint32_t a1, uint32_t b1) {
+    switch(mode) {
+        case TestMode::FP32:
+        case TestMode::FP16_Narrow:
+        case TestMode::BF16_Narrow:
+            top_->io_a_in_32 = a0;
+            top_->io_b_in_32 = b0;
+            break;
+        case TestMode::FP16:
+        case TestMode::BF16:
+            // 注意：Verilator会把 a_in_16: Vec(2, UInt(16.W)) 转换成 io_a_in_16_0, io_a_in_16_1
+            top_->io_a_in_16_0 = a0;
+            top_->io_b_in_16_0 = b0;
+            top_->io_a_in_16_1 = a1;
+            top_->io_b_in_16_1 = b1;
+            break;
+        case TestMode::FP16_Widen:
+        case TestMode::BF16_Widen:
+            top_->io_a_in_16_0 = 0;
+            top_->io_a_in_16_1 = a0;
+            top_->io_b_in_16_0 = 0;
+            top_->io_b_in_16_1 = b0;
+            break;
+    }
+}
 
+void Simulator::poke_inputs(const TestCase& test) {
+    PROF_SCOPE(ProfPhase::Poke);
     // 1. 设置控制信号和数据输入
     top_->io_valid_in = 1;
-    top_->io_is_fp32  = test.is_fp32;
-    top_->io_is_fp16  = test.is_fp16;
-    top_->io_is_bf16  = test.is_bf16;
-    top_->io_is_widen = test.is_widen;
-    top_->io_a_already_widen = 0; // 新增信号连接，设为0
+    set_mode(test.mode);
 
     // 2. 根据模式设置数据输入端口
     switch(test.mode) {
         case TestMode::FP32:
-            top_->io_a_in_32 = test.a_fp32_bits;
-            top_->io_b_in_32 = test.b_fp32_bits;
+        case TestMode::FP16_Narrow:
+        case TestMode::BF16_Narrow:
+            poke_operands(test.mode, test.a_fp32_bits, test.b_fp32_bits, 0, 0);
             break;
         case TestMode::FP16:
-            // 注意：Verilator会把 a_in_16: Vec(2, UInt(16.W)) 转换成 io_a_in_16_0, io_a_in_16_1
-            top_->io_a_in_16_0 = test.a1_fp16_bits;
-            top_->io_b_in_16_0 = test.b1_fp16_bits;
-            top_->io_a_in_16_1 = test.a2_fp16_bits;
-            top_->io_b_in_16_1 = test.b2_fp16_bits;
+            poke_operands(test.mode, test.a1_fp16_bits, test.b1_fp16_bits, test.a2_fp16_bits, test.b2_fp16_bits);
             break;
         case TestMode::BF16:
-            // BF16也使用16位端口
-            top_->io_a_in_16_0 = test.a1_bf16_bits;
-            top_->io_b_in_16_0 = test.b1_bf16_bits;
-            top_->io_a_in_16_1 = test.a2_bf16_bits;
-            top_->io_b_in_16_1 = test.b2_bf16_bits;
+            poke_operands(test.mode, test.a1_bf16_bits, test.b1_bf16_bits, test.a2_bf16_bits, test.b2_bf16_bits);
             break;
         case TestMode::FP16_Widen:
-            // FP16 Widen: a,b是FP16, result是FP32
-            // 在test_case中，a,b的fp16值被存在了a_fp32_bits和b_fp32_bits的高16位中
-            top_->io_a_in_16_0 = 0;
-            top_->io_a_in_16_1 = (test.a_fp32_bits >> 16) & 0xFFFF;
-            top_->io_b_in_16_0 = 0;
-            top_->io_b_in_16_1 = (test.b_fp32_bits >> 16) & 0xFFFF;
-            break;
         case TestMode::BF16_Widen:
-            // BF16 Widen: a,b是BF16, result是FP32
-            // 在test_case中，a,b的bf16值被存在了a_fp32_bits和b_fp32_bits的高16位中
-            top_->io_a_in_16_0 = 0;
-            top_->io_a_in_16_1 = (test.a_fp32_bits >> 16) & 0xFFFF;
-            top_->io_b_in_16_0 = 0;
-            top_->io_b_in_16_1 = (test.b_fp32_bits >> 16) & 0xFFFF;
+            // 在test_case中，a,b的16位值被存在了a_fp32_bits和b_fp32_bits的高16位中
+            poke_operands(test.mode, test.a_fp32_bits >> 16, test.b_fp32_bits >> 16, 0, 0);
             break;
     }
+}
+
+bool Simulator::run_test(const TestCase& test, ResultChecker& checker) {
+    if (verbose_) {
+        PROF_SCOPE(ProfPhase::Print);
+        test.print_details();
+    }
+
+    // -- 执行仿真 --
+    // 复位DUT
+    reset(2);
+
+    poke_inputs(test);
 
     // 输入有效，等待一个周期，让DUT接收数据
     single_cycle();
@@ -142,7 +188,14 @@ bool Simulator::run_test(const TestCase& test) {
         dut_res.res_out_32 = top_->io_res_out_32;
         dut_res.res_out_16_0 = top_->io_res_out_16_0;
         dut_res.res_out_16_1 = top_->io_res_out_16_1;
-        bool result = test.check_result(dut_res);
+        dut_res.fflags_0 = top_->io_fflags_out_0;
+        dut_res.fflags_1 = top_->io_fflags_out_1;
+        bool result;
+        {
+            PROF_SCOPE(ProfPhase::Check);
+            result = test.check_result(dut_res, checker, verbose_);
+        }
+        PROF_ADD_VECTORS(elems_per_op(test.mode));
         
         // 如果测试失败，多跑一个周期来记录更多波形信息
         if (!result) {
@@ -155,4 +208,85 @@ bool Simulator::run_test(const TestCase& test) {
         printf("Timeout waiting for valid_out\n");
         return false;
     }
-}
\ No newline at end of file
+}
+// ===================================================================
+// 流水线深度: 单个操作, 数 valid_in 之后到 valid_out 的周期数
+// ===================================================================
+int Simulator::measure_latency(TestMode mode) {
+    reset(2);
+    set_mode(mode);
+    poke_operands(mode, 0, 0, 0, 0);
+    top_->io_valid_in = 1;
+    single_cycle();
+    top_->io_valid_in = 0;
+    for (int latency = 1; latency <= 100; ++latency) {
+        if (top_->io_valid_out) {
+            return latency;
+        }
+        single_cycle();
+    }
+    return -1;
+}
+
+int Simulator::expected_latency() const {
+    return (int)top_->io_fadd_delay - (int)top_->io_delay_bias;
+}
+
+// ===================================================================
+// 流式执行: 每周期送入一组操作数 (FP16/BF16为两个元素), 按序收集结果
+// 直接读写调用者的缓冲区, 不构造TestCase
+// ===================================================================
+size_t Simulator::run_stream(TestMode mode, const void* a, const void* b, void* out, size_t n, uint8_t* flags) {
+    const bool in16 = operand_format(mode) != FpFormat::FP32;
+    const bool narrow = mode == TestMode::FP16_Narrow || mode == TestMode::BF16_Narrow;
+    const size_t per_cycle = elems_per_op(mode);
+
+    auto load = [in16](const void* p, size_t i, size_t n) -> uint32_t {
+        if (i >= n) return 0; // 奇数长度时补0
+        return in16 ? ((const uint16_t*)p)[i] : ((const uint32_t*)p)[i];
+    };
+
+    reset(2);
+    set_mode(mode);
+
+    size_t issued = 0, done = 0;
+    int idle = 0;
+    while (done < n) {
+        {
+            PROF_SCOPE(ProfPhase::Poke);
+            if (issued < n) {
+                poke_operands(mode, load(a, issued, n), load(b, issued, n),
+                              load(a, issued + 1, n), load(b, issued + 1, n));
+                top_->io_valid_in = 1;
+                issued += per_cycle;
+            } else {
+                top_->io_valid_in = 0;
+            }
+        }
+        single_cycle();
+
+        if (top_->io_valid_out) {
+            idle = 0;
+            if (per_cycle == 2) {
+                uint16_t* o = (uint16_t*)out;
+                o[done] = top_->io_res_out_16_0;
+                if (done + 1 < n) o[done + 1] = top_->io_res_out_16_1;
+            } else if (narrow) {
+                ((uint16_t*)out)[done] = top_->io_res_out_16_1;
+            } else {
+                ((uint32_t*)out)[done] = top_->io_res_out_32;
+            }
+            if (flags) {
+                flags[done] = narrow ? top_->io_fflags_out_1 : top_->io_fflags_out_0;
+                if (per_cycle == 2 && done + 1 < n) flags[done + 1] = top_->io_fflags_out_1;
+            }
+            done += per_cycle;
+        } else if (++idle > 100) {
+            fprintf(stderr, "Timeout waiting for valid_out (%zu of %zu results)\n", done, n);
+            break;
+        }
+    }
+    top_->io_valid_in = 0;
+    PROF_ADD_VECTORS(done < n ? done : n);
+    return done < n ? done : n;
+}
@@ -1,5 +1,8 @@
 #include "include/softfloat_ref.h"
 #include "include/fp_utils.h"
+#include "include/profiler.h"
+#include <algorithm>
+#include <cmath>
 #include <cstring> // For memcpy
 
 extern "C" {
@@ -26,11 +29,24 @@ static inline uint16_t from_float16_t(float16_t f) {
     return f.v;
 }
 
+// Helper to convert uint64_t to float64_t
+static inline float64_t to_float64_t(uint64_t bits) {
+    float64_t f;
+    f.v = bits;
+    return f;
+}
+
+// Helper to convert float64_t to uint64_t
+static inline uint64_t from_float64_t(float64_t f) {
+    return f.v;
+}
+
 // ===================================================================
 //  SoftFloat based reference functions
 // ===================================================================
 
 uint32_t softfloat_add_fp32(uint32_t a, uint32_t b) {
+    PROF_SCOPE(ProfPhase::Ref);
     // Set rounding mode to Round-to-Nearest-Even (default)
     softfloat_roundingMode = softfloat_round_near_even;
     
@@ -43,6 +59,7 @@ uint32_t softfloat_add_fp32(uint32_t a, uint32_t b) {
 }
 
 uint16_t softfloat_add_fp16(uint16_t a, uint16_t b) {
+    PROF_SCOPE(ProfPhase::Ref);
     // Set rounding mode
     softfloat_roundingMode = softfloat_round_near_even;
     
@@ -57,6 +74,7 @@ uint16_t softfloat_add_fp16(uint16_t a, uint16_t b) {
 // For BFloat16, we leverage the existing conversion functions in `fp_utils.h`
 // to bridge between standard types and SoftFloat types.
 uint16_t softfloat_add_bf16(uint16_t a, uint16_t b) {
+    PROF_SCOPE(ProfPhase::Ref);
     // Set rounding mode
     softfloat_roundingMode = softfloat_round_near_even;
 
@@ -85,4 +103,191 @@ uint16_t softfloat_add_bf16(uint16_t a, uint16_t b) {
 
     // 7. Convert the float result back to BF16 (uint16_t) using fp_utils
     return fp32_to_bf16(float_result);
-} 
\ No newline at end of file
+} 
+
+// ===================================================================
+//  Narrowing: FP32 a + b rounded once to FP16 / BF16
+// ===================================================================
+
+// a + b in FP64 rounded to odd (truncate, then set the LSB if inexact). The sum of two FP32 values
+// is not always exact in FP64, but rounded to odd it still rounds correctly to any format with at
+// most 51 significant bits, FP16 and BF16 included. Returns the FP64 bits; *nv gets the NV flag
+// of the add (sNaN operand, Inf - Inf).
+static float64_t fp32_add_round_odd(uint32_t a, uint32_t b, uint8_t* nv) {
+    softfloat_roundingMode = softfloat_round_minMag;
+    softfloat_exceptionFlags = 0;
+    float64_t sum = f64_add(f32_to_f64(to_float32_t(a)), f32_to_f64(to_float32_t(b)));
+    softfloat_roundingMode = softfloat_round_near_even;
+    bool is_nan = (sum.v >> 52 & 0x7ff) == 0x7ff && (sum.v & 0xfffffffffffffull);
+    if ((softfloat_exceptionFlags & softfloat_flag_inexact) && !is_nan) sum.v |= 1;
+    *nv = softfloat_exceptionFlags & softfloat_flag_invalid;
+    softfloat_exceptionFlags = 0;
+    return sum;
+}
+
+// Rounds an FP64 value to BF16 (RNE); flags gets NX/OF/UF of that step
+static uint16_t bf16_round(double x, uint8_t& flags) {
+    flags = 0;
+    if (std::isnan(x)) return 0x7fc0;
+    float f = (float)x; // exact for 0 and Inf
+    uint32_t bits;
+    if (!std::isinf(x) && x != 0.0) {
+        // Quantum: 8 significant bits, subnormal spacing 2^-133
+        int e = std::ilogb(x);
+        double q = std::ldexp(1.0, std::max(e - 7, -133));
+        double m = x / q;
+        double r = std::nearbyint(m); // RNE in the default FP environment
+        flags = r != m ? kFlagNX : 0;
+        double y = r * q;
+        if (std::fabs(y) >= std::ldexp(1.0, 128)) {
+            flags |= kFlagOF | kFlagNX;
+            y = std::copysign(INFINITY, x);
+        } else if ((flags & kFlagNX) &&
+                   std::fabs(std::ldexp(std::nearbyint(std::ldexp(x, 7 - e)), e - 7)) < std::ldexp(1.0, -126)) {
+            // Tininess after rounding, as in RISC-V: x rounded at 2^(e-7), i.e. to 8 bits with an unbounded
+            // exponent (no 2^-133 clamp), is still below 2^-126 -- SoftFloat's sig + roundIncrement < 0x8000
+            flags |= kFlagUF;
+        }
+        f = (float)y; // exact: at most 8 significant bits within the FP32 range
+    }
+    memcpy(&bits, &f, sizeof(bits));
+    return bits >> 16;
+}
+
+uint16_t softfloat_add_fp32_to_fp16(uint32_t a, uint32_t b) {
+    PROF_SCOPE(ProfPhase::Ref);
+    uint8_t nv;
+    float64_t sum = fp32_add_round_odd(a, b, &nv);
+    return from_float16_t(f64_to_f16(sum));
+}
+
+uint16_t softfloat_add_fp32_to_bf16(uint32_t a, uint32_t b) {
+    PROF_SCOPE(ProfPhase::Ref);
+    uint8_t nv, flags;
+    float64_t sum = fp32_add_round_odd(a, b, &nv);
+    double x;
+    memcpy(&x, &sum.v, sizeof(x));
+    return bf16_round(x, flags);
+}
+
+uint32_t softfloat_fma_fp32(uint32_t a, uint32_t b, uint32_t c) {
+    PROF_SCOPE(ProfPhase::Ref);
+    softfloat_roundingMode = softfloat_round_near_even;
+    return from_float32_t(f32_mulAdd(to_float32_t(a), to_float32_t(b), to_float32_t(c)));
+}
+
+uint64_t softfloat_add_fp64(uint64_t a, uint64_t b, uint8_t* flags) {
+    PROF_SCOPE(ProfPhase::Ref);
+    softfloat_roundingMode = softfloat_round_near_even;
+    softfloat_detectTininess = softfloat_tininess_afterRounding;
+    softfloat_exceptionFlags = 0;
+    float64_t result = f64_add(to_float64_t(a), to_float64_t(b));
+    if (flags) *flags = softfloat_exceptionFlags;
+    return from_float64_t(result);
+}
+
+// ===================================================================
+//  Exception flags (fflags)
+// ===================================================================
+
+// Flags of rounding an FP64 value to BF16 (RNE)
+static uint8_t bf16_round_flags(double x) {
+    uint8_t flags;
+    bf16_round(x, flags);
+    return flags;
+}
+
+uint8_t softfloat_add_flags(TestMode mode, uint32_t a, uint32_t b) {
+    PROF_SCOPE(ProfPhase::Ref);
+    softfloat_roundingMode = softfloat_round_near_even;
+    softfloat_detectTininess = softfloat_tininess_afterRounding;
+    softfloat_exceptionFlags = 0;
+    switch (mode) {
+        case TestMode::FP32:
+            f32_add(to_float32_t(a), to_float32_t(b));
+            break;
+        case TestMode::FP16:
+            f16_add(to_float16_t(a), to_float16_t(b));
+            break;
+        case TestMode::BF16: {
+            // The sum of two BF16 values is exact in FP64 unless the exponents are so far apart that only NX matters
+            float64_t sum = f64_add(f32_to_f64(to_float32_t(a << 16)), f32_to_f64(to_float32_t(b << 16)));
+            double x;
+            memcpy(&x, &sum.v, sizeof(x));
+            return softfloat_exceptionFlags | bf16_round_flags(x);
+        }
+        case TestMode::FP16_Widen:
+            f32_add(f16_to_f32(to_float16_t(a)), f16_to_f32(to_float16_t(b)));
+            break;
+        case TestMode::BF16_Widen:
+            f32_add(to_float32_t(a << 16), to_float32_t(b << 16));
+            break;
+        case TestMode::FP16_Narrow: {
+            uint8_t nv;
+            float64_t sum = fp32_add_round_odd(a, b, &nv);
+            f64_to_f16(sum);
+            return softfloat_exceptionFlags | nv;
+        }
+        case TestMode::BF16_Narrow: {
+            uint8_t nv;
+            float64_t sum = fp32_add_round_odd(a, b, &nv);
+            double x;
+            memcpy(&x, &sum.v, sizeof(x));
+            return nv | bf16_round_flags(x);
+        }
+    }
+    return softfloat_exceptionFlags;
+}
+
+const char* fflags_str(uint8_t flags, char buf[16]) {
+    static const char* kNames[] = {"NX", "UF", "OF", "DZ", "NV"};
+    buf[0] = 0;
+    for (int i = 4; i >= 0; --i) {
+        if (!(flags >> i & 1)) continue;
+        if (buf[0]) strcat(buf, "|");
+        strcat(buf, kNames[i]);
+    }
+    if (!buf[0]) strcpy(buf, "-");
+    return buf;
+}
+
+void softfloat_add_stream(TestMode mode, const void* a, const void* b, void* out, size_t n, uint8_t* flags) {
+    const uint16_t* a16 = (const uint16_t*)a;
+    const uint16_t* b16 = (const uint16_t*)b;
+    const bool in32 = mode == TestMode::FP32 || mode == TestMode::FP16_Narrow || mode == TestMode::BF16_Narrow;
+    if (flags) {
+        for (size_t i = 0; i < n; ++i) {
+            flags[i] = in32 ? softfloat_add_flags(mode, ((const uint32_t*)a)[i], ((const uint32_t*)b)[i])
+                            : softfloat_add_flags(mode, a16[i], b16[i]);
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        switch (mode) {
+            case TestMode::FP32:
+                ((uint32_t*)out)[i] = softfloat_add_fp32(((const uint32_t*)a)[i], ((const uint32_t*)b)[i]);
+                break;
+            case TestMode::FP16:
+                ((uint16_t*)out)[i] = softfloat_add_fp16(a16[i], b16[i]);
+                break;
+            case TestMode::BF16:
+                ((uint16_t*)out)[i] = softfloat_add_bf16(a16[i], b16[i]);
+                break;
+            case TestMode::FP16_Widen:
+            case TestMode::BF16_Widen: {
+                float fa = mode == TestMode::FP16_Widen ? fp16_to_fp32(a16[i]) : bf16_to_fp32(a16[i]);
+                float fb = mode == TestMode::FP16_Widen ? fp16_to_fp32(b16[i]) : bf16_to_fp32(b16[i]);
+                uint32_t ua, ub;
+                memcpy(&ua, &fa, sizeof(ua));
+                memcpy(&ub, &fb, sizeof(ub));
+                ((uint32_t*)out)[i] = softfloat_add_fp32(ua, ub);
+                break;
+            }
+            case TestMode::FP16_Narrow:
+                ((uint16_t*)out)[i] = softfloat_add_fp32_to_fp16(((const uint32_t*)a)[i], ((const uint32_t*)b)[i]);
+                break;
+            case TestMode::BF16_Narrow:
+                ((uint16_t*)out)[i] = softfloat_add_fp32_to_bf16(((const uint32_t*)a)[i], ((const uint32_t*)b)[i]);
+                break;
+        }
+    }
+}
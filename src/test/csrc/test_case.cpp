@@ -1,5 +1,7 @@
 #include "include/test_case.h"
 #include "include/softfloat_ref.h"
+#include "include/result_checker.h"
+#include "include/profiler.h"
 #include <iostream>
 #include <bitset>
 #include <memory>
@@ -25,6 +27,7 @@ TestCase::TestCase(const FADD_Operands_Hex& ops_hex, ErrorType error_type)
 
     // 计算期望结果
     expected_res_fp32 = softfloat_add_fp32(a_fp32_bits, b_fp32_bits);
+    expected_flags[0] = softfloat_add_flags(mode, a_fp32_bits, b_fp32_bits);
 }
 
 // FP16 dual operation constructor
@@ -51,6 +54,8 @@ TestCase::TestCase(const FADD_Operands_Hex_16& op1, const FADD_Operands_Hex_16&
     // Calculate and store expected results
     expected_res1_fp16 = softfloat_add_fp16(a1_fp16_bits, b1_fp16_bits);
     expected_res2_fp16 = softfloat_add_fp16(a2_fp16_bits, b2_fp16_bits);
+    expected_flags[0] = softfloat_add_flags(mode, a1_fp16_bits, b1_fp16_bits);
+    expected_flags[1] = softfloat_add_flags(mode, a2_fp16_bits, b2_fp16_bits);
 }
 
 // BF16 dual operation constructor
@@ -77,6 +82,8 @@ TestCase::TestCase(const FADD_Operands_Hex_BF16& op1, const FADD_Operands_Hex_BF
     // Calculate and store expected results
     expected_res1_bf16 = softfloat_add_bf16(a1_bf16_bits, b1_bf16_bits);
     expected_res2_bf16 = softfloat_add_bf16(a2_bf16_bits, b2_bf16_bits);
+    expected_flags[0] = softfloat_add_flags(mode, a1_bf16_bits, b1_bf16_bits);
+    expected_flags[1] = softfloat_add_flags(mode, a2_bf16_bits, b2_bf16_bits);
 }
 
 // FP16 widen operation constructor
@@ -100,6 +107,7 @@ TestCase::TestCase(const FADD_Operands_FP16_Widen& ops_widen, ErrorType error_ty
     memcpy(&a_fp32, &a_float, sizeof(uint32_t));
     memcpy(&b_fp32, &b_float, sizeof(uint32_t));
     expected_res_fp32 = softfloat_add_fp32(a_fp32, b_fp32);
+    expected_flags[0] = softfloat_add_flags(mode, ops_widen.a_hex, ops_widen.b_hex);
 }
 
 // BF16 widen operation constructor
@@ -123,6 +131,38 @@ TestCase::TestCase(const FADD_Operands_BF16_Widen& ops_widen, ErrorType error_ty
     memcpy(&a_fp32, &a_float, sizeof(uint32_t));
     memcpy(&b_fp32, &b_float, sizeof(uint32_t));
     expected_res_fp32 = softfloat_add_fp32(a_fp32, b_fp32);
+    expected_flags[0] = softfloat_add_flags(mode, ops_widen.a_hex, ops_widen.b_hex);
+}
+
+// FP32 + FP32 -> FP16 narrowing constructor
+TestCase::TestCase(const FADD_Operands_FP16_Narrow& ops_narrow, ErrorType error_type)
+    : mode(TestMode::FP16_Narrow),
+      error_type(error_type),
+      is_fp32(false), is_fp16(true), is_bf16(false), is_widen(false), is_narrow(true)
+{
+    a_fp32_bits = ops_narrow.a_hex;
+    b_fp32_bits = ops_narrow.b_hex;
+    memcpy(&op_fp.a, &a_fp32_bits, sizeof(float));
+    memcpy(&op_fp.b, &b_fp32_bits, sizeof(float));
+
+    // 期望结果: FP32 和只舍入一次到FP16
+    expected_res1_fp16 = softfloat_add_fp32_to_fp16(a_fp32_bits, b_fp32_bits);
+    expected_flags[0] = softfloat_add_flags(mode, a_fp32_bits, b_fp32_bits);
+}
+
+// FP32 + FP32 -> BF16 narrowing constructor
+TestCase::TestCase(const FADD_Operands_BF16_Narrow& ops_narrow, ErrorType error_type)
+    : mode(TestMode::BF16_Narrow),
+      error_type(error_type),
+      is_fp32(false), is_fp16(false), is_bf16(true), is_widen(false), is_narrow(true)
+{
+    a_fp32_bits = ops_narrow.a_hex;
+    b_fp32_bits = ops_narrow.b_hex;
+    memcpy(&op_fp.a, &a_fp32_bits, sizeof(float));
+    memcpy(&op_fp.b, &b_fp32_bits, sizeof(float));
+
+    expected_res1_bf16 = softfloat_add_fp32_to_bf16(a_fp32_bits, b_fp32_bits);
+    expected_flags[0] = softfloat_add_flags(mode, a_fp32_bits, b_fp32_bits);
 }
 
 void TestCase::print_details() const {
@@ -178,268 +218,91 @@ void TestCase::print_details() const {
             memcpy(&expected_fp_widen_bf16, &expected_res_fp32, sizeof(float));
             printf("Expected: %.8f (HEX: 0x%08X)\n", expected_fp_widen_bf16, expected_res_fp32);
             break;
+        case TestMode::FP16_Narrow:
+            printf("Mode: FP16 Narrow (a,b=FP32, result=FP16)\n");
+            printf("Inputs (HEX): a=0x%08X, b=0x%08X\n", a_fp32_bits, b_fp32_bits);
+            printf("Inputs (FP):  a=%.8e, b=%.8e\n", op_fp.a, op_fp.b);
+            printf("Expected: %.8f (HEX: 0x%x)\n", fp16_to_fp32(expected_res1_fp16), expected_res1_fp16);
+            break;
+        case TestMode::BF16_Narrow:
+            printf("Mode: BF16 Narrow (a,b=FP32, result=BF16)\n");
+            printf("Inputs (HEX): a=0x%08X, b=0x%08X\n", a_fp32_bits, b_fp32_bits);
+            printf("Inputs (FP):  a=%.8e, b=%.8e\n", op_fp.a, op_fp.b);
+            printf("Expected: %.8f (HEX: 0x%x)\n", bf16_to_fp32(expected_res1_bf16), expected_res1_bf16);
+            break;
     }
 }
 
-bool TestCase::check_result(const DutOutputs& dut_res) const {
-    printf("--- Verification ---\n");
-    
-    // 辅助函数：检查两个FP32数是否都是零（忽略符号位）
-    auto both_fp32_zero = [](uint32_t a, uint32_t b) {
-        return ((a & 0x7FFFFFFF) == 0) && ((b & 0x7FFFFFFF) == 0);
-    };
-    
-    // 辅助函数：检查两个FP/BF16数是否都是零（忽略符号位）
-    auto both_f16_zero = [](uint16_t a, uint16_t b) {
-        return ((a & 0x7FFF) == 0) && ((b & 0x7FFF) == 0);
-    };
-    
-    bool pass = false;
+bool TestCase::check_result(const DutOutputs& dut_res, ResultChecker& checker, bool verbose) const {
+    // 收集本用例的各路结果 (FP16/BF16为双路)
+    uint32_t a[2] = {}, b[2] = {}, dut[2] = {}, ref[2] = {};
+    size_t n = 1;
     switch(mode) {
-        case TestMode::FP32: {
-            float dut_res_fp;
-            memcpy(&dut_res_fp, &dut_res.res_out_32, sizeof(float));
-            printf("DUT Result: %.8f (HEX: 0x%08X)\n", dut_res_fp, dut_res.res_out_32);
-            float expected_fp;
-            memcpy(&expected_fp, &expected_res_fp32, sizeof(float));
-            int64_t ulp_diff = 0;
-            float relative_error = 0;
-
-            bool precise_pass = (dut_res.res_out_32 == expected_res_fp32);
-            
-            // 如果两个数都是0（忽略符号位），认为通过
-            bool both_zero = both_fp32_zero(dut_res.res_out_32, expected_res_fp32);
-            
-            if (error_type == ErrorType::Precise) {
-                pass = precise_pass || both_zero;
-            }
-            if (error_type == ErrorType::ULP) {
-                // 允许8 ulp (unit in the last place) 的误差
-                ulp_diff = std::abs((int64_t)dut_res.res_out_32 - (int64_t)expected_res_fp32);
-                pass = (ulp_diff <= 8) || both_zero;
-            }
-            if (error_type == ErrorType::RelativeError) {
-                float max_abs = std::max(std::abs(op_fp.a), std::abs(op_fp.b));
-                relative_error = std::abs(dut_res_fp - expected_fp) / max_abs;
-                pass = ((max_abs < std::pow(2, -60)) 
-                       ? (relative_error < 1e-3) //若ab或c的绝对值太小，则放宽误差要求
-                       : (relative_error < 1e-5)) 
-                       || precise_pass || both_zero;
-            }
-            if (!pass) {
-                if (error_type == ErrorType::Precise) {
-                    printf("ERROR: Expected 0x%08X, Got 0x%08X (Exact match required)\n", 
-                           expected_res_fp32, dut_res.res_out_32);
-                }
-                if (error_type == ErrorType::ULP) {
-                    printf("ERROR: Expected 0x%08X, Got 0x%08X, ULP diff: %ld\n", 
-                           expected_res_fp32, dut_res.res_out_32, ulp_diff);
-                }
-                if (error_type == ErrorType::RelativeError) {
-                    printf("ERROR: Expected 0x%08X, Got 0x%08X, Relative Error: %f\n", 
-                           expected_res_fp32, dut_res.res_out_32, relative_error);
-                }
-            }
-            if (error_type == ErrorType::ULP) {
-                printf("ULP diff: %ld\n", ulp_diff);
-            }
-            if (error_type == ErrorType::RelativeError) {
-                printf("Relative diff ratio: %.8e\n", relative_error);
-            }
+        case TestMode::FP32:
+            a[0] = a_fp32_bits;
+            b[0] = b_fp32_bits;
+            dut[0] = dut_res.res_out_32;
+            ref[0] = expected_res_fp32;
             break;
-        }
-        case TestMode::FP16: {
-            printf("DUT Result1: %.4f (HEX: 0x%x)\n", fp16_to_fp32(dut_res.res_out_16_0), dut_res.res_out_16_0);
-            printf("DUT Result2: %.4f (HEX: 0x%x)\n", fp16_to_fp32(dut_res.res_out_16_1), dut_res.res_out_16_1);
-
-            bool pass1 = false, pass2 = false;
-            
-            // 检查两个数是否都是0（忽略符号位）
-            bool both_zero1 = both_f16_zero(dut_res.res_out_16_0, expected_res1_fp16);
-            bool both_zero2 = both_f16_zero(dut_res.res_out_16_1, expected_res2_fp16);
-            
-            if (error_type == ErrorType::Precise) {
-                // 精确匹配
-                pass1 = (dut_res.res_out_16_0 == expected_res1_fp16) || both_zero1;
-                pass2 = (dut_res.res_out_16_1 == expected_res2_fp16) || both_zero2;
-            } else if (error_type == ErrorType::ULP) {
-                // 允许ULP误差（FP16允许2 ULP误差）
-                int32_t ulp_diff1 = std::abs((int32_t)dut_res.res_out_16_0 - (int32_t)expected_res1_fp16);
-                int32_t ulp_diff2 = std::abs((int32_t)dut_res.res_out_16_1 - (int32_t)expected_res2_fp16);
-                pass1 = (ulp_diff1 <= 5) || both_zero1;
-                pass2 = (ulp_diff2 <= 5) || both_zero2;
-                
-                if (!pass1) {
-                    printf("ERROR OP1: Expected 0x%x, Got 0x%x, ULP diff: %d\n", 
-                           expected_res1_fp16, dut_res.res_out_16_0, ulp_diff1);
-                }
-                if (!pass2) {
-                    printf("ERROR OP2: Expected 0x%x, Got 0x%x, ULP diff: %d\n", 
-                           expected_res2_fp16, dut_res.res_out_16_1, ulp_diff2);
-                }
-                printf("ULP diff1: %d, ULP diff2: %d\n", ulp_diff1, ulp_diff2);
-            } else if (error_type == ErrorType::RelativeError) {
-                // 相对误差检查（FP16）
-                float dut_res1_fp = fp16_to_fp32(dut_res.res_out_16_0);
-                float dut_res2_fp = fp16_to_fp32(dut_res.res_out_16_1);
-                float expected1_fp = fp16_to_fp32(expected_res1_fp16);
-                float expected2_fp = fp16_to_fp32(expected_res2_fp16);
-                
-                // 计算操作数1的相对误差
-                float max_abs1 = std::max(std::abs(op1_fp.a), std::abs(op1_fp.b));
-                float relative_error1 = std::abs(dut_res1_fp - expected1_fp) / max_abs1;
-                bool precise_pass1 = (dut_res.res_out_16_0 == expected_res1_fp16);
-                pass1 = ((max_abs1 < std::pow(2, -10))  // FP16精度较低，调整阈值
-                        ? (relative_error1 < 1e-2)      // 若ab或c的绝对值太小，则放宽误差要求
-                        : (relative_error1 < 1e-3))     // FP16相对误差要求比FP32宽松
-                        || precise_pass1 || both_zero1;
-                
-                // 计算操作数2的相对误差
-                float max_abs2 = std::max(std::abs(op2_fp.a), std::abs(op2_fp.b));
-                float relative_error2 = std::abs(dut_res2_fp - expected2_fp) / max_abs2;
-                bool precise_pass2 = (dut_res.res_out_16_1 == expected_res2_fp16);
-                pass2 = ((max_abs2 < std::pow(2, -10))  // FP16精度较低，调整阈值
-                        ? (relative_error2 < 1e-2)      // 若ab或c的绝对值太小，则放宽误差要求
-                        : (relative_error2 < 1e-3))     // FP16相对误差要求比FP32宽松
-                        || precise_pass2 || both_zero2;
-                
-                if (!pass1) {
-                    printf("ERROR OP1: Expected 0x%x (%.4f), Got 0x%x (%.4f), Relative Error: %e\n", 
-                           expected_res1_fp16, expected1_fp, dut_res.res_out_16_0, dut_res1_fp, relative_error1);
-                }
-                if (!pass2) {
-                    printf("ERROR OP2: Expected 0x%x (%.4f), Got 0x%x (%.4f), Relative Error: %e\n", 
-                           expected_res2_fp16, expected2_fp, dut_res.res_out_16_1, dut_res2_fp, relative_error2);
-                }
-                printf("Relative error1: %.6e, Relative error2: %.6e\n", relative_error1, relative_error2);
-            }
-            
-            pass = pass1 && pass2;
+        case TestMode::FP16:
+            n = 2;
+            a[0] = a1_fp16_bits; b[0] = b1_fp16_bits; dut[0] = dut_res.res_out_16_0; ref[0] = expected_res1_fp16;
+            a[1] = a2_fp16_bits; b[1] = b2_fp16_bits; dut[1] = dut_res.res_out_16_1; ref[1] = expected_res2_fp16;
             break;
-        }
-        case TestMode::BF16: {
-            printf("DUT Result1: %.4f (HEX: 0x%x)\n", bf16_to_fp32(dut_res.res_out_16_0), dut_res.res_out_16_0);
-            printf("DUT Result2: %.4f (HEX: 0x%x)\n", bf16_to_fp32(dut_res.res_out_16_1), dut_res.res_out_16_1);
-
-            bool pass1 = false, pass2 = false;
-            
-            // 检查两个数是否都是0（忽略符号位）
-            bool both_zero1 = both_f16_zero(dut_res.res_out_16_0, expected_res1_bf16);
-            bool both_zero2 = both_f16_zero(dut_res.res_out_16_1, expected_res2_bf16);
-            
-            // 先计算ULP和RelativeError下的通过情况
-            bool ulp_pass1 = false, ulp_pass2 = false;
-            bool rel_pass1 = false, rel_pass2 = false;
-            
-            // ULP误差计算（BF16允许2 ULP误差）
-            int32_t ulp_diff1 = std::abs((int32_t)dut_res.res_out_16_0 - (int32_t)expected_res1_bf16);
-            int32_t ulp_diff2 = std::abs((int32_t)dut_res.res_out_16_1 - (int32_t)expected_res2_bf16);
-            ulp_pass1 = (ulp_diff1 <= 2) || both_zero1;
-            ulp_pass2 = (ulp_diff2 <= 2) || both_zero2;
-            
-            // 相对误差计算（BF16）
-            float dut_res1_fp = bf16_to_fp32(dut_res.res_out_16_0);
-            float dut_res2_fp = bf16_to_fp32(dut_res.res_out_16_1);
-            float expected1_fp = bf16_to_fp32(expected_res1_bf16);
-            float expected2_fp = bf16_to_fp32(expected_res2_bf16);
-            
-            // 计算操作数1的相对误差
-            float max_abs1 = std::max(std::abs(op1_fp.a), std::abs(op1_fp.b));
-            float relative_error1 = std::abs(dut_res1_fp - expected1_fp) / max_abs1;
-            bool precise_pass1 = (dut_res.res_out_16_0 == expected_res1_bf16);
-            rel_pass1 = ((max_abs1 < std::pow(2, -30))  // BF16有较好的指数范围，但尾数精度较低
-                    ? (relative_error1 < 1e-2)      // 若ab或c的绝对值太小，则放宽误差要求
-                    : (relative_error1 < 8e-3))     // BF16相对误差要求介于FP32和FP16之间
-                    || precise_pass1 || both_zero1;
-            
-            // 计算操作数2的相对误差
-            float max_abs2 = std::max(std::abs(op2_fp.a), std::abs(op2_fp.b));
-            float relative_error2 = std::abs(dut_res2_fp - expected2_fp) / max_abs2;
-            bool precise_pass2 = (dut_res.res_out_16_1 == expected_res2_bf16);
-            rel_pass2 = ((max_abs2 < std::pow(2, -30))  // BF16有较好的指数范围，但尾数精度较低
-                    ? (relative_error2 < 1e-2)      // 若ab或c的绝对值太小，则放宽误差要求
-                    : (relative_error2 < 8e-3))     // BF16相对误差要求介于FP32和FP16之间
-                    || precise_pass2 || both_zero2;
-            
-            // 根据错误类型决定最终的通过条件
-            if (error_type == ErrorType::Precise) {
-                // 精确匹配
-                pass1 = (dut_res.res_out_16_0 == expected_res1_bf16) || both_zero1;
-                pass2 = (dut_res.res_out_16_1 == expected_res2_bf16) || both_zero2;
-            } else if (error_type == ErrorType::ULP) {
-                // 只使用ULP误差
-                pass1 = ulp_pass1;
-                pass2 = ulp_pass2;
-                
-                if (!pass1) {
-                    printf("ERROR OP1: Expected 0x%x, Got 0x%x, ULP diff: %d\n", 
-                           expected_res1_bf16, dut_res.res_out_16_0, ulp_diff1);
-                }
-                if (!pass2) {
-                    printf("ERROR OP2: Expected 0x%x, Got 0x%x, ULP diff: %d\n", 
-                           expected_res2_bf16, dut_res.res_out_16_1, ulp_diff2);
-                }
-                printf("ULP diff1: %d, ULP diff2: %d\n", ulp_diff1, ulp_diff2);
-            } else if (error_type == ErrorType::RelativeError) {
-                // 只使用相对误差
-                pass1 = rel_pass1;
-                pass2 = rel_pass2;
-                
-                if (!pass1) {
-                    printf("ERROR OP1: Expected 0x%x (%.4f), Got 0x%x (%.4f), Relative Error: %e\n", 
-                           expected_res1_bf16, expected1_fp, dut_res.res_out_16_0, dut_res1_fp, relative_error1);
-                }
-                if (!pass2) {
-                    printf("ERROR OP2: Expected 0x%x (%.4f), Got 0x%x (%.4f), Relative Error: %e\n", 
-                           expected_res2_bf16, expected2_fp, dut_res.res_out_16_1, dut_res2_fp, relative_error2);
-                }
-                printf("Relative error1: %.6e, Relative error2: %.6e\n", relative_error1, relative_error2);
-            } else if (error_type == ErrorType::ULP_or_RelativeError) {
-                // ULP或相对误差：如果ULP通过则通过，否则如果相对误差通过则通过，否则不通过
-                pass1 = ulp_pass1 || rel_pass1;
-                pass2 = ulp_pass2 || rel_pass2;
-                
-                if (!pass1) {
-                    printf("ERROR OP1: ULP diff: %d (>2), Relative Error: %e (>8e-3)\n", ulp_diff1, relative_error1);
-                }
-                if (!pass2) {
-                    printf("ERROR OP2: ULP diff: %d (>2), Relative Error: %e (>8e-3)\n", ulp_diff2, relative_error2);
-                }
-                printf("ULP diff1: %d, ULP diff2: %d\n", ulp_diff1, ulp_diff2);
-                printf("Relative error1: %.6e, Relative error2: %.6e\n", relative_error1, relative_error2);
-            }
-            
-            pass = pass1 && pass2;
+        case TestMode::BF16:
+            n = 2;
+            a[0] = a1_bf16_bits; b[0] = b1_bf16_bits; dut[0] = dut_res.res_out_16_0; ref[0] = expected_res1_bf16;
+            a[1] = a2_bf16_bits; b[1] = b2_bf16_bits; dut[1] = dut_res.res_out_16_1; ref[1] = expected_res2_bf16;
             break;
-        }
         case TestMode::FP16_Widen:
         case TestMode::BF16_Widen:
-        {
-            float dut_res_fp;
-            memcpy(&dut_res_fp, &dut_res.res_out_32, sizeof(float));
-            printf("DUT Result: %.8f (HEX: 0x%08X)\n", dut_res_fp, dut_res.res_out_32);
-            
-            float expected_fp;
-            memcpy(&expected_fp, &expected_res_fp32, sizeof(float));
-            
-            int64_t ulp_diff = std::abs((int64_t)dut_res.res_out_32 - (int64_t)expected_res_fp32);
-            bool both_zero = both_fp32_zero(dut_res.res_out_32, expected_res_fp32);
+            // 16位操作数存放在a_fp32_bits/b_fp32_bits的高16位
+            a[0] = a_fp32_bits >> 16;
+            b[0] = b_fp32_bits >> 16;
+            dut[0] = dut_res.res_out_32;
+            ref[0] = expected_res_fp32;
+            break;
+        case TestMode::FP16_Narrow:
+        case TestMode::BF16_Narrow:
+            // 结果及其fflags在高16位一路 (res_out_16_1)
+            a[0] = a_fp32_bits;
+            b[0] = b_fp32_bits;
+            dut[0] = dut_res.res_out_16_1;
+            ref[0] = mode == TestMode::FP16_Narrow ? expected_res1_fp16 : expected_res1_bf16;
+            break;
+    }
 
-            if (error_type == ErrorType::Precise) {
-                pass = (dut_res.res_out_32 == expected_res_fp32) || both_zero;
-            } else {
-                pass = (ulp_diff <= 2) || both_zero; // Widen to FP32, allow small ULP error
-            }
+    LaneError err[2];
+    bool pass = checker.check_batch(mode, error_type, CheckInputs{a, b, dut, ref}, n, err) == 0;
+    const uint8_t dut_flags[2] = {is_narrow ? dut_res.fflags_1 : dut_res.fflags_0, dut_res.fflags_1};
+    pass &= checker.check_flags(mode, a, b, dut_flags, expected_flags, n) == 0;
+    if (!verbose && pass) {
+        return pass;
+    }
 
-            if (!pass) {
-                printf("ERROR: Expected 0x%08X, Got 0x%08X, ULP diff: %ld\n", 
-                       expected_res_fp32, dut_res.res_out_32, ulp_diff);
-            }
-            printf("ULP diff: %ld\n", ulp_diff);
-            break;
+    PROF_SCOPE(ProfPhase::Print);
+    if (!verbose) {
+        print_details(); // quiet mode: details of failing tests only
+    }
+    printf("--- Verification ---\n");
+    FpFormat fmt = result_format(mode);
+    int hex_width = fmt == FpFormat::FP32 ? 8 : 4;
+    for (size_t i = 0; i < n; ++i) {
+        const char* lane = n == 1 ? "" : (i == 0 ? "1" : "2");
+        printf("DUT Result%s: %.8f (HEX: 0x%0*X)\n", lane, fp_to_double(dut[i], fmt), hex_width, dut[i]);
+        if (!err[i].pass) {
+            printf("ERROR%s%s: Expected 0x%0*X, Got 0x%0*X, ULP diff: %u, Relative Error: %e\n",
+                   n == 1 ? "" : " OP", lane, hex_width, ref[i], hex_width, dut[i], err[i].ulp, err[i].rel);
+        }
+        if (error_type != ErrorType::Precise) {
+            printf("ULP diff%s: %u, Relative error%s: %.6e\n", lane, err[i].ulp, lane, err[i].rel);
         }
+        char fd[16], fr[16];
+        printf("fflags%s: %s%s%s\n", lane, fflags_str(dut_flags[i], fd),
+               dut_flags[i] == expected_flags[i] ? "" : ", expected ",
+               dut_flags[i] == expected_flags[i] ? "" : fflags_str(expected_flags[i], fr));
     }
-    
+
     if (pass) {
         printf("Result: PASS\n");
     } else {
@@ -447,4 +310,4 @@ bool TestCase::check_result(const DutOutputs& dut_res) const {
     }
     printf("-----------------\n\n");
     return pass;
-} 
\ No newline at end of file
+}
@@ -12,6 +12,8 @@ std::vector<TestCase> create_all_tests() {
     bool test_bf16 = true;
     bool test_fp16_widen = true;
     bool test_bf16_widen = true;
+    bool test_fp16_narrow = true;
+    bool test_bf16_narrow = true;
   
     if (test_fp32) {
         add_fp32_tests(tests);
@@ -33,5 +35,13 @@ std::vector<TestCase> create_all_tests() {
         add_bf16_widen_tests(tests);
     }
 
+    if (test_fp16_narrow) {
+        add_fp16_narrow_tests(tests);
+    }
+
+    if (test_bf16_narrow) {
+        add_bf16_narrow_tests(tests);
+    }
+
     return tests;
 } 
\ No newline at end of file
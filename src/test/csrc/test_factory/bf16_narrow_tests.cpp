@@ -0,0 +1,67 @@
+#include "../include/test_factory.h"
+#include "../include/fp_utils.h"
+#include <vector>
+#include <cstdio>
+#include <cmath>
+
+void add_bf16_narrow_tests(std::vector<TestCase>& tests) {
+    // -- FP32 + FP32 -> BF16 narrowing 测试 (单次舍入) --
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x3F800000, 0x40000000}, ErrorType::Precise)); // 1.0 + 2.0 = 3.0
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x3F800000, 0xBF800000}, ErrorType::Precise)); // 1.0 + -1.0 = 0.0
+    // 1 + 2^-8 is a tie in BF16; + 2^-40 must round up (rounding to FP32 first gives the tie, then 1.0)
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x3F808000, 0x2B800000}, ErrorType::Precise));
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x3F808000, 0xAB800000}, ErrorType::Precise));
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x7F7F0000, 0x73800000}, ErrorType::Precise)); // max BF16 + 2^104 -> Inf (OF)
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x7F7FFFFF, 0x00000000}, ErrorType::Precise)); // max FP32 -> Inf (OF)
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x00400000, 0x00000001}, ErrorType::Precise)); // subnormal tie + 1 ulp
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x00008000, 0x00000000}, ErrorType::Precise)); // 2^-134: tie -> 0 (UF)
+    // Rounds up to 2^-126, but at 8 bits with an unbounded exponent it stays below: tiny (NX|UF)
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x007F8200, 0x00000000}, ErrorType::Precise));
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x007FC000, 0x00000000}, ErrorType::Precise)); // -> 2^-126, not tiny
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x80800000, 0x00000001}, ErrorType::Precise)); // -2^-126 + 2^-149
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x7F800000, 0xFF800000}, ErrorType::Precise)); // Inf - Inf = NaN (NV)
+    tests.push_back(TestCase(FADD_Operands_BF16_Narrow{0x7FA00000, 0x3F800000}, ErrorType::Precise)); // sNaN + 1.0 (NV)
+
+    printf("\n---- Random tests for BF16 Narrow ----\n");
+    int num_random_tests_bf16_narrow = 200;
+    ErrorType default_error_type = ErrorType::Precise;
+    // ---- 任意FP32值 ----
+    for (int i = 0; i < num_random_tests_bf16_narrow; ++i) {
+        FADD_Operands_BF16_Narrow ops = {gen_any_fp32(), gen_any_fp32()};
+        tests.push_back(TestCase(ops, default_error_type));
+    }
+    // ---- 中等数值范围 ----
+    for (int i = 0; i < num_random_tests_bf16_narrow; ++i) {
+        FADD_Operands_BF16_Narrow ops = {gen_random_fp32(-10, 10), gen_random_fp32(-10, 10)};
+        tests.push_back(TestCase(ops, default_error_type));
+    }
+    // ---- 远离的指数: 小的操作数只影响舍入 ----
+    for (int i = 0; i < num_random_tests_bf16_narrow; ++i) {
+        FADD_Operands_BF16_Narrow ops = {gen_random_fp32(-5, 5), gen_random_fp32(-40, -5)};
+        tests.push_back(TestCase(ops, default_error_type));
+    }
+    // ---- 次正规数 ----
+    for (int i = 0; i < num_random_tests_bf16_narrow; ++i) {
+        FADD_Operands_BF16_Narrow ops = {gen_random_fp32(-127, -120), gen_random_fp32(-127, -120)};
+        tests.push_back(TestCase(ops, default_error_type));
+    }
+    // ---- 上溢边界 ----
+    for (int i = 0; i < num_random_tests_bf16_narrow; ++i) {
+        FADD_Operands_BF16_Narrow ops = {gen_random_fp32(126, 127), gen_random_fp32(100, 127)};
+        tests.push_back(TestCase(ops, default_error_type));
+    }
+
+    // ---- AI负载分布测试 ----
+    bool test_workload = true;
+    if (test_workload) {
+        const WorkloadParams workloads[] = {
+            workload_gaussian(1.0),
+            workload_log_normal(std::ldexp(1.0, -40), 12.0),
+            workload_outliers(1.0, 4096.0, 1.0 / 16),
+            workload_cancelling(1.0, 26),
+        };
+        for (const WorkloadParams& w : workloads) {
+            add_workload_tests(tests, TestMode::BF16_Narrow, w, num_random_tests_bf16_narrow, default_error_type);
+        }
+    }
+}
@@ -2,6 +2,7 @@
 #include "../include/fp_utils.h"
 #include <vector>
 #include <cstdio>
+#include <cmath>
 
 void add_bf16_widen_tests(std::vector<TestCase>& tests) {
     // -- BF16 widen 测试 --
@@ -62,4 +63,18 @@ void add_bf16_widen_tests(std::vector<TestCase>& tests) {
         FADD_Operands_BF16_Widen ops = {gen_random_bf16(-100, -50), gen_random_bf16(50, 100)};
         tests.push_back(TestCase(ops, default_error_type));
     }
-} 
\ No newline at end of file
+
+    // ---- AI负载分布测试: 激活(高斯) / 梯度(对数正态) / 异常值通道 / 近似抵消的残差对 ----
+    bool test_workload = true;
+    if (test_workload) {
+        const WorkloadParams workloads[] = {
+            workload_gaussian(1.0),
+            workload_log_normal(std::ldexp(1.0, -30), 12.0),
+            workload_outliers(1.0, 4096.0, 1.0 / 16),
+            workload_cancelling(1.0, 9),
+        };
+        for (const WorkloadParams& w : workloads) {
+            add_workload_tests(tests, TestMode::BF16_Widen, w, num_random_tests_bf16_widen, default_error_type);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#include "../include/test_factory.h"
+#include "../include/fp_utils.h"
+#include <vector>
+#include <cstdio>
+#include <cmath>
+
+void add_fp16_narrow_tests(std::vector<TestCase>& tests) {
+    // -- FP32 + FP32 -> FP16 narrowing 测试 (单次舍入) --
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x3F800000, 0x40000000}, ErrorType::Precise)); // 1.0 + 2.0 = 3.0
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x3F800000, 0xBF800000}, ErrorType::Precise)); // 1.0 + -1.0 = 0.0
+    // 1 + 2^-11 is a tie in FP16; + 2^-40 must round up (rounding to FP32 first gives the tie, then 1.0)
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x3F801000, 0x2B800000}, ErrorType::Precise));
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x3F801000, 0xAB800000}, ErrorType::Precise));
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x477FE000, 0x41700000}, ErrorType::Precise)); // 65504 + 15 = 65504
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x477FE000, 0x41800000}, ErrorType::Precise)); // 65504 + 16 = Inf (OF)
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x47800000, 0xC7000000}, ErrorType::Precise)); // 65536 - 32768 = 32768
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x7F000000, 0x7F000000}, ErrorType::Precise)); // FP32 overflow -> Inf
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x33000000, 0x32800000}, ErrorType::Precise)); // 1.5 * 2^-25 -> 2^-24
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x33000000, 0x00000000}, ErrorType::Precise)); // 2^-25: tie -> 0 (UF)
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x38800000, 0xB3800000}, ErrorType::Precise)); // 2^-14 - 2^-24: subnormal
+    // Rounds up to 2^-14, but at 11 bits with an unbounded exponent it stays below: tiny (NX|UF)
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x387FE100, 0x00000000}, ErrorType::Precise));
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x387FF000, 0x00000000}, ErrorType::Precise)); // -> 2^-14, not tiny
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x00000001, 0x00000001}, ErrorType::Precise)); // FP32 subnormals -> 0
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x80000001, 0x00000000}, ErrorType::Precise)); // -> -0
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x7F800000, 0x3F800000}, ErrorType::Precise)); // Inf + 1.0 = Inf
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x7F800000, 0xFF800000}, ErrorType::Precise)); // Inf - Inf = NaN (NV)
+    tests.push_back(TestCase(FADD_Operands_FP16_Narrow{0x7FA00000, 0x3F800000}, ErrorType::Precise)); // sNaN + 1.0 (NV)
+
+    printf("\n---- Random tests for FP16 Narrow ----\n");
+    int num_random_tests_fp16_narrow = 200;
+    ErrorType default_error_type = ErrorType::Precise;
+    // ---- 任意FP32值: 大多上溢为Inf或下溢为0 ----
+    for (int i = 0; i < num_random_tests_fp16_narrow; ++i) {
+        FADD_Operands_FP16_Narrow ops = {gen_any_fp32(), gen_any_fp32()};
+        tests.push_back(TestCase(ops, default_error_type));
+    }
+    // ---- FP16 正常范围 ----
+    for (int i = 0; i < num_random_tests_fp16_narrow; ++i) {
+        FADD_Operands_FP16_Narrow ops = {gen_random_fp32(-14, 15), gen_random_fp32(-14, 15)};
+        tests.push_back(TestCase(ops, default_error_type));
+    }
+    // ---- 远离的指数: 小的操作数只影响舍入 ----
+    for (int i = 0; i < num_random_tests_fp16_narrow; ++i) {
+        FADD_Operands_FP16_Narrow ops = {gen_random_fp32(-5, 5), gen_random_fp32(-40, -10)};
+        tests.push_back(TestCase(ops, default_error_type));
+    }
+    // ---- FP16 次正规数与下溢 ----
+    for (int i = 0; i < num_random_tests_fp16_narrow; ++i) {
+        FADD_Operands_FP16_Narrow ops = {gen_random_fp32(-30, -13), gen_random_fp32(-30, -13)};
+        tests.push_back(TestCase(ops, default_error_type));
+    }
+    // ---- 上溢边界 ----
+    for (int i = 0; i < num_random_tests_fp16_narrow; ++i) {
+        FADD_Operands_FP16_Narrow ops = {gen_random_fp32(14, 17), gen_random_fp32(0, 16)};
+        tests.push_back(TestCase(ops, default_error_type));
+    }
+
+    // ---- AI负载分布测试: 残差流 (FP32累加, 窄化写回) ----
+    bool test_workload = true;
+    if (test_workload) {
+        const WorkloadParams workloads[] = {
+            workload_gaussian(1.0),
+            workload_log_normal(std::ldexp(1.0, -12), 4.0),
+            workload_outliers(1.0, 4096.0, 1.0 / 16),
+            workload_cancelling(1.0, 26),
+        };
+        for (const WorkloadParams& w : workloads) {
+            add_workload_tests(tests, TestMode::FP16_Narrow, w, num_random_tests_fp16_narrow, default_error_type);
+        }
+    }
+}
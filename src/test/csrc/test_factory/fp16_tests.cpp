@@ -2,6 +2,7 @@
 #include "../include/fp_utils.h"
 #include <vector>
 #include <cstdio>
+#include <cmath>
 
 void add_fp16_tests(std::vector<TestCase>& tests) {
     // -- FP16 并行双路半精度浮点数测试 --
@@ -74,4 +75,18 @@ void add_fp16_tests(std::vector<TestCase>& tests) {
         FADD_Operands_Hex_16 ops2 = {gen_random_fp16(-15, -14), gen_random_fp16(-15, -14)};
         tests.push_back(TestCase(ops1, ops2, default_error_type));
     }
-} 
\ No newline at end of file
+
+    // ---- AI负载分布测试: 激活(高斯) / 梯度(对数正态) / 异常值通道 / 近似抵消的残差对 ----
+    bool test_workload = true;
+    if (test_workload) {
+        const WorkloadParams workloads[] = {
+            workload_gaussian(1.0),
+            workload_log_normal(std::ldexp(1.0, -14), 4.0),
+            workload_outliers(1.0, 256.0, 1.0 / 16),
+            workload_cancelling(1.0, 12),
+        };
+        for (const WorkloadParams& w : workloads) {
+            add_workload_tests(tests, TestMode::FP16, w, num_random_tests_16, default_error_type);
+        }
+    }
+}
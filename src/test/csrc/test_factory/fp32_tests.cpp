@@ -2,6 +2,7 @@
 #include "../include/fp_utils.h"
 #include <vector>
 #include <cstdio>
+#include <cmath>
 
 void add_fp32_tests(std::vector<TestCase>& tests) {
     // -- FP32 单精度浮点数测试 --
@@ -61,4 +62,18 @@ void add_fp32_tests(std::vector<TestCase>& tests) {
         FADD_Operands_Hex ops = {gen_random_fp32(-127, 10), gen_random_fp32(-127, 10)};
         tests.push_back(TestCase(ops, default_error_type));
     }
-} 
\ No newline at end of file
+
+    // ---- AI负载分布测试: 激活(高斯) / 梯度(对数正态) / 异常值通道 / 近似抵消的残差对 ----
+    bool test_workload = true;
+    if (test_workload) {
+        const WorkloadParams workloads[] = {
+            workload_gaussian(1.0),
+            workload_log_normal(std::ldexp(1.0, -40), 12.0),
+            workload_outliers(1.0, 4096.0, 1.0 / 16),
+            workload_cancelling(1.0, 26),
+        };
+        for (const WorkloadParams& w : workloads) {
+            add_workload_tests(tests, TestMode::FP32, w, num_random_tests_32, default_error_type);
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#include "../include/test_factory.h"
+#include "../include/workload_dist.h"
+#include <vector>
+#include <cstdio>
+
+void add_workload_tests(std::vector<TestCase>& tests, TestMode mode, const WorkloadParams& p, int count,
+                        ErrorType error_type) {
+    FpFormat fmt = operand_format(mode);
+    printf("  %s workload: %s x %d\n", mode_name(mode), workload_name(p.dist), count);
+    for (int i = 0; i < count; ++i) {
+        uint32_t a0, b0, a1, b1;
+        gen_workload_pair(p, fmt, a0, b0);
+        switch (mode) {
+            case TestMode::FP32:
+                tests.push_back(TestCase(FADD_Operands_Hex{a0, b0}, error_type));
+                break;
+            case TestMode::FP16:
+                gen_workload_pair(p, fmt, a1, b1);
+                tests.push_back(TestCase(FADD_Operands_Hex_16{(uint16_t)a0, (uint16_t)b0},
+                                         FADD_Operands_Hex_16{(uint16_t)a1, (uint16_t)b1}, error_type));
+                break;
+            case TestMode::BF16:
+                gen_workload_pair(p, fmt, a1, b1);
+                tests.push_back(TestCase(FADD_Operands_Hex_BF16{(uint16_t)a0, (uint16_t)b0},
+                                         FADD_Operands_Hex_BF16{(uint16_t)a1, (uint16_t)b1}, error_type));
+                break;
+            case TestMode::FP16_Widen:
+                tests.push_back(TestCase(FADD_Operands_FP16_Widen{(uint16_t)a0, (uint16_t)b0}, error_type));
+                break;
+            case TestMode::BF16_Widen:
+                tests.push_back(TestCase(FADD_Operands_BF16_Widen{(uint16_t)a0, (uint16_t)b0}, error_type));
+                break;
+            case TestMode::FP16_Narrow:
+                tests.push_back(TestCase(FADD_Operands_FP16_Narrow{a0, b0}, error_type));
+                break;
+            case TestMode::BF16_Narrow:
+                tests.push_back(TestCase(FADD_Operands_BF16_Narrow{a0, b0}, error_type));
+                break;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include "include/workload_dist.h"
+#include "include/fp_utils.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+// 异常值通道: 按通道轮转, 模拟 LLM 激活中固定的少数大幅值通道
+static const int kWorkloadChannels = 64;
+
+static std::mt19937& workload_rng() {
+    static std::mt19937 rng((uint32_t)rand());
+    return rng;
+}
+
+void workload_seed(uint32_t seed) {
+    workload_rng().seed(seed);
+}
+
+const char* workload_name(WorkloadDist dist) {
+    switch (dist) {
+        case WorkloadDist::Gaussian:        return "gaussian";
+        case WorkloadDist::LogNormal:       return "log-normal";
+        case WorkloadDist::OutlierChannels: return "outlier-channels";
+        case WorkloadDist::Cancelling:      return "cancelling";
+    }
+    return "?";
+}
+
+static uint32_t to_format(double x, FpFormat fmt) {
+    float f = (float)x;
+    switch (fmt) {
+        case FpFormat::FP16: return fp32_to_fp16(f);
+        case FpFormat::BF16: return fp32_to_bf16(f);
+        case FpFormat::FP32: break;
+    }
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+static uint32_t sign_bit(FpFormat fmt) {
+    return fmt == FpFormat::FP32 ? 0x80000000u : 0x8000u;
+}
+
+static uint32_t max_finite(FpFormat fmt) {
+    switch (fmt) {
+        case FpFormat::FP16: return 0x7bffu;
+        case FpFormat::BF16: return 0x7f7fu;
+        case FpFormat::FP32: break;
+    }
+    return 0x7f7fffffu;
+}
+
+// b = -a with its magnitude moved by up to 2^max_log2 ulp (clamped to
+// [0, max finite]), so the sum cancels down to a few ulp of a or exactly 0
+static uint32_t cancelling_partner(uint32_t a, int max_log2, FpFormat fmt) {
+    std::mt19937& rng = workload_rng();
+    uint32_t sign = sign_bit(fmt);
+    int64_t mag = a & (sign - 1);
+    int k = std::uniform_int_distribution<int>(0, max_log2)(rng);
+    int64_t delta = std::uniform_int_distribution<int64_t>(-(1LL << k), 1LL << k)(rng);
+    mag += delta;
+    if (mag < 0) {
+        mag = 0;
+    } else if (mag > (int64_t)max_finite(fmt)) {
+        mag = max_finite(fmt);
+    }
+    return ((a & sign) ^ sign) | (uint32_t)mag;
+}
+
+void gen_workload_pair(const WorkloadParams& p, FpFormat fmt, uint32_t& a, uint32_t& b) {
+    static int channel = 0;
+    std::mt19937& rng = workload_rng();
+    std::normal_distribution<double> normal(0.0, 1.0);
+    switch (p.dist) {
+        case WorkloadDist::Gaussian:
+            a = to_format(p.scale * normal(rng), fmt);
+            b = to_format(p.scale * normal(rng), fmt);
+            break;
+        case WorkloadDist::LogNormal: {
+            std::bernoulli_distribution neg(0.5);
+            double ma = p.scale * std::exp2(p.spread * normal(rng));
+            double mb = p.scale * std::exp2(p.spread * normal(rng));
+            a = to_format(neg(rng) ? -ma : ma, fmt);
+            b = to_format(neg(rng) ? -mb : mb, fmt);
+            break;
+        }
+        case WorkloadDist::OutlierChannels: {
+            // a 与 b 取自同一通道 (残差加法: x[c] + f(x)[c])
+            channel = (channel + 1) % kWorkloadChannels;
+            double gain = channel < (int)(p.fraction * kWorkloadChannels + 0.5) ? p.spread : 1.0;
+            a = to_format(gain * p.scale * normal(rng), fmt);
+            b = to_format(gain * p.scale * normal(rng), fmt);
+            break;
+        }
+        case WorkloadDist::Cancelling:
+            a = to_format(p.scale * normal(rng), fmt);
+            b = cancelling_partner(a, (int)p.spread, fmt);
+            break;
+    }
+}
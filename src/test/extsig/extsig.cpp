@@ -0,0 +1,409 @@
+// topFAddExtSig harness: FAdd_extSig on its FpExtFormat interface (sign, exp,
+// sig with one integer bit and ExtendedWidth extension bits), including
+// non-zero extension bits when ExtAreZeros is false, as an FMA post-adder
+// would drive it. The configuration is read from the top's cfg_* outputs.
+//
+// Reference: the smaller operand is aligned (shifted-out bits discarded, or
+// jammed into the LSB with ExtAreZeros && UseShiftRightJam), the aligned
+// significands are added exactly, and the sum is normalised the way the
+// module documents it: integer part 1 at the MSB of the SigWidth+ExtendedWidth+1
+// bit result, or exp = 1 with integer part 0 for subnormals.
+//
+// When every finite operand pair fits in --max-exhaustive, all of them are
+// swept (plus every pair involving Inf/NaN); otherwise --random pairs biased
+// towards close exponents and cancellation are checked. Split with --shard k/N
+// and --jobs as in the intmul harness.
+#include "verilated_fixture.h"
+#include "VtopFAddExtSig.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ExtCfg {
+    int exp_w, sig_w, ext_w;
+    bool ext_are_zeros, jam;
+    bool is_fp16; // ExpWidth 8 holding an fp16 exponent: Inf is 0x1F
+    int width() const { return sig_w + ext_w; }
+    uint32_t inf_exp() const { return is_fp16 ? 0x1F : (1u << exp_w) - 1; }
+};
+
+struct ExtOp {
+    bool sign;
+    uint32_t exp;
+    uint64_t sig;
+    bool inf, nan;
+};
+
+struct ExtRes {
+    bool sign;
+    uint32_t exp;
+    uint64_t sig;
+    bool pos_inf, neg_inf, nan;
+    bool zero; // reference only: exact zero sum (exp is not checked)
+};
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static uint64_t mask(int bits) { return bits >= 64 ? ~0ull : (1ull << bits) - 1; }
+
+// ===================================================================
+// Reference
+// ===================================================================
+static ExtRes ref_add(const ExtCfg& c, const ExtOp& a, const ExtOp& b) {
+    const int w = c.width();
+    ExtRes r = {};
+    r.nan = a.nan || b.nan || (a.inf && b.inf && a.sign != b.sign);
+    r.pos_inf = !r.nan && ((a.inf && !a.sign) || (b.inf && !b.sign));
+    r.neg_inf = !r.nan && ((a.inf && a.sign) || (b.inf && b.sign));
+
+    // Alignment: the operand with the smaller exponent is shifted right
+    const bool a_gte_b = a.exp >= b.exp;
+    const ExtOp& big = a_gte_b ? a : b;
+    const ExtOp& small = a_gte_b ? b : a;
+    const uint32_t d = big.exp - small.exp;
+    uint64_t shifted = d >= (uint32_t)w ? 0 : small.sig >> d;
+    bool sticky = d >= (uint32_t)w ? small.sig != 0 : (small.sig & mask(d)) != 0;
+    if (c.ext_are_zeros && c.jam) shifted |= sticky;
+    const uint64_t xa = a_gte_b ? big.sig : shifted;
+    const uint64_t xb = a_gte_b ? shifted : big.sig;
+
+    // Exact sum of the aligned significands (w + 1 bits)
+    uint64_t m;
+    if (a.sign == b.sign) {
+        m = xa + xb;
+        r.sign = a.sign;
+    } else {
+        const bool a_gt_b = a.exp != b.exp ? a.exp > b.exp : a.sig > b.sig;
+        m = a_gt_b ? xa - xb : xb - xa;
+        r.sign = a_gt_b ? a.sign : b.sign;
+    }
+
+    // Normalisation
+    const uint32_t e = big.exp;
+    if (m >> w) { // integer part >= 2
+        r.exp = e + 1;
+        r.sig = m;
+        if (e + 1 == c.inf_exp()) {
+            r.pos_inf |= !r.sign;
+            r.neg_inf |= r.sign;
+        }
+    } else if (m >> (w - 1)) { // integer part 1
+        r.exp = e;
+        r.sig = m << 1;
+    } else {
+        uint32_t lz = 0; // leading zeros of the w - 1 fraction bits
+        while (lz < (uint32_t)w - 1 && !((m >> (w - 2 - lz)) & 1)) lz++;
+        if (e - 1 <= lz) {
+            r.exp = 1;
+            r.sig = m << e;
+        } else {
+            r.exp = e - lz - 1;
+            r.sig = m << (lz + 2);
+        }
+    }
+    r.sig &= mask(w + 1);
+    if (m == 0) {
+        // x + (-x) = +0 under RNE; (-0) + (-0) = -0
+        r.zero = true;
+        r.sign = a.sign == b.sign && a.sign;
+    }
+    return r;
+}
+
+// ===================================================================
+// Operand spaces
+// ===================================================================
+// Every finite operand: exp = 1 takes integer part 0 or 1, larger exponents
+// integer part 1; extension bits are zero when ExtAreZeros
+static std::vector<ExtOp> finite_operands(const ExtCfg& c) {
+    std::vector<ExtOp> ops;
+    const int w = c.width();
+    const uint64_t step = c.ext_are_zeros ? 1ull << c.ext_w : 1;
+    for (int sign = 0; sign < 2; ++sign) {
+        for (uint32_t e = 1; e < c.inf_exp(); ++e) {
+            uint64_t lo = e == 1 ? 0 : 1ull << (w - 1);
+            for (uint64_t sig = lo; sig <= mask(w); sig += step) ops.push_back({(bool)sign, e, sig, false, false});
+        }
+    }
+    return ops;
+}
+
+static std::vector<ExtOp> special_operands(const ExtCfg& c) {
+    const int w = c.width();
+    const uint64_t one = 1ull << (w - 1);
+    const uint64_t payload = c.ext_are_zeros ? 1ull << c.ext_w : 1;
+    std::vector<ExtOp> ops;
+    for (int sign = 0; sign < 2; ++sign) {
+        ops.push_back({(bool)sign, c.inf_exp(), one, true, false});
+        ops.push_back({(bool)sign, c.inf_exp(), one | payload, false, true});
+    }
+    return ops;
+}
+
+static ExtOp random_operand(const ExtCfg& c, uint64_t r, uint32_t near_exp) {
+    const int w = c.width();
+    ExtOp o = {};
+    o.sign = r & 1;
+    r >>= 1;
+    uint32_t n_exp = c.inf_exp() - 1;
+    if (near_exp && (r & 1)) { // within +-3 of the other operand: alignment and cancellation
+        int e = (int)near_exp + (int)((r >> 1) % 7) - 3;
+        o.exp = e < 1 ? 1 : e > (int)n_exp ? n_exp : e;
+    } else {
+        o.exp = 1 + (uint32_t)((r >> 1) % n_exp);
+    }
+    uint64_t s = splitmix64(r);
+    o.sig = s & mask(w - 1);
+    if (o.exp > 1 || (s >> 63)) o.sig |= 1ull << (w - 1);
+    if (c.ext_are_zeros) o.sig &= ~mask(c.ext_w);
+    return o;
+}
+
+// ===================================================================
+// ExtSigSim: 一个线程一个模型
+// ===================================================================
+class ExtSigSim : public VerilatedFixture<VtopFAddExtSig> {
+public:
+    ExtSigSim(int argc, char* argv[]) : VerilatedFixture(argc, argv) {
+        reset();
+        top_->eval();
+    }
+
+    ExtCfg config() const {
+        return {top_->io_cfg_exp_width, top_->io_cfg_sig_width, top_->io_cfg_ext_width,
+                (bool)top_->io_cfg_ext_are_zeros, (bool)top_->io_cfg_shift_right_jam, false};
+    }
+
+    // Issues pair(i) for i in [begin, end); on_result(i, res) for every output
+    template <class PairFn, class ResFn>
+    bool run(bool is_fp16, uint64_t begin, uint64_t end, PairFn pair, ResFn on_result) {
+        top_->io_is_fp16 = is_fp16;
+        auto issue = [&](uint64_t i) -> uint64_t {
+            ExtOp a, b;
+            pair(begin + i, a, b);
+            poke(a, b);
+            return 1;
+        };
+        auto collect = [&](uint64_t i) -> uint64_t {
+            ExtRes r = {(bool)top_->io_res_sign, (uint32_t)top_->io_res_exp, (uint64_t)top_->io_res_sig,
+                        (bool)top_->io_res_is_posInf, (bool)top_->io_res_is_negInf,
+                        (bool)top_->io_res_is_nan, false};
+            on_result(begin + i, r);
+            return 1;
+        };
+        return stream(end - begin, issue, collect) == end - begin;
+    }
+
+private:
+    void poke(const ExtOp& a, const ExtOp& b) {
+        top_->io_a_sign = a.sign;
+        top_->io_a_exp = a.exp;
+        top_->io_a_sig = a.sig;
+        top_->io_a_is_inf = a.inf;
+        top_->io_a_is_nan = a.nan;
+        top_->io_b_sign = b.sign;
+        top_->io_b_exp = b.exp;
+        top_->io_b_sig = b.sig;
+        top_->io_b_is_inf = b.inf;
+        top_->io_b_is_nan = b.nan;
+    }
+};
+
+// ===================================================================
+// Checking
+// ===================================================================
+enum class Mismatch { Flags, Value, ZeroSign, kCount };
+static const char* kMismatchNames[] = {"inf/nan flags", "sign/exp/sig", "sign of zero"};
+
+struct SweepStats {
+    std::atomic<uint64_t> checked{0}, cycles{0};
+    std::atomic<uint64_t> failures[(int)Mismatch::kCount];
+    std::atomic<bool> timeout{false};
+    std::mutex print_mutex;
+    uint64_t max_print = 20;
+    std::atomic<uint64_t> printed{0};
+    SweepStats() {
+        for (auto& f : failures) f = 0;
+    }
+    uint64_t total_failures() const {
+        uint64_t n = 0;
+        for (auto& f : failures) n += f;
+        return n;
+    }
+};
+
+static bool classify(const ExtRes& dut, const ExtRes& ref, Mismatch& kind) {
+    if (dut.pos_inf != ref.pos_inf || dut.neg_inf != ref.neg_inf || dut.nan != ref.nan) {
+        kind = Mismatch::Flags;
+        return false;
+    }
+    if (ref.pos_inf || ref.neg_inf || ref.nan) return true; // sign/exp/sig are don't-care
+    if (ref.zero) {
+        if (dut.sig != 0) {
+            kind = Mismatch::Value;
+            return false;
+        }
+        kind = Mismatch::ZeroSign;
+        return dut.sign == ref.sign;
+    }
+    kind = Mismatch::Value;
+    return dut.sign == ref.sign && dut.exp == ref.exp && dut.sig == ref.sig;
+}
+
+template <class PairFn>
+static void sweep(int argc, char* argv[], const ExtCfg& cfg, uint64_t begin, uint64_t end, int jobs, PairFn pair,
+                  SweepStats& st) {
+    std::vector<std::thread> workers;
+    const uint64_t chunk = (end - begin + jobs - 1) / jobs;
+    for (int j = 0; j < jobs; ++j) {
+        uint64_t b = begin + j * chunk, e = b + chunk < end ? b + chunk : end;
+        if (b >= e) break;
+        workers.emplace_back([&, b, e]() {
+            ExtSigSim sim(argc, argv);
+            bool ok = sim.run(cfg.is_fp16, b, e, pair, [&](uint64_t i, const ExtRes& dut) {
+                ExtOp x, y;
+                pair(i, x, y);
+                ExtRes ref = ref_add(cfg, x, y);
+                Mismatch kind;
+                if (classify(dut, ref, kind)) return;
+                st.failures[(int)kind]++;
+                if (st.printed.fetch_add(1) < st.max_print) {
+                    std::lock_guard<std::mutex> lock(st.print_mutex);
+                    printf("  FAIL #%llu (%s): a=%c/%X/0x%llX%s b=%c/%X/0x%llX%s\n"
+                           "    dut=%c/%X/0x%llX inf+%d inf-%d nan%d  ref=%c/%X/0x%llX inf+%d inf-%d nan%d\n",
+                           (unsigned long long)i, kMismatchNames[(int)kind], x.sign ? '-' : '+', x.exp,
+                           (unsigned long long)x.sig, x.nan ? " NaN" : x.inf ? " Inf" : "", y.sign ? '-' : '+',
+                           y.exp, (unsigned long long)y.sig, y.nan ? " NaN" : y.inf ? " Inf" : "",
+                           dut.sign ? '-' : '+', dut.exp, (unsigned long long)dut.sig, dut.pos_inf, dut.neg_inf,
+                           dut.nan, ref.sign ? '-' : '+', ref.exp, (unsigned long long)ref.sig, ref.pos_inf,
+                           ref.neg_inf, ref.nan);
+                }
+            });
+            if (!ok) st.timeout = true;
+            st.checked += e - b;
+            st.cycles += sim.cycles();
+        });
+    }
+    for (std::thread& t : workers) t.join();
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [--jobs <n>] [--shard <k>/<N>] [--max-exhaustive <pairs>] [--random <n>] [--seed <s>]\n"
+           "          [--fp16-range] [--max-print <n>]\n", prog);
+}
+
+int main(int argc, char* argv[]) {
+    int jobs = (int)std::thread::hardware_concurrency();
+    unsigned shard = 0, n_shards = 1;
+    uint64_t max_exhaustive = 1ull << 30;
+    uint64_t n_random = 1ull << 24;
+    uint64_t seed = 1;
+    uint64_t max_print = 20;
+    bool fp16_range = false;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--jobs") && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            jobs = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--shard") && i + 1 < argc &&
+                   sscanf(argv[i + 1], "%u/%u", &shard, &n_shards) == 2 && shard < n_shards) {
+            i++;
+        } else if (!strcmp(argv[i], "--max-exhaustive") && i + 1 < argc) {
+            max_exhaustive = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--random") && i + 1 < argc) {
+            n_random = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--fp16-range")) {
+            fp16_range = true;
+        } else if (!strcmp(argv[i], "--max-print") && i + 1 < argc) {
+            max_print = strtoull(argv[++i], nullptr, 0);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (jobs < 1) jobs = 1;
+
+    ExtCfg cfg = ExtSigSim(argc, argv).config();
+    if (cfg.width() + 1 > 64) {
+        fprintf(stderr, "SigWidth + ExtendedWidth = %d: results wider than 64 bits are not supported\n",
+                cfg.width());
+        return 1;
+    }
+    if (fp16_range && cfg.exp_w != 8) {
+        fprintf(stderr, "--fp16-range needs ExpWidth = 8 (got %d)\n", cfg.exp_w);
+        return 1;
+    }
+    cfg.is_fp16 = fp16_range;
+    printf("FAdd_extSig ExpWidth=%d SigWidth=%d ExtendedWidth=%d ExtAreZeros=%d UseShiftRightJam=%d%s\n",
+           cfg.exp_w, cfg.sig_w, cfg.ext_w, cfg.ext_are_zeros, cfg.jam, cfg.is_fp16 ? " (fp16 range)" : "");
+
+    // Count the finite operands without building the list when it is clearly too large
+    const uint64_t per_exp = cfg.ext_are_zeros ? 1ull << (cfg.sig_w - 1) : 1ull << (cfg.width() - 1);
+    const uint64_t n_finite = 2 * (per_exp * (cfg.inf_exp() - 1) + per_exp);
+    const bool exhaustive = n_finite <= 0xFFFFFFFFull && n_finite * n_finite <= max_exhaustive;
+
+    std::vector<ExtOp> ops;
+    uint64_t space;
+    if (exhaustive) {
+        ops = finite_operands(cfg);
+        const std::vector<ExtOp> specials = special_operands(cfg);
+        ops.insert(ops.end(), specials.begin(), specials.end());
+        space = (uint64_t)ops.size() * ops.size();
+        printf("exhaustive: %zu operands (%zu Inf/NaN), %llu pairs\n", ops.size(), specials.size(),
+               (unsigned long long)space);
+    } else {
+        space = n_random;
+        printf("random: %llu pairs (%llu finite operands, all pairs exceed --max-exhaustive)\n",
+               (unsigned long long)space, (unsigned long long)n_finite);
+    }
+    const std::vector<ExtOp> specials = special_operands(cfg);
+    auto pair = [&](uint64_t i, ExtOp& a, ExtOp& b) {
+        if (exhaustive) {
+            a = ops[i / ops.size()];
+            b = ops[i % ops.size()];
+            return;
+        }
+        uint64_t r = splitmix64(seed ^ splitmix64(i));
+        a = random_operand(cfg, r, 0);
+        b = random_operand(cfg, splitmix64(r), a.exp);
+        if ((r >> 56) == 0) a = specials[(r >> 8) % specials.size()]; // 1/256: Inf/NaN
+        if ((r >> 48 & 0xFF) == 0) b = specials[(r >> 16) % specials.size()];
+    };
+
+    const uint64_t begin = space * shard / n_shards, end = space * (shard + 1) / n_shards;
+    SweepStats st;
+    st.max_print = max_print;
+    auto t0 = std::chrono::steady_clock::now();
+    sweep(argc, argv, cfg, begin, end, jobs, pair, st);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    printf("shard %u/%u: %llu pairs [%llu, %llu) | %llu cycles | %.1f Mops/s, %d jobs\n", shard, n_shards,
+           (unsigned long long)st.checked.load(), (unsigned long long)begin, (unsigned long long)end,
+           (unsigned long long)st.cycles.load(), secs > 0 ? st.checked.load() / secs / 1e6 : 0.0, jobs);
+    for (int k = 0; k < (int)Mismatch::kCount; ++k) {
+        if (st.failures[k]) printf("  %-14s %llu mismatches\n", kMismatchNames[k], (unsigned long long)st.failures[k].load());
+    }
+    if (st.timeout) {
+        printf("\nTimeout: valid_out stopped before every issued pair completed.\n");
+        return 1;
+    }
+    if (st.total_failures()) {
+        printf("\nFAdd_extSig FAILED: %llu mismatches.\n", (unsigned long long)st.total_failures());
+        return 1;
+    }
+    printf("\nFAdd_extSig passed.\n");
+    return 0;
+}
@@ -0,0 +1,389 @@
+// topFlush harness: robIdx-based kill of in-flight ops in FAdd_16_32 and
+// VFMA_16_32 (Flush = true). The same pool of ops runs twice:
+//   golden  back to back without flushes; FAdd results are also checked
+//           against SoftFloat
+//   flush   random issue on both units with a RobPtr per op, and random
+//           flushes of a robIdx taken from the ops in flight (flushItself
+//           random, sometimes no op covered), after which the next robIdx
+//           restarts from the flush point like a ROB rollback
+// Every cycle the outputs are compared with a model of the pipelines: an op
+// covered by a flush in any cycle from issue to its valid_out must never raise
+// valid_out, every other op must come out on time with its robIdx and the
+// golden result. Kills are counted per stage (0 = the issue cycle).
+#include "fp_utils.h"
+#include "softfloat_ref.h"
+#include "result_checker.h"
+#include <verilated.h>
+#include "VtopFlush.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+static const uint32_t kRobSize = 192; // VParams.VRobSize
+static const int kMaxStages = 8;
+
+// CircularQueuePtr(VRobSize)
+struct RobPtr {
+    bool flag = false;
+    uint32_t value = 0;
+
+    RobPtr next() const {
+        RobPtr p = *this;
+        if (++p.value == kRobSize) {
+            p.value = 0;
+            p.flag = !p.flag;
+        }
+        return p;
+    }
+    bool operator==(const RobPtr& o) const { return flag == o.flag && value == o.value; }
+    bool after(const RobPtr& o) const { return (flag != o.flag) != (value > o.value); }
+};
+
+struct Flush {
+    bool valid = false;
+    RobPtr robIdx;
+    bool itself = false;
+    bool covers(const RobPtr& p) const { return valid && (p.after(robIdx) || (itself && p == robIdx)); }
+};
+
+struct Op {
+    TestMode mode; // FP32 / FP16 / BF16, 16-bit formats: two elements
+    uint32_t a, b, c;
+};
+
+// Ports of one unit in topFlush
+struct UnitPorts {
+    const char* name;
+    CData *valid, *is_bf16, *is_fp16, *is_fp32, *rob_flag, *rob_value;
+    IData *a, *b, *c;
+    CData *out_valid, *out_rob_flag, *out_rob_value;
+    IData* out_res;
+};
+
+#define UNIT_PORTS(top, u)                                                                              \
+    UnitPorts {                                                                                         \
+        #u, &top->io_##u##_in_valid, &top->io_##u##_in_is_bf16, &top->io_##u##_in_is_fp16,              \
+            &top->io_##u##_in_is_fp32, &top->io_##u##_in_robIdx_flag, &top->io_##u##_in_robIdx_value,   \
+            &top->io_##u##_in_a, &top->io_##u##_in_b, &top->io_##u##_in_c, &top->io_##u##_out_valid,    \
+            &top->io_##u##_out_robIdx_flag, &top->io_##u##_out_robIdx_value, &top->io_##u##_out_res     \
+    }
+
+// ===================================================================
+// FlushSim: 驱动 topFlush
+// ===================================================================
+class FlushSim {
+public:
+    FlushSim(int argc, char* argv[]) : contextp_(new VerilatedContext) {
+        contextp_->commandArgs(argc, argv);
+        top_.reset(new VtopFlush(contextp_.get()));
+        units_[0] = UNIT_PORTS(top_, fadd);
+        units_[1] = UNIT_PORTS(top_, fma);
+        latency_[0] = (int)top_->io_fadd_delay - (int)top_->io_delay_bias;
+        latency_[1] = (int)top_->io_fma_delay - (int)top_->io_delay_bias;
+    }
+
+    void reset() {
+        idle();
+        top_->reset = 1;
+        for (int i = 0; i < 2; ++i) {
+            top_->clock = 0;
+            top_->eval();
+            top_->clock = 1;
+            top_->eval();
+        }
+        top_->reset = 0;
+    }
+    void idle() {
+        for (UnitPorts& u : units_) *u.valid = 0;
+        poke_flush(Flush());
+    }
+    void poke(int unit, const Op& op, const RobPtr& rob) {
+        UnitPorts& u = units_[unit];
+        *u.valid = 1;
+        *u.is_fp32 = op.mode == TestMode::FP32;
+        *u.is_fp16 = op.mode == TestMode::FP16;
+        *u.is_bf16 = op.mode == TestMode::BF16;
+        *u.rob_flag = rob.flag;
+        *u.rob_value = rob.value;
+        *u.a = op.a;
+        *u.b = op.b;
+        *u.c = op.c;
+    }
+    void poke_flush(const Flush& f) {
+        top_->io_flush_valid = f.valid;
+        top_->io_flush_robIdx_flag = f.robIdx.flag;
+        top_->io_flush_robIdx_value = f.robIdx.value;
+        top_->io_flush_flushItself = f.itself;
+    }
+    // First half of a cycle: outputs of this cycle, with this cycle's flush applied
+    void settle() {
+        top_->clock = 0;
+        top_->eval();
+        contextp_->timeInc(1);
+    }
+    void edge() {
+        top_->clock = 1;
+        top_->eval();
+        contextp_->timeInc(1);
+        for (UnitPorts& u : units_) *u.valid = 0;
+    }
+    bool out_valid(int unit) const { return *units_[unit].out_valid; }
+    RobPtr out_rob(int unit) const {
+        RobPtr p;
+        p.flag = *units_[unit].out_rob_flag;
+        p.value = *units_[unit].out_rob_value;
+        return p;
+    }
+    uint32_t out_res(int unit) const { return *units_[unit].out_res; }
+    int latency(int unit) const { return latency_[unit]; }
+    const char* name(int unit) const { return units_[unit].name; }
+
+private:
+    std::unique_ptr<VerilatedContext> contextp_;
+    std::unique_ptr<VtopFlush> top_;
+    UnitPorts units_[2];
+    int latency_[2];
+};
+
+// ===================================================================
+// Ops
+// ===================================================================
+static uint32_t gen_pair(TestMode mode, bool fma) {
+    // VFMA_16_32 does not handle NaN: moderate exponents there
+    switch (mode) {
+        case TestMode::FP16:
+            return fma ? gen_random_fp16(-6, 6) | (uint32_t)gen_random_fp16(-6, 6) << 16
+                       : gen_any_fp16() | (uint32_t)gen_any_fp16() << 16;
+        case TestMode::BF16:
+            return fma ? gen_random_bf16(-20, 20) | (uint32_t)gen_random_bf16(-20, 20) << 16
+                       : gen_any_bf16() | (uint32_t)gen_any_bf16() << 16;
+        default:
+            return fma ? gen_random_fp32(-20, 20) : gen_any_fp32();
+    }
+}
+
+static std::vector<Op> gen_ops(size_t n, bool fma) {
+    static const TestMode kModes[] = {TestMode::FP32, TestMode::FP16, TestMode::BF16};
+    std::vector<Op> ops(n);
+    for (Op& op : ops) {
+        op.mode = kModes[rand() % 3];
+        op.a = gen_pair(op.mode, fma);
+        op.b = gen_pair(op.mode, fma);
+        op.c = fma ? gen_pair(op.mode, fma) : 0;
+    }
+    return ops;
+}
+
+static bool same_res(TestMode mode, uint32_t x, uint32_t y) {
+    if (mode == TestMode::FP32) return x == y || fp_ulp_distance(x, y, FpFormat::FP32) == 0;
+    FpFormat f = mode == TestMode::FP16 ? FpFormat::FP16 : FpFormat::BF16;
+    return fp_ulp_distance(x & 0xffff, y & 0xffff, f) == 0 && fp_ulp_distance(x >> 16, y >> 16, f) == 0;
+}
+
+static uint32_t softfloat_add(const Op& op) {
+    switch (op.mode) {
+        case TestMode::FP16:
+            return softfloat_add_fp16(op.a, op.b) | (uint32_t)softfloat_add_fp16(op.a >> 16, op.b >> 16) << 16;
+        case TestMode::BF16:
+            return softfloat_add_bf16(op.a, op.b) | (uint32_t)softfloat_add_bf16(op.a >> 16, op.b >> 16) << 16;
+        default:
+            return softfloat_add_fp32(op.a, op.b);
+    }
+}
+
+// Back to back on both units, no flush. Returns the results in issue order per unit.
+static bool run_golden(FlushSim& sim, const std::vector<Op> (&ops)[2], std::vector<uint32_t> (&golden)[2]) {
+    sim.reset();
+    size_t issued = 0, done[2] = {0, 0};
+    const size_t n = ops[0].size();
+    RobPtr rob;
+    for (int cycle = 0; done[0] < n || done[1] < n; ++cycle) {
+        if (issued < n) {
+            for (int u = 0; u < 2; ++u) sim.poke(u, ops[u][issued], rob);
+            rob = rob.next();
+            ++issued;
+        }
+        sim.settle();
+        for (int u = 0; u < 2; ++u) {
+            if (sim.out_valid(u) && done[u] < n) golden[u][done[u]++] = sim.out_res(u);
+        }
+        sim.edge();
+        if (cycle > (int)n + 100) {
+            printf("golden run: timeout (%zu / %zu results)\n", done[0], done[1]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ===================================================================
+// Flush run
+// ===================================================================
+struct Inflight {
+    int unit;
+    size_t k;       // index into ops / golden
+    RobPtr rob;
+    uint64_t issue;
+    bool killed;
+};
+
+struct FlushStats {
+    uint64_t issued[2] = {0, 0}, completed[2] = {0, 0}, flushes = 0;
+    uint64_t killed[2][kMaxStages] = {};
+    uint64_t killed_valid = 0, missing = 0, wrong_rob = 0, wrong_res = 0;
+};
+
+static void run_flush(FlushSim& sim, const std::vector<Op> (&ops)[2], const std::vector<uint32_t> (&golden)[2],
+                      double p_issue, double p_flush, FlushStats& st) {
+    sim.reset();
+    const size_t n = ops[0].size();
+    size_t next[2] = {0, 0};
+    RobPtr rob;
+    std::vector<Inflight> inflight;
+    int reported = 0;
+    for (uint64_t t = 0; next[0] < n || next[1] < n || !inflight.empty(); ++t) {
+        for (int u = 0; u < 2; ++u) {
+            if (next[u] < n && rand() < p_issue * RAND_MAX) {
+                sim.poke(u, ops[u][next[u]], rob);
+                inflight.push_back({u, next[u]++, rob, t, false});
+                rob = rob.next();
+                ++st.issued[u];
+            }
+        }
+        Flush f;
+        if (!inflight.empty() && rand() < p_flush * RAND_MAX) {
+            f.valid = true;
+            f.itself = rand() & 1;
+            // Mostly an op in flight; sometimes the next robIdx, which covers nothing in flight
+            f.robIdx = rand() % 8 ? inflight[rand() % inflight.size()].rob : rob;
+            rob = f.itself ? f.robIdx : f.robIdx.next();
+            ++st.flushes;
+        }
+        sim.poke_flush(f);
+        sim.settle();
+
+        for (Inflight& op : inflight) {
+            if (!op.killed && f.covers(op.rob)) {
+                op.killed = true;
+                ++st.killed[op.unit][t - op.issue];
+            }
+        }
+        for (int u = 0; u < 2; ++u) {
+            const Inflight* due = nullptr;
+            bool due_killed = false;
+            for (const Inflight& op : inflight) {
+                if (op.unit == u && op.issue + sim.latency(u) == t) {
+                    if (op.killed) {
+                        due_killed = true;
+                    } else {
+                        due = &op;
+                    }
+                }
+            }
+            bool ok = true;
+            if (!due) {
+                if (sim.out_valid(u)) {
+                    ++st.killed_valid;
+                    ok = false;
+                }
+            } else if (!sim.out_valid(u)) {
+                ++st.missing;
+                ok = false;
+            } else {
+                ++st.completed[u];
+                if (!(sim.out_rob(u) == due->rob)) {
+                    ++st.wrong_rob;
+                    ok = false;
+                } else if (sim.out_res(u) != golden[u][due->k]) {
+                    ++st.wrong_res;
+                    ok = false;
+                }
+            }
+            if (!ok && reported++ < 10) {
+                printf("  cycle %llu %s: valid_out %d robIdx %d:%u res %08x, expected ", (unsigned long long)t,
+                       sim.name(u), sim.out_valid(u), sim.out_rob(u).flag, sim.out_rob(u).value, sim.out_res(u));
+                if (due) {
+                    printf("robIdx %d:%u res %08x\n", due->rob.flag, due->rob.value, golden[u][due->k]);
+                } else {
+                    printf("no output%s\n", due_killed ? " (killed op)" : "");
+                }
+            }
+        }
+        sim.edge();
+        sim.poke_flush(Flush());
+
+        std::vector<Inflight> left;
+        for (const Inflight& op : inflight) {
+            if (op.issue + sim.latency(op.unit) > t) left.push_back(op);
+        }
+        inflight.swap(left);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t n_ops = 100000;
+    double p_issue = 0.8, p_flush = 0.05;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--ops") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            n_ops = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--issue-rate") && i + 1 < argc && atof(argv[i + 1]) > 0) {
+            p_issue = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--flush-rate") && i + 1 < argc) {
+            p_flush = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else {
+            printf("Usage: %s [--ops <n per unit>] [--issue-rate <p>] [--flush-rate <p per cycle>] [--seed <s>]\n",
+                   argv[0]);
+            return 1;
+        }
+    }
+    srand(seed);
+
+    FlushSim sim(argc, argv);
+    printf("topFlush: %zu ops per unit, issue rate %.2f, flush rate %.3f per cycle; latency FAdd %d, FMA %d\n",
+           n_ops, p_issue, p_flush, sim.latency(0), sim.latency(1));
+    if (sim.latency(0) + 1 > kMaxStages || sim.latency(1) + 1 > kMaxStages) {
+        printf("Pipeline deeper than kMaxStages.\n");
+        return 1;
+    }
+
+    std::vector<Op> ops[2] = {gen_ops(n_ops, false), gen_ops(n_ops, true)};
+    std::vector<uint32_t> golden[2] = {std::vector<uint32_t>(n_ops), std::vector<uint32_t>(n_ops)};
+    if (!run_golden(sim, ops, golden)) return 1;
+    uint64_t fadd_bad = 0;
+    for (size_t k = 0; k < n_ops; ++k) {
+        fadd_bad += !same_res(ops[0][k].mode, golden[0][k], softfloat_add(ops[0][k]));
+    }
+    printf("golden run: FAdd vs SoftFloat %llu mismatches\n", (unsigned long long)fadd_bad);
+
+    FlushStats st;
+    run_flush(sim, ops, golden, p_issue, p_flush, st);
+    printf("%llu flushes\n", (unsigned long long)st.flushes);
+    for (int u = 0; u < 2; ++u) {
+        uint64_t killed = 0;
+        printf("  %-4s issued %llu, completed %llu, killed by stage:", sim.name(u),
+               (unsigned long long)st.issued[u], (unsigned long long)st.completed[u]);
+        for (int s = 0; s <= sim.latency(u); ++s) {
+            printf(" S%d %llu", s, (unsigned long long)st.killed[u][s]);
+            killed += st.killed[u][s];
+        }
+        printf("  (%llu write-back slots freed)\n", (unsigned long long)killed);
+    }
+    uint64_t failures = fadd_bad + st.killed_valid + st.missing + st.wrong_rob + st.wrong_res;
+    printf("valid_out of a killed op %llu, missing valid_out %llu, wrong robIdx %llu, wrong result %llu\n",
+           (unsigned long long)st.killed_valid, (unsigned long long)st.missing, (unsigned long long)st.wrong_rob,
+           (unsigned long long)st.wrong_res);
+    if (failures) {
+        printf("\nFlush check failed.\n");
+        return 1;
+    }
+    printf("\nAll flush checks passed.\n");
+    return 0;
+}
@@ -0,0 +1,202 @@
+// topFMA accumulation-chain harness: acc = a[k] * b[k] + acc over long chains,
+// the way a dot product / GEMM inner loop drives one VFMA_16_32.
+//   forwarding:  acc_fwd = 1, the next op issues as soon as acc_ready is high
+//   writeback:   c_in = previous result, issued delayBias cycles after valid_out
+//                (the round trip through the register file without the bypass)
+// Every op is checked against a SoftFloat fma using the DUT's previous result as
+// c; the final drift against a chain computed purely in SoftFloat is reported.
+#include "fp_utils.h"
+#include "softfloat_ref.h"
+#include "result_checker.h"
+#include "workload_dist.h"
+#include "verilated_fixture.h"
+#include "VtopFMA.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const int kDelayBias = 1; // VParams.delayBias
+
+struct Chain {
+    uint32_t c0;                // initial accumulator, fp32
+    std::vector<uint32_t> a, b; // operand format (widen: 16-bit)
+};
+
+static uint32_t to_fp32_bits(TestMode mode, uint32_t x) {
+    if (mode == TestMode::FP32) return x;
+    float f = mode == TestMode::FP16_Widen ? fp16_to_fp32(x) : bf16_to_fp32(x);
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// ===================================================================
+// FmaccSim: 驱动 topFMA, 一条依赖链接一条
+// ===================================================================
+class FmaccSim : public VerilatedFixture<VtopFMA> {
+public:
+    FmaccSim(int argc, char* argv[]) : VerilatedFixture(argc, argv) {}
+
+    // Runs one chain, out[k] = result of op k. Returns false on timeout.
+    bool run(TestMode mode, bool forward, const Chain& ch, std::vector<uint32_t>& out);
+};
+
+bool FmaccSim::run(TestMode mode, bool forward, const Chain& ch, std::vector<uint32_t>& out) {
+    top_->io_is_fp32 = mode == TestMode::FP32;
+    top_->io_is_fp16 = mode == TestMode::FP16_Widen;
+    top_->io_is_bf16 = mode == TestMode::BF16_Widen;
+    top_->io_is_widen = mode != TestMode::FP32;
+    top_->eval();
+
+    const size_t n = ch.a.size();
+    size_t issued = 0, done = 0;
+    uint64_t wb_ready = 0; // writeback: first cycle the previous result can be read back as c_in
+    int idle = 0;
+    while (done < n) {
+        bool fire;
+        if (issued == 0) {
+            fire = true;
+        } else if (forward) {
+            fire = issued < n && top_->io_acc_ready;
+        } else {
+            fire = issued < n && done == issued && cycles() >= wb_ready;
+        }
+        if (fire) {
+            size_t k = issued++;
+            // Widen: the 16-bit operands go to the high half (VFMA_16_32 note 1)
+            if (mode == TestMode::FP32) {
+                top_->io_a_in_32 = ch.a[k];
+                top_->io_b_in_32 = ch.b[k];
+            } else {
+                top_->io_a_in_16_0 = 0;
+                top_->io_a_in_16_1 = ch.a[k];
+                top_->io_b_in_16_0 = 0;
+                top_->io_b_in_16_1 = ch.b[k];
+            }
+            top_->io_c_in_32 = k == 0 ? ch.c0 : out[k - 1];
+            top_->io_acc_fwd = forward && k > 0;
+        }
+        top_->io_valid_in = fire;
+        single_cycle();
+
+        if (top_->io_valid_out) {
+            out[done++] = top_->io_res_out_32;
+            wb_ready = cycles() + kDelayBias;
+            idle = 0;
+        } else if (++idle > 100) {
+            fprintf(stderr, "Timeout waiting for valid_out (%zu of %zu ops)\n", done, n);
+            top_->io_valid_in = 0;
+            return false;
+        }
+    }
+    top_->io_valid_in = 0;
+    top_->io_acc_fwd = 0;
+    return true;
+}
+
+// Dot-product style operands: Gaussian activations (every other chain with outlier
+// channels) times small Gaussian weights
+static void gen_chain(TestMode mode, size_t len, size_t idx, Chain& ch) {
+    FpFormat fmt = operand_format(mode);
+    const WorkloadParams mix[] = {workload_gaussian(1.0), workload_outliers(1.0, 256.0, 1.0 / 16)};
+    const WorkloadParams& p = mix[idx % 2];
+    ch.a.resize(len);
+    ch.b.resize(len);
+    for (size_t k = 0; k < len; ++k) {
+        uint32_t other;
+        gen_workload_pair(p, fmt, ch.a[k], other);
+        gen_workload_pair(workload_gaussian(1.0 / 16), fmt, ch.b[k], other);
+    }
+    uint32_t unused;
+    gen_workload_pair(workload_gaussian(1.0), FpFormat::FP32, ch.c0, unused);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n_chains = 200, len = 256;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--chains") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            n_chains = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--length") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            len = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else {
+            printf("Usage: %s [--chains <n>] [--length <ops per chain>] [--seed <s>]\n", argv[0]);
+            return 1;
+        }
+    }
+    srand(seed);
+    workload_seed(seed);
+
+    FmaccSim sim(argc, argv);
+    ResultChecker checker;
+    printf("topFMA accumulation chains: %zu chains x %zu dependent ops per mode\n", n_chains, len);
+
+    const TestMode modes[] = {TestMode::FP32, TestMode::BF16_Widen, TestMode::FP16_Widen};
+    uint64_t failures = 0;
+    for (TestMode mode : modes) {
+        std::vector<Chain> chains(n_chains);
+        for (size_t c = 0; c < n_chains; ++c) {
+            gen_chain(mode, len, c, chains[c]);
+        }
+
+        uint64_t cyc[2] = {0, 0};
+        uint64_t drift_sum = 0;
+        uint32_t drift_max = 0;
+        for (int forward = 1; forward >= 0; --forward) {
+            sim.reset();
+            auto t0 = std::chrono::steady_clock::now();
+            for (const Chain& ch : chains) {
+                std::vector<uint32_t> dut(len), ref(len), a(len), b(len);
+                uint64_t c0 = sim.cycles();
+                if (!sim.run(mode, forward, ch, dut)) {
+                    return 1;
+                }
+                cyc[forward] += sim.cycles() - c0;
+
+                // Per op: same c as the DUT saw, so errors do not compound in the check
+                uint32_t seq = ch.c0;
+                for (size_t k = 0; k < len; ++k) {
+                    uint32_t fa = to_fp32_bits(mode, ch.a[k]), fb = to_fp32_bits(mode, ch.b[k]);
+                    ref[k] = softfloat_fma_fp32(fa, fb, k == 0 ? ch.c0 : dut[k - 1]);
+                    seq = softfloat_fma_fp32(fa, fb, seq);
+                    a[k] = ch.a[k];
+                    b[k] = ch.b[k];
+                }
+                CheckInputs in = {a.data(), b.data(), dut.data(), ref.data()};
+                failures += checker.check_batch(mode, ErrorType::ULP, in, len);
+
+                if (forward) {
+                    uint32_t ulp = fp_ulp_distance(dut[len - 1], seq, FpFormat::FP32);
+                    if (ulp != UINT32_MAX) {
+                        drift_sum += ulp;
+                        drift_max = ulp > drift_max ? ulp : drift_max;
+                    }
+                }
+            }
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            if (forward) {
+                printf("%-11s forwarding: %.3f ops/cycle, %.2f M ops/s | final acc vs SoftFloat chain: "
+                       "mean %.1f ulp, max %u ulp\n", mode_name(mode), (double)(n_chains * len) / cyc[1],
+                       n_chains * len / secs / 1e6, (double)drift_sum / n_chains, drift_max);
+            } else {
+                printf("%-11s writeback:  %.3f ops/cycle (forwarding speedup %.2fx)\n", mode_name(mode),
+                       (double)(n_chains * len) / cyc[0], (double)cyc[0] / cyc[1]);
+            }
+        }
+    }
+
+    checker.report();
+    if (failures) {
+        printf("\n%llu ops out of tolerance.\n", (unsigned long long)failures);
+        return 1;
+    }
+    printf("\nAll chains passed.\n");
+    return 0;
+}
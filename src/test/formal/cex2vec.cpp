@@ -0,0 +1,207 @@
+// Turns a SymbiYosys counterexample trace (VCD of the miter) into directed test
+// vectors: the operands of every cycle with valid_in set, in the raw
+// little-endian layout of `top --replay <a> <b> --replay-mode <mode>`:
+//   fp32, fp16n/bf16n: a_in_32 | fp16/bf16: a_in_16_0, a_in_16_1 | fp16w/bf16w: a_in_16_1
+// topFMA traces also get a c file (c_in_32 for fp32 and the widening modes).
+// A text listing with the cycle of each op is written next to the binaries.
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Signal {
+    std::string name;
+    uint64_t value = 0;
+};
+
+// Minimal VCD reader: signals of the top scope only, sampled on the rising
+// edge of `clock` (every timestamp when the trace has no clock)
+class VcdReader {
+public:
+    bool open(const char* path) {
+        in_.open(path);
+        return (bool)in_;
+    }
+    // Calls on_cycle() once per sampled cycle, after the values of that step are applied
+    template <class Fn>
+    bool read(Fn on_cycle);
+    const Signal* find(const std::string& name) const {
+        for (const auto& kv : signals_) {
+            if (kv.second.name == name) return &kv.second;
+        }
+        return nullptr;
+    }
+
+private:
+    std::ifstream in_;
+    std::map<std::string, Signal> signals_; // by VCD id
+};
+
+template <class Fn>
+bool VcdReader::read(Fn on_cycle) {
+    std::string tok;
+    int depth = 0;
+    std::string clock_id;
+    // Header
+    while (in_ >> tok && tok != "$enddefinitions") {
+        if (tok == "$scope") {
+            depth++;
+        } else if (tok == "$upscope") {
+            depth--;
+        } else if (tok == "$var") {
+            std::string type, width, id, name;
+            in_ >> type >> width >> id >> name;
+            if (depth == 1) {
+                signals_[id].name = name;
+                if (name == "clock") clock_id = id;
+            }
+        }
+    }
+    if (!in_) return false;
+    in_ >> tok; // $end
+
+    bool clock = false, have_time = false;
+    auto set = [&](const std::string& id, uint64_t v) {
+        auto it = signals_.find(id);
+        if (it != signals_.end()) it->second.value = v;
+    };
+    auto end_of_step = [&]() {
+        if (!have_time) return;
+        if (clock_id.empty()) {
+            on_cycle();
+        } else {
+            bool now = signals_[clock_id].value & 1;
+            if (now && !clock) on_cycle();
+            clock = now;
+        }
+    };
+    while (in_ >> tok) {
+        if (tok[0] == '#') {
+            end_of_step();
+            have_time = true;
+        } else if (tok[0] == 'b' || tok[0] == 'B') {
+            std::string id;
+            in_ >> id;
+            uint64_t v = 0;
+            for (size_t i = 1; i < tok.size(); ++i) v = v << 1 | (tok[i] == '1');
+            set(id, v);
+        } else if (tok[0] == '0' || tok[0] == '1' || tok[0] == 'x' || tok[0] == 'z') {
+            set(tok.substr(1), tok[0] == '1');
+        }
+        // $dumpvars / $end and friends carry no values of their own
+    }
+    end_of_step();
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    static const char* kModes[] = {"fp32", "fp16", "bf16", "fp16w", "bf16w", "fp16n", "bf16n"};
+    int mode = -1;
+    if (argc == 4) {
+        for (int m = 0; m < 7; ++m) {
+            if (!strcmp(argv[2], kModes[m])) mode = m;
+        }
+    }
+    if (mode < 0) {
+        fprintf(stderr, "Usage: %s <trace.vcd> fp32|fp16|bf16|fp16w|bf16w|fp16n|bf16n <out prefix>\n", argv[0]);
+        return 1;
+    }
+    VcdReader vcd;
+    if (!vcd.open(argv[1])) {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    const bool two = mode == 1 || mode == 2;
+    std::vector<uint32_t> a32, b32, c32;
+    std::vector<uint16_t> a16, b16, c16;
+    std::ostringstream listing;
+    bool is_fma = false;
+    uint64_t cycle = 0, ops = 0;
+    bool ok = vcd.read([&]() {
+        const Signal* valid = vcd.find("valid_in");
+        is_fma = vcd.find("c_in_32") != nullptr;
+        auto val = [&](const char* name) {
+            const Signal* s = vcd.find(name);
+            return s ? s->value : 0;
+        };
+        if (valid && (valid->value & 1)) {
+            char line[160];
+            if (mode == 0 || mode >= 5) {
+                a32.push_back(val("a_in_32"));
+                b32.push_back(val("b_in_32"));
+                if (is_fma) c32.push_back(val("c_in_32"));
+                snprintf(line, sizeof(line), "cycle %llu: a=0x%08llX b=0x%08llX", (unsigned long long)cycle,
+                         (unsigned long long)val("a_in_32"), (unsigned long long)val("b_in_32"));
+            } else if (two) {
+                a16.push_back(val("a_in_16_0"));
+                a16.push_back(val("a_in_16_1"));
+                b16.push_back(val("b_in_16_0"));
+                b16.push_back(val("b_in_16_1"));
+                if (is_fma) {
+                    c16.push_back(val("c_in_16_0"));
+                    c16.push_back(val("c_in_16_1"));
+                }
+                snprintf(line, sizeof(line), "cycle %llu: a=0x%04llX,0x%04llX b=0x%04llX,0x%04llX",
+                         (unsigned long long)cycle, (unsigned long long)val("a_in_16_0"),
+                         (unsigned long long)val("a_in_16_1"), (unsigned long long)val("b_in_16_0"),
+                         (unsigned long long)val("b_in_16_1"));
+            } else {
+                a16.push_back(val("a_in_16_1"));
+                b16.push_back(val("b_in_16_1"));
+                if (is_fma) c32.push_back(val("c_in_32"));
+                snprintf(line, sizeof(line), "cycle %llu: a=0x%04llX b=0x%04llX", (unsigned long long)cycle,
+                         (unsigned long long)val("a_in_16_1"), (unsigned long long)val("b_in_16_1"));
+            }
+            listing << line;
+            if (is_fma) {
+                snprintf(line, sizeof(line), " c=0x%08llX",
+                         (unsigned long long)(two ? val("c_in_16_1") << 16 | val("c_in_16_0") : val("c_in_32")));
+                listing << line;
+            }
+            listing << "\n";
+            ops++;
+        }
+        cycle++;
+    });
+    if (!ok) {
+        fprintf(stderr, "%s: not a VCD file\n", argv[1]);
+        return 1;
+    }
+
+    const std::string prefix = argv[3];
+    auto write = [&](const std::string& path, const void* data, size_t bytes) {
+        std::ofstream out(path, std::ios::binary);
+        out.write((const char*)data, bytes);
+        return (bool)out;
+    };
+    bool written = true;
+    if (mode == 0 || mode >= 5) {
+        written &= write(prefix + "_a.bin", a32.data(), a32.size() * 4);
+        written &= write(prefix + "_b.bin", b32.data(), b32.size() * 4);
+    } else {
+        written &= write(prefix + "_a.bin", a16.data(), a16.size() * 2);
+        written &= write(prefix + "_b.bin", b16.data(), b16.size() * 2);
+    }
+    if (is_fma) {
+        written &= two ? write(prefix + "_c.bin", c16.data(), c16.size() * 2)
+                       : write(prefix + "_c.bin", c32.data(), c32.size() * 4);
+    }
+    std::ofstream txt(prefix + ".txt");
+    txt << listing.str();
+    if (!written || !txt) {
+        fprintf(stderr, "cannot write %s_*\n", prefix.c_str());
+        return 1;
+    }
+    printf("%s: %llu ops over %llu cycles -> %s_a.bin %s_b.bin%s (%s.txt)\n", kModes[mode],
+           (unsigned long long)ops, (unsigned long long)cycle, prefix.c_str(), prefix.c_str(),
+           is_fma ? " + _c.bin" : "", prefix.c_str());
+    if (!is_fma) {
+        printf("  replay: ./build/vfpu/top --replay %s_a.bin %s_b.bin --replay-mode %s\n", prefix.c_str(),
+               prefix.c_str(), kModes[mode]);
+    }
+    return 0;
+}
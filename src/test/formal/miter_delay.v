@@ -0,0 +1,20 @@
+// N-cycle delay line used by the miters to align outputs of variants with
+// different pipeline depths (N = 0: wire)
+module miter_delay #(
+  parameter N = 0,
+  parameter W = 33
+) (
+  input          clock,
+  input  [W-1:0] d,
+  output [W-1:0] q
+);
+  generate
+    if (N == 0) begin : g_wire
+      assign q = d;
+    end else begin : g_regs
+      reg [W*N-1:0] sr;
+      always @(posedge clock) sr <= (sr << W) | d;
+      assign q = sr[W*N-1 -: W];
+    end
+  endgenerate
+endmodule
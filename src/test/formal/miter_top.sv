@@ -0,0 +1,78 @@
+// Equivalence miter of two `top` variants (FAdd_16_32), renamed to gold / gate
+// by the formal target. MODE follows TestMode: 0 FP32, 1 FP16, 2 BF16,
+// 3 FP16_Widen, 4 BF16_Widen, 5 FP16_Narrow, 6 BF16_Narrow; the mode is fixed
+// for the whole trace. Both variants need the io_is_narrow and io_fflags_out_0/1
+// ports; fflags are compared like the result (unused slots are 0).
+// GOLD_DELAY / GATE_DELAY add output registers so that variants with different
+// pipeline depths are compared op by op. Outputs are checked once the
+// un-reset pipeline registers have been flushed (WARMUP cycles).
+module miter #(
+  parameter MODE = 0,
+  parameter GOLD_DELAY = 0,
+  parameter GATE_DELAY = 0,
+  parameter WARMUP = 8
+) (
+  input         clock,
+  input         valid_in,
+  input  [31:0] a_in_32,
+  input  [31:0] b_in_32,
+  input  [15:0] a_in_16_0,
+  input  [15:0] a_in_16_1,
+  input  [15:0] b_in_16_0,
+  input  [15:0] b_in_16_1
+);
+  wire is_fp32 = MODE == 0;
+  wire is_fp16 = MODE == 1 || MODE == 3 || MODE == 5;
+  wire is_bf16 = MODE == 2 || MODE == 4 || MODE == 6;
+  wire is_widen = MODE == 3 || MODE == 4;
+  wire is_narrow = MODE >= 5;
+
+  reg [7:0] cycle = 0;
+  always @(posedge clock) if (cycle != 8'hff) cycle <= cycle + 8'd1;
+  wire reset = cycle == 0;
+
+  // Widening ops take their 16-bit sources from lane 1, lane 0 is driven to zero (as the harness does)
+  always @(*) if (is_widen) assume(a_in_16_0 == 16'h0 && b_in_16_0 == 16'h0);
+
+  wire        gold_valid, gate_valid;
+  wire [31:0] gold_res, gate_res;
+  wire [4:0]  gold_fflags_0, gold_fflags_1, gate_fflags_0, gate_fflags_1;
+
+  gold gold_i (
+    .clock(clock), .reset(reset), .io_valid_in(valid_in),
+    .io_is_bf16(is_bf16), .io_is_fp16(is_fp16), .io_is_fp32(is_fp32),
+    .io_is_widen(is_widen), .io_a_already_widen(1'b0), .io_is_narrow(is_narrow),
+    .io_a_in_32(a_in_32), .io_b_in_32(b_in_32),
+    .io_a_in_16_0(a_in_16_0), .io_a_in_16_1(a_in_16_1),
+    .io_b_in_16_0(b_in_16_0), .io_b_in_16_1(b_in_16_1),
+    .io_res_out_32(gold_res), .io_fflags_out_0(gold_fflags_0), .io_fflags_out_1(gold_fflags_1),
+    .io_valid_out(gold_valid)
+  );
+  gate gate_i (
+    .clock(clock), .reset(reset), .io_valid_in(valid_in),
+    .io_is_bf16(is_bf16), .io_is_fp16(is_fp16), .io_is_fp32(is_fp32),
+    .io_is_widen(is_widen), .io_a_already_widen(1'b0), .io_is_narrow(is_narrow),
+    .io_a_in_32(a_in_32), .io_b_in_32(b_in_32),
+    .io_a_in_16_0(a_in_16_0), .io_a_in_16_1(a_in_16_1),
+    .io_b_in_16_0(b_in_16_0), .io_b_in_16_1(b_in_16_1),
+    .io_res_out_32(gate_res), .io_fflags_out_0(gate_fflags_0), .io_fflags_out_1(gate_fflags_1),
+    .io_valid_out(gate_valid)
+  );
+
+  // Latency alignment: {valid, fflags_1, fflags_0, res} through GOLD_DELAY / GATE_DELAY registers
+  wire [42:0] gold_out, gate_out;
+  miter_delay #(.N(GOLD_DELAY), .W(43)) gold_delay (.clock(clock),
+    .d({gold_valid, gold_fflags_1, gold_fflags_0, gold_res}), .q(gold_out));
+  miter_delay #(.N(GATE_DELAY), .W(43)) gate_delay (.clock(clock),
+    .d({gate_valid, gate_fflags_1, gate_fflags_0, gate_res}), .q(gate_out));
+
+  always @(*) begin
+    if (cycle >= WARMUP) begin
+      assert(gold_out[42] == gate_out[42]);
+      if (gold_out[42]) begin
+        assert(gold_out[31:0] == gate_out[31:0]);
+        assert(gold_out[41:32] == gate_out[41:32]); // NV DZ OF UF NX of both slots
+      end
+    end
+  end
+endmodule
@@ -0,0 +1,65 @@
+// Equivalence miter of two `topFMA` variants (VFMA_16_32), renamed to gold /
+// gate by the formal target. MODE follows TestMode (0 FP32, 1 FP16, 2 BF16,
+// 3 FP16_Widen, 4 BF16_Widen), fixed for the whole trace. acc_fwd is held low:
+// forwarding feeds res_out back and is covered by the fmacc harness. Delays and
+// warm-up as in miter_top.sv.
+module miter #(
+  parameter MODE = 0,
+  parameter GOLD_DELAY = 0,
+  parameter GATE_DELAY = 0,
+  parameter WARMUP = 8
+) (
+  input         clock,
+  input         valid_in,
+  input  [31:0] a_in_32,
+  input  [31:0] b_in_32,
+  input  [31:0] c_in_32,
+  input  [15:0] a_in_16_0,
+  input  [15:0] a_in_16_1,
+  input  [15:0] b_in_16_0,
+  input  [15:0] b_in_16_1,
+  input  [15:0] c_in_16_0,
+  input  [15:0] c_in_16_1
+);
+  wire is_fp32 = MODE == 0;
+  wire is_fp16 = MODE == 1 || MODE == 3;
+  wire is_bf16 = MODE == 2 || MODE == 4;
+  wire is_widen = MODE >= 3;
+
+  reg [7:0] cycle = 0;
+  always @(posedge clock) if (cycle != 8'hff) cycle <= cycle + 8'd1;
+  wire reset = cycle == 0;
+
+  wire        gold_valid, gate_valid;
+  wire [31:0] gold_res, gate_res;
+
+  gold gold_i (
+    .clock(clock), .reset(reset), .io_valid_in(valid_in),
+    .io_is_bf16(is_bf16), .io_is_fp16(is_fp16), .io_is_fp32(is_fp32), .io_is_widen(is_widen),
+    .io_a_in_32(a_in_32), .io_b_in_32(b_in_32), .io_c_in_32(c_in_32),
+    .io_a_in_16_0(a_in_16_0), .io_a_in_16_1(a_in_16_1),
+    .io_b_in_16_0(b_in_16_0), .io_b_in_16_1(b_in_16_1),
+    .io_c_in_16_0(c_in_16_0), .io_c_in_16_1(c_in_16_1), .io_acc_fwd(1'b0),
+    .io_res_out_32(gold_res), .io_valid_out(gold_valid)
+  );
+  gate gate_i (
+    .clock(clock), .reset(reset), .io_valid_in(valid_in),
+    .io_is_bf16(is_bf16), .io_is_fp16(is_fp16), .io_is_fp32(is_fp32), .io_is_widen(is_widen),
+    .io_a_in_32(a_in_32), .io_b_in_32(b_in_32), .io_c_in_32(c_in_32),
+    .io_a_in_16_0(a_in_16_0), .io_a_in_16_1(a_in_16_1),
+    .io_b_in_16_0(b_in_16_0), .io_b_in_16_1(b_in_16_1),
+    .io_c_in_16_0(c_in_16_0), .io_c_in_16_1(c_in_16_1), .io_acc_fwd(1'b0),
+    .io_res_out_32(gate_res), .io_valid_out(gate_valid)
+  );
+
+  wire [32:0] gold_out, gate_out;
+  miter_delay #(.N(GOLD_DELAY)) gold_delay (.clock(clock), .d({gold_valid, gold_res}), .q(gold_out));
+  miter_delay #(.N(GATE_DELAY)) gate_delay (.clock(clock), .d({gate_valid, gate_res}), .q(gate_out));
+
+  always @(*) begin
+    if (cycle >= WARMUP) begin
+      assert(gold_out[32] == gate_out[32]);
+      if (gold_out[32]) assert(gold_out[31:0] == gate_out[31:0]);
+    end
+  end
+endmodule
@@ -0,0 +1,395 @@
+// topLane harness, sew = 64: FP64 vfadd / vfsub / vfrsub on FAdd_64 and the FP64
+// compare / min / max / sign injection / move on the fast path of VFAddWrapper.
+//   latency   vfadd and vfmin issued alone: faddDelay and fcmpDelay cycles after
+//             issue (+1 for the output register of VFAddWrapper)
+//   suites    a + b as vfadd / vfsub / vfrsub (.vv and .vf), one op per cycle, by
+//             exponent range of a and b:
+//             directed cases, near 1, cancellation, exponent gaps 1 .. 60, gaps
+//             beyond the significand, subnormal, overflow, full range and any
+//             bit pattern.
+//             vd and fflags are checked exactly against SoftFloat f64_add (any NaN
+//             encoding is accepted for a NaN result)
+//   fast      random fast-path ops against an RVV model on doubles
+// The 32-bit modes of the lane are covered by the lane harness.
+#include "softfloat_ref.h"
+#include "verilated_fixture.h"
+#include "VtopLane.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <random>
+#include <vector>
+
+enum class OpKind { Add, Sub, RSub, Min, Max, Sgnj, SgnjN, SgnjX, Eq, Le, Lt, Ne, Gt, Ge, Move };
+
+struct OpInfo {
+    const char* name;
+    uint8_t funct6;
+    bool vf_only;
+    OpKind kind;
+};
+
+static const OpInfo kAddOps[] = {
+    {"vfadd", 0x00, false, OpKind::Add}, {"vfsub", 0x02, false, OpKind::Sub}, {"vfrsub", 0x27, true, OpKind::RSub},
+};
+static const OpInfo kFastOps[] = {
+    {"vfmin", 0x04, false, OpKind::Min},     {"vfmax", 0x06, false, OpKind::Max},
+    {"vfsgnj", 0x08, false, OpKind::Sgnj},   {"vfsgnjn", 0x09, false, OpKind::SgnjN},
+    {"vfsgnjx", 0x0a, false, OpKind::SgnjX}, {"vmfeq", 0x18, false, OpKind::Eq},
+    {"vmfle", 0x19, false, OpKind::Le},      {"vmflt", 0x1b, false, OpKind::Lt},
+    {"vmfne", 0x1c, false, OpKind::Ne},      {"vmfgt", 0x1d, true, OpKind::Gt},
+    {"vmfge", 0x1f, true, OpKind::Ge},       {"vfmv.v.f", 0x17, true, OpKind::Move},
+};
+static const int kNumAddOps = sizeof(kAddOps) / sizeof(kAddOps[0]);
+static const int kNumFastOps = sizeof(kFastOps) / sizeof(kFastOps[0]);
+
+static const uint8_t kVsewFp64 = 3;
+static const uint64_t kSign = 0x8000000000000000ull;
+static const uint64_t kExpMask = 0x7ff0000000000000ull;
+static const uint64_t kFracMask = 0x000fffffffffffffull;
+static const uint64_t kQNaN = 0x7ff8000000000000ull;
+
+static bool is_nan(uint64_t x) { return (x & kExpMask) == kExpMask && (x & kFracMask); }
+static bool is_snan(uint64_t x) { return is_nan(x) && !(x >> 51 & 1); }
+static double to_double(uint64_t x) {
+    double d;
+    memcpy(&d, &x, sizeof(d));
+    return d;
+}
+
+// One lane op: vd = vs2 op vs1 (or rs1), one FP64 element
+struct LaneOp {
+    const OpInfo* info;
+    bool vf;
+    uint64_t vs2, vs1;
+};
+
+struct LaneResult {
+    uint64_t vd;
+    uint8_t fflags;
+};
+
+// ===================================================================
+// Reference
+// ===================================================================
+static LaneResult ref_op(const LaneOp& op) {
+    const uint64_t x = op.vs2, y = op.vs1;
+    const bool x_nan = is_nan(x), y_nan = is_nan(y);
+    const bool any_snan = is_snan(x) || is_snan(y);
+    const double dx = to_double(x), dy = to_double(y);
+    LaneResult r = {0, 0};
+    switch (op.info->kind) {
+        case OpKind::Add:  r.vd = softfloat_add_fp64(x, y, &r.fflags); break;
+        case OpKind::Sub:  r.vd = softfloat_add_fp64(x, y ^ kSign, &r.fflags); break;
+        case OpKind::RSub: r.vd = softfloat_add_fp64(x ^ kSign, y, &r.fflags); break;
+        case OpKind::Sgnj:  r.vd = (x & ~kSign) | (y & kSign); break;
+        case OpKind::SgnjN: r.vd = (x & ~kSign) | (~y & kSign); break;
+        case OpKind::SgnjX: r.vd = x ^ (y & kSign); break;
+        case OpKind::Move:  r.vd = y; break;
+        case OpKind::Min:
+        case OpKind::Max: {
+            r.fflags = any_snan ? kFlagNV : 0;
+            bool x_lt = dx < dy || (dx == dy && (x & kSign) && !(y & kSign)); // -0 < +0
+            r.vd = x_nan && y_nan ? kQNaN : x_nan ? y : y_nan ? x : (op.info->kind == OpKind::Min) == x_lt ? x : y;
+            break;
+        }
+        default: {
+            bool ordered = !x_nan && !y_nan;
+            OpKind k = op.info->kind;
+            r.fflags = (k == OpKind::Eq || k == OpKind::Ne ? any_snan : !ordered) ? kFlagNV : 0;
+            switch (k) {
+                case OpKind::Eq: r.vd = dx == dy; break;
+                case OpKind::Ne: r.vd = !(dx == dy); break;
+                case OpKind::Lt: r.vd = dx < dy; break;
+                case OpKind::Le: r.vd = dx <= dy; break;
+                case OpKind::Gt: r.vd = dx > dy; break;
+                default:         r.vd = dx >= dy; break;
+            }
+        }
+    }
+    return r;
+}
+
+// ===================================================================
+// Fp64Sim: 驱动 topLane, vsew = 64
+// ===================================================================
+class Fp64Sim : public VerilatedFixture<VtopLane> {
+public:
+    Fp64Sim(int argc, char* argv[]) : VerilatedFixture(argc, argv) { reset(); }
+
+    void poke(const LaneOp& op) {
+        top_->io_funct6 = op.info->funct6;
+        top_->io_funct3 = op.vf ? 5 : 1;
+        top_->io_vm = 1;
+        top_->io_widen = 0;
+        top_->io_widen2 = 0;
+        top_->io_narrow = 0;
+        top_->io_uop_idx = 0;
+        top_->io_vsew = kVsewFp64;
+        top_->io_vs1 = op.vf ? 0 : op.vs1;
+        top_->io_vs2 = op.vs2;
+        top_->io_vs3 = 0;
+        top_->io_rs1 = op.vf ? op.vs1 : 0;
+    }
+    LaneResult peek() const { return {top_->io_vd, top_->io_fflags_out_0}; }
+    // fflags of the other 16-bit slots must stay 0 for a single FP64 element
+    bool others_clear() const { return !top_->io_fflags_out_1 && !top_->io_fflags_out_2 && !top_->io_fflags_out_3; }
+    // Cycles from issuing op alone until valid_out, -1 on timeout
+    int measure_latency(const LaneOp& op) {
+        poke(op);
+        return single_op_latency();
+    }
+};
+
+// ===================================================================
+// Operands
+// ===================================================================
+static std::mt19937_64 rng;
+
+// Random sign and fraction, unbiased exponent in [lo, hi]. Exponents below -1022
+// give subnormals (biased exponent 0), 1024 gives Inf / NaN.
+static uint64_t gen_fp64(int lo, int hi) {
+    int e = lo + (int)(rng() % (uint64_t)(hi - lo + 1));
+    uint64_t biased = e < -1022 ? 0 : (uint64_t)(e + 1023);
+    return (rng() & kSign) | biased << 52 | (rng() & kFracMask);
+}
+
+static int unbiased_exp(uint64_t x) {
+    int biased = (int)(x >> 52 & 0x7ff);
+    return biased ? biased - 1023 : -1022;
+}
+
+static uint64_t gen_special() {
+    switch (rng() % 8) {
+        case 0:  return 0;
+        case 1:  return kSign;                          // -0
+        case 2:  return kExpMask;                       // +inf
+        case 3:  return kExpMask | kSign;               // -inf
+        case 4:  return kQNaN | (rng() & kSign);        // qNaN
+        case 5:  return kExpMask | 1;                   // sNaN
+        case 6:  return 1;                              // min subnormal
+        default: return kExpMask - 1;                   // max normal
+    }
+}
+
+struct Suite {
+    const char* name;
+    std::function<void(uint64_t&, uint64_t&)> gen; // vs2, vs1
+};
+
+static std::vector<std::pair<uint64_t, uint64_t>> directed_cases() {
+    return {
+        {0x3ff0000000000000ull, 0x4000000000000000ull}, // 1 + 2 = 3
+        {0x3ff0000000000000ull, 0xbff0000000000000ull}, // 1 + -1 = +0
+        {0x8000000000000000ull, 0x8000000000000000ull}, // -0 + -0 = -0
+        {0x3ff0000000000000ull, 0x3ca0000000000000ull}, // 1 + 2^-53: tie, even -> 1 (NX)
+        {0x3ff0000000000001ull, 0x3ca0000000000000ull}, // 1+ulp + 2^-53: tie, odd -> 1+2ulp (NX)
+        {0x3ff0000000000000ull, 0x3ca0000000000001ull}, // 1 + (2^-53 + tiny): above the tie (NX)
+        {0x3ff0000000000000ull, 0xbc90000000000000ull}, // 1 - 2^-54 (NX)
+        {0x4340000000000000ull, 0xbff0000000000000ull}, // 2^53 - 1, exact
+        {0x7fefffffffffffffull, 0x7fefffffffffffffull}, // max + max -> Inf (OF NX)
+        {0x7fefffffffffffffull, 0x7c9fffffffffffffull}, // max + just below half an ulp -> max (NX)
+        {0x7fefffffffffffffull, 0x7ca0000000000000ull}, // max + half an ulp: tie -> Inf (OF NX)
+        {0x0010000000000000ull, 0x8000000000000001ull}, // min normal - min subnormal -> subnormal, exact
+        {0x000fffffffffffffull, 0x0000000000000001ull}, // max subnormal + min subnormal -> min normal
+        {0x0000000000000001ull, 0x8000000000000001ull}, // min subnormal - min subnormal = +0
+        {0x7ff0000000000000ull, 0xfff0000000000000ull}, // Inf - Inf = NaN (NV)
+        {0x7ff0000000000000ull, 0x7ff0000000000000ull}, // Inf + Inf = Inf
+        {0x7ff0000000000000ull, 0x3ff0000000000000ull}, // Inf + 1 = Inf
+        {0x7ff4000000000000ull, 0x3ff0000000000000ull}, // sNaN + 1 (NV)
+        {0x7ff8000000000000ull, 0x3ff0000000000000ull}, // qNaN + 1
+        {0x3ff0000000000000ull, 0x0000000000000001ull}, // 1 + min subnormal (NX)
+    };
+}
+
+static std::vector<Suite> make_suites() {
+    return {
+        {"near_one", [](uint64_t& a, uint64_t& b) { a = gen_fp64(-10, 10); b = gen_fp64(-10, 10); }},
+        {"cancellation", [](uint64_t& a, uint64_t& b) {
+            // same exponent, opposite signs, low fraction bits differ
+            a = gen_fp64(-20, 20);
+            b = (a ^ kSign) ^ (rng() & ((1ull << (rng() % 53)) - 1));
+        }},
+        {"gap_1_60", [](uint64_t& a, uint64_t& b) {
+            a = gen_fp64(-5, 5);
+            int d = 1 + (int)(rng() % 60);
+            b = gen_fp64(unbiased_exp(a) - d, unbiased_exp(a) - d);
+            if (rng() & 1) std::swap(a, b);
+        }},
+        {"gap_54_1000", [](uint64_t& a, uint64_t& b) {
+            a = gen_fp64(-5, 5);
+            int d = 54 + (int)(rng() % 947);
+            b = gen_fp64(unbiased_exp(a) - d, unbiased_exp(a) - d);
+            if (rng() & 1) std::swap(a, b);
+        }},
+        {"subnormal", [](uint64_t& a, uint64_t& b) { a = gen_fp64(-1074, -1000); b = gen_fp64(-1074, -1000); }},
+        {"overflow", [](uint64_t& a, uint64_t& b) { a = gen_fp64(1000, 1023); b = gen_fp64(1000, 1023); }},
+        {"full_range", [](uint64_t& a, uint64_t& b) { a = gen_fp64(-1074, 1023); b = gen_fp64(-1074, 1023); }},
+        {"any", [](uint64_t& a, uint64_t& b) {
+            a = rng() % 16 ? rng() : gen_special();
+            b = rng() % 16 ? rng() : gen_special();
+        }},
+    };
+}
+
+// ===================================================================
+// Tests
+// ===================================================================
+static bool test_latency(Fp64Sim& sim, int& lat_add, int& lat_fast) {
+    VtopLane* top = sim.top();
+    const int fadd = top->io_fadd_delay, fcmp = top->io_fcmp_delay, bias = top->io_delay_bias;
+    const int exp_add = fadd - bias + 1, exp_fast = fcmp - bias + 1;
+    lat_add = sim.measure_latency({&kAddOps[0], false, 0x3ff0000000000000ull, 0x3ff0000000000000ull});
+    lat_fast = sim.measure_latency({&kFastOps[0], false, 0x3ff0000000000000ull, 0x3ff0000000000000ull});
+    printf("Latency (issue alone, VParams faddDelay=%d fcmpDelay=%d delayBias=%d, +1 output register):\n",
+           fadd, fcmp, bias);
+    printf("  vfadd fp64 %2d cycles%s\n", lat_add, lat_add == exp_add ? "" : "  <-- MISMATCH");
+    printf("  vfmin fp64 %2d cycles%s\n", lat_fast, lat_fast == exp_fast ? "" : "  <-- MISMATCH");
+    return lat_add == exp_add && lat_fast == exp_fast;
+}
+
+// Streams ops one per cycle (all of the same latency, so the write-back slot is
+// always free) and checks every result. Returns the number of mismatches.
+static uint64_t run_ops(Fp64Sim& sim, const char* name, const std::vector<LaneOp>& ops) {
+    VtopLane* top = sim.top();
+    std::deque<const LaneOp*> inflight;
+    uint64_t failures = 0, flag_count[5] = {};
+    size_t issued = 0;
+    int idle = 0;
+    while (issued < ops.size() || !inflight.empty()) {
+        if (issued < ops.size()) {
+            sim.poke(ops[issued]);
+            inflight.push_back(&ops[issued++]);
+            top->io_valid_in = 1;
+        } else {
+            top->io_valid_in = 0;
+        }
+        sim.single_cycle();
+        if (!top->io_valid_out) {
+            if (++idle > 100) {
+                printf("  %s: timeout waiting for valid_out (%zu results missing)\n", name, inflight.size());
+                top->io_valid_in = 0;
+                return failures + inflight.size();
+            }
+            continue;
+        }
+        idle = 0;
+        if (inflight.empty()) {
+            printf("  %s: valid_out without an op in flight\n", name);
+            top->io_valid_in = 0;
+            return failures + 1;
+        }
+        const LaneOp& op = *inflight.front();
+        inflight.pop_front();
+        LaneResult ref = ref_op(op), dut = sim.peek();
+        bool nan_ok = (op.info->kind == OpKind::Add || op.info->kind == OpKind::Sub || op.info->kind == OpKind::RSub) &&
+                      is_nan(ref.vd) && is_nan(dut.vd);
+        bool ok = (dut.vd == ref.vd || nan_ok) && dut.fflags == ref.fflags && sim.others_clear() &&
+                  top->io_funct6_out == op.info->funct6;
+        for (int f = 0; f < 5; ++f) flag_count[f] += ref.fflags >> f & 1;
+        if (!ok) {
+            if (failures < 10) {
+                char fd[16], fr[16];
+                printf("  %s %s%s vs2 %016llx %s %016llx: vd %016llx %s, expected %016llx %s\n", name,
+                       op.info->name, op.vf ? ".vf" : ".vv", (unsigned long long)op.vs2, op.vf ? "rs1" : "vs1",
+                       (unsigned long long)op.vs1, (unsigned long long)dut.vd, fflags_str(dut.fflags, fd),
+                       (unsigned long long)ref.vd, fflags_str(ref.fflags, fr));
+            }
+            ++failures;
+        }
+    }
+    top->io_valid_in = 0;
+    printf("  %-13s %9zu ops, %llu mismatches  (reference NV %llu OF %llu UF %llu NX %llu)\n", name, ops.size(),
+           (unsigned long long)failures, (unsigned long long)flag_count[4], (unsigned long long)flag_count[2],
+           (unsigned long long)flag_count[1], (unsigned long long)flag_count[0]);
+    return failures;
+}
+
+// The op of info that computes a + b: vfsub gets -b, vfrsub -a
+static LaneOp add_op(const OpInfo* info, uint64_t a, uint64_t b) {
+    bool vf = info->vf_only || rng() % 4 == 0;
+    switch (info->kind) {
+        case OpKind::Sub:  return {info, vf, a, b ^ kSign};
+        case OpKind::RSub: return {info, vf, a ^ kSign, b};
+        default:           return {info, vf, a, b};
+    }
+}
+
+static uint64_t test_suites(Fp64Sim& sim, size_t n_tests) {
+    printf("FP64 add / sub (SoftFloat f64_add):\n");
+    uint64_t failures = 0;
+    std::vector<LaneOp> ops;
+    for (const auto& ab : directed_cases()) {
+        for (int k = 0; k < kNumAddOps; ++k) {
+            ops.push_back(add_op(&kAddOps[k], ab.first, ab.second));
+            ops.push_back(add_op(&kAddOps[k], ab.second, ab.first));
+        }
+    }
+    failures += run_ops(sim, "directed", ops);
+    for (const Suite& s : make_suites()) {
+        ops.clear();
+        for (size_t i = 0; i < n_tests; ++i) {
+            uint64_t a, b;
+            s.gen(a, b);
+            ops.push_back(add_op(&kAddOps[rng() % kNumAddOps], a, b));
+        }
+        failures += run_ops(sim, s.name, ops);
+    }
+    return failures;
+}
+
+static uint64_t test_fast(Fp64Sim& sim, size_t n_tests) {
+    printf("FP64 fast path (compare / min / max / sgnj / move):\n");
+    std::vector<LaneOp> ops;
+    for (size_t i = 0; i < n_tests; ++i) {
+        const OpInfo* info = &kFastOps[rng() % kNumFastOps];
+        uint64_t x = rng() % 4 ? gen_fp64(-1074, 1023) : gen_special();
+        uint64_t y;
+        switch (rng() % 4) {
+            case 0:  y = x; break;
+            case 1:  y = x ^ kSign; break;
+            case 2:  y = gen_special(); break;
+            default: y = gen_fp64(unbiased_exp(x) - 2, unbiased_exp(x) + 2); break;
+        }
+        ops.push_back({info, info->vf_only || rng() % 4 == 0, x, y});
+    }
+    return run_ops(sim, "fast_ops", ops);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n_tests = 100000;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--tests") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            n_tests = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else {
+            printf("Usage: %s [--tests <random ops per suite>] [--seed <s>]\n", argv[0]);
+            return 1;
+        }
+    }
+    rng.seed(seed);
+
+    Fp64Sim sim(argc, argv);
+    int lat_add, lat_fast;
+    if (!test_latency(sim, lat_add, lat_fast)) {
+        printf("\nVFAddWrapper FP64 latency does not match VParams.\n");
+        return 1;
+    }
+
+    uint64_t c0 = sim.cycles();
+    uint64_t failures = test_suites(sim, n_tests) + test_fast(sim, n_tests);
+    printf("%llu cycles simulated\n", (unsigned long long)(sim.cycles() - c0));
+    if (failures) {
+        printf("\n%llu FP64 ops differ from the reference.\n", (unsigned long long)failures);
+        return 1;
+    }
+    printf("\nAll FP64 ops passed.\n");
+    return 0;
+}
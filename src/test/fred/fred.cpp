@@ -0,0 +1,279 @@
+// topFRed harness: vfredusum / vfredosum (and the widening forms) over one
+// VLEN-bit vector register. Results are checked against a SoftFloat model
+// that adds in the same order as the hardware (tree or sequential); the
+// unordered latency must match the VParams budget.
+#include "fp_utils.h"
+#include "softfloat_ref.h"
+#include "result_checker.h"
+#include "workload_dist.h"
+#include "verilated_fixture.h"
+#include "VtopFRed.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const int kVlen = 1024;         // VParams.VLEN
+static const int kWords = kVlen / 32;
+static const int kRedModes = 5;  // fp32 .. bf16w, no narrowing reductions
+// VParams: fredFp16Delay = fredFp32Delay = (log2Up(VLEN/32) + 2) * (faddStages - 1) + delayBias
+static const int kDelayBias = 1;
+static const int kFaddStages = 3;
+static const int kFredFp16Delay = (5 + 2) * (kFaddStages - 1) + kDelayBias;
+static const int kFredFp32Delay = kFredFp16Delay;
+
+static int elems_per_vector(TestMode mode) {
+    return mode == TestMode::FP32 ? kVlen / 32 : kVlen / 16;
+}
+
+// One reduction: vd[0] = sum(vs2[*]) + vs1[0]
+struct RedOp {
+    uint32_t vs2[kVlen / 16]; // elements in operand format
+    uint32_t vs1;             // in result format
+};
+
+// ===================================================================
+// SoftFloat model, same association as VFRed
+// ===================================================================
+static uint32_t add(TestMode mode, uint32_t a, uint32_t b) {
+    switch (mode) {
+        case TestMode::FP16: return softfloat_add_fp16(a, b);
+        case TestMode::BF16: return softfloat_add_bf16(a, b);
+        default:             return softfloat_add_fp32(a, b);
+    }
+}
+
+static uint32_t widen(TestMode mode, uint32_t h) {
+    float f = mode == TestMode::FP16_Widen ? fp16_to_fp32(h) : bf16_to_fp32(h);
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+static bool is_widen(TestMode mode) {
+    return mode == TestMode::FP16_Widen || mode == TestMode::BF16_Widen;
+}
+
+static uint32_t ref_unordered(TestMode mode, const RedOp& op) {
+    int n = elems_per_vector(mode);
+    uint32_t s[kVlen / 16];
+    if (is_widen(mode)) {
+        // Level 0 widens: elem i + elem i + n/2 in fp32
+        n /= 2;
+        for (int i = 0; i < n; ++i) {
+            s[i] = softfloat_add_fp32(widen(mode, op.vs2[i]), widen(mode, op.vs2[i + n]));
+        }
+    } else {
+        memcpy(s, op.vs2, n * sizeof(uint32_t));
+    }
+    for (; n > 1; n /= 2) {
+        for (int i = 0; i < n / 2; ++i) {
+            s[i] = add(mode, s[i], s[i + n / 2]);
+        }
+    }
+    if (mode == TestMode::FP32) {
+        s[0] = add(mode, s[0], 0x80000000u); // FP32 passes the half-word level as x + -0
+    }
+    return add(mode, s[0], op.vs1);
+}
+
+static uint32_t ref_ordered(TestMode mode, const RedOp& op) {
+    uint32_t acc = op.vs1;
+    for (int i = 0; i < elems_per_vector(mode); ++i) {
+        acc = is_widen(mode) ? softfloat_add_fp32(acc, widen(mode, op.vs2[i])) : add(mode, acc, op.vs2[i]);
+    }
+    return acc;
+}
+
+// Sum in long double rounded once to the result format (accuracy comparison only)
+static uint32_t exact_sum(TestMode mode, const RedOp& op) {
+    FpFormat in = operand_format(mode), out = result_format(mode);
+    long double sum = fp_to_double(op.vs1, out);
+    for (int i = 0; i < elems_per_vector(mode); ++i) {
+        sum += fp_to_double(op.vs2[i], in);
+    }
+    float f = (float)sum;
+    if (out == FpFormat::FP16) return fp32_to_fp16(f);
+    if (out == FpFormat::BF16) return fp32_to_bf16(f);
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// Widening modes: fp32 -> 16b operand format; otherwise unchanged
+static uint32_t to_operand_format(TestMode mode, uint32_t bits) {
+    if (!is_widen(mode)) return bits;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return mode == TestMode::FP16_Widen ? fp32_to_fp16(f) : fp32_to_bf16(f);
+}
+
+// ===================================================================
+// FRedSim: 驱动 topFRed
+// ===================================================================
+class FRedSim : public VerilatedFixture<VtopFRed> {
+public:
+    FRedSim(int argc, char* argv[]) : VerilatedFixture(argc, argv) {}
+
+    // Issues every op as soon as ready is high and collects the results in
+    // order. Returns the number of results (< ops.size() only on timeout).
+    size_t run(TestMode mode, bool ordered, const std::vector<RedOp>& ops, std::vector<uint32_t>& out);
+    uint64_t latency() const { return latency_; }
+
+private:
+    void poke(TestMode mode, const RedOp& op);
+
+    uint64_t latency_ = 0;
+};
+
+void FRedSim::poke(TestMode mode, const RedOp& op) {
+    for (int w = 0; w < kWords; ++w) {
+        top_->io_vs2[w] = mode == TestMode::FP32 ? op.vs2[w] : op.vs2[2 * w] | op.vs2[2 * w + 1] << 16;
+    }
+    top_->io_vs1 = op.vs1;
+}
+
+size_t FRedSim::run(TestMode mode, bool ordered, const std::vector<RedOp>& ops, std::vector<uint32_t>& out) {
+    reset();
+
+    top_->io_is_fp32 = mode == TestMode::FP32;
+    top_->io_is_fp16 = mode == TestMode::FP16 || mode == TestMode::FP16_Widen;
+    top_->io_is_bf16 = mode == TestMode::BF16 || mode == TestMode::BF16_Widen;
+    top_->io_is_widen = is_widen(mode);
+    top_->io_is_ordered = ordered;
+    top_->eval();
+
+    const int timeout = 4 * kVlen; // ordered fp16: 2 cycles per element
+    size_t issued = 0, done = 0;
+    uint64_t first_issue = 0;
+    int idle = 0;
+    latency_ = 0;
+    while (done < ops.size()) {
+        bool fire = issued < ops.size() && top_->io_ready;
+        if (fire) {
+            if (issued == 0) first_issue = cycles();
+            poke(mode, ops[issued++]);
+        }
+        top_->io_valid_in = fire;
+        single_cycle();
+
+        if (top_->io_valid_out) {
+            if (done == 0) latency_ = cycles() - first_issue;
+            out[done++] = top_->io_res_out;
+            idle = 0;
+        } else if (++idle > timeout) {
+            fprintf(stderr, "Timeout waiting for valid_out (%zu of %zu reductions)\n", done, ops.size());
+            break;
+        }
+    }
+    top_->io_valid_in = 0;
+    return done;
+}
+
+static void gen_ops(TestMode mode, std::vector<RedOp>& ops) {
+    FpFormat in = operand_format(mode), out = result_format(mode);
+    // softmax denominators (log-normal, all positive), layer-norm sums (Gaussian), residual cancellation
+    const WorkloadParams mix[] = {
+        workload_gaussian(1.0), workload_log_normal(1.0, 3.0), workload_cancelling(1.0, 6),
+    };
+    for (size_t k = 0; k < ops.size(); ++k) {
+        const WorkloadParams& p = mix[k % 3];
+        RedOp& op = ops[k];
+        for (int i = 0; i < elems_per_vector(mode); i += 2) {
+            gen_workload_pair(p, in, op.vs2[i], op.vs2[i + 1]);
+            if (p.dist == WorkloadDist::LogNormal) {
+                op.vs2[i] &= ~(in == FpFormat::FP32 ? 0x80000000u : 0x8000u);
+                op.vs2[i + 1] &= ~(in == FpFormat::FP32 ? 0x80000000u : 0x8000u);
+            }
+        }
+        uint32_t unused;
+        gen_workload_pair(workload_gaussian(1.0), out, op.vs1, unused);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t n_ops = 1000;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--reductions") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            n_ops = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else {
+            printf("Usage: %s [--reductions <n>] [--seed <s>]\n", argv[0]);
+            return 1;
+        }
+    }
+    srand(seed);
+    workload_seed(seed);
+
+    FRedSim sim(argc, argv);
+    ResultChecker checker;
+    printf("topFRed: VLEN=%d, %zu reductions per mode; budget fredFp16Delay=%d fredFp32Delay=%d "
+           "(incl. delayBias=%d)\n", kVlen, n_ops, kFredFp16Delay, kFredFp32Delay, kDelayBias);
+
+    uint64_t failures = 0;
+    int latency_mismatches = 0;
+    for (int m = 0; m < kRedModes; ++m) {
+        TestMode mode = (TestMode)m;
+        std::vector<RedOp> ops(n_ops);
+        gen_ops(mode, ops);
+        FpFormat out_fmt = result_format(mode);
+        int budget = out_fmt == FpFormat::FP32 && !is_widen(mode) ? kFredFp32Delay : kFredFp16Delay;
+
+        for (int ordered = 0; ordered < 2; ++ordered) {
+            std::vector<uint32_t> dut(n_ops), ref(n_ops), a(n_ops), b(n_ops);
+            uint64_t c0 = sim.cycles();
+            auto t0 = std::chrono::steady_clock::now();
+            size_t done = sim.run(mode, ordered, ops, dut);
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            uint64_t cyc = sim.cycles() - c0;
+            if (done != n_ops) {
+                return 1;
+            }
+
+            // The relative error is taken against |exact sum| (passed as both "operands")
+            uint64_t ulp_sum = 0;
+            uint32_t ulp_max = 0;
+            for (size_t k = 0; k < n_ops; ++k) {
+                ref[k] = ordered ? ref_ordered(mode, ops[k]) : ref_unordered(mode, ops[k]);
+                uint32_t exact = exact_sum(mode, ops[k]);
+                a[k] = b[k] = to_operand_format(mode, exact);
+                uint32_t ulp = fp_ulp_distance(dut[k], exact, out_fmt);
+                if (ulp != UINT32_MAX) {
+                    ulp_sum += ulp;
+                    ulp_max = ulp > ulp_max ? ulp : ulp_max;
+                }
+            }
+            CheckInputs in = {a.data(), b.data(), dut.data(), ref.data()};
+            failures += checker.check_batch(mode, ErrorType::ULP, in, n_ops);
+
+            printf("%-11s %-9s latency %3llu cycles (budget %d) | %.2f cycles/reduction, %.1f k reductions/s"
+                   " | vs exact sum: mean %.1f ulp, max %u ulp\n",
+                   mode_name(mode), ordered ? "ordered" : "unordered", (unsigned long long)sim.latency(), budget,
+                   (double)cyc / n_ops, n_ops / secs / 1e3, (double)ulp_sum / n_ops, ulp_max);
+            // The ordered form is sequential per element and has no fixed budget
+            if (!ordered && (int)sim.latency() + kDelayBias != budget) {
+                printf("  latency mismatch: RTL %llu + delayBias %d != budget %d\n",
+                       (unsigned long long)sim.latency(), kDelayBias, budget);
+                ++latency_mismatches;
+            }
+        }
+    }
+
+    checker.report();
+    if (failures) {
+        printf("\n%llu reductions differ from the reference.\n", (unsigned long long)failures);
+        return 1;
+    }
+    if (latency_mismatches) {
+        printf("\n%d unordered latencies differ from fredFp16Delay / fredFp32Delay.\n", latency_mismatches);
+        return 1;
+    }
+    printf("\nAll reductions passed.\n");
+    return 0;
+}
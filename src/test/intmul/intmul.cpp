@@ -0,0 +1,245 @@
+// topIntMul harness: sign-off of the IntMUL_12_24 Booth/Wallace multiplier
+// against native integer multiply, one issue per cycle.
+//   12x12 (is_16 = 1): exhaustive, all 2^24 operand pairs in each lane. Lane 1
+//                      walks the same space in a different order (odd multiplier
+//                      mod 2^24), so both lanes see every pair with varied neighbours.
+//   24x24 (is_16 = 0): structured patterns (walking ones/zeros, Booth triplet and
+//                      12-bit block boundaries, extremes) crossed pairwise, plus
+//                      random pairs.
+// The index space is split into --shard k/N (other processes or machines) and
+// then across --jobs threads, each with its own Verilated model. Random pairs
+// are a pure function of (seed, index), so results do not depend on the split.
+#include "verilated_fixture.h"
+#include "VtopIntMul.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const uint32_t kMask24 = 0xFFFFFF;
+static const uint32_t kMask12 = 0xFFF;
+static const uint64_t kSweep12 = 1ull << 24; // operand pairs per 12x12 lane
+
+struct Op {
+    uint32_t a, b;
+};
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static uint64_t ref_mul(bool is_16, uint32_t a, uint32_t b) {
+    if (!is_16) return (uint64_t)a * b;
+    uint64_t lo = (uint64_t)(a & kMask12) * (b & kMask12);
+    uint64_t hi = (uint64_t)(a >> 12) * (b >> 12);
+    return hi << 24 | lo;
+}
+
+// ===================================================================
+// Operand spaces
+// ===================================================================
+// 12x12: index i -> lane 0 pair i, lane 1 pair (i * 0x9E3779 + 0x5A5A5A) mod 2^24
+static Op op_12(uint64_t i) {
+    uint32_t p0 = (uint32_t)i;
+    uint32_t p1 = (uint32_t)(i * 0x9E3779u + 0x5A5A5Au) & kMask24;
+    return {(p1 >> 12) << 12 | p0 >> 12, (p1 & kMask12) << 12 | (p0 & kMask12)};
+}
+
+static std::vector<uint32_t> structured_24() {
+    std::vector<uint32_t> p = {0, 1, 2, 3, kMask24, kMask24 - 1, 0x800000, 0x7FFFFF, 0x800001,
+                               0x555555, 0xAAAAAA, 0x333333, 0xCCCCCC, 0x0F0F0F, 0xF0F0F0, 0x6DB6DB, 0xB6DB6D,
+                               0xFFF000, 0x000FFF, 0x001000, 0x000800, 0x0007FF, 0x001800, 0x7FF800, 0xFFF800};
+    for (int k = 0; k < 24; ++k) {
+        p.push_back(1u << k);                   // walking one
+        p.push_back(kMask24 & ~(1u << k));      // walking zero
+        p.push_back((1u << k) - 1);             // low ones
+        p.push_back(kMask24 & ~((1u << k) - 1)); // high ones
+    }
+    // Booth triplets straddling bit 11/12 (the is_16 recoding split) and the top digit
+    for (uint32_t t = 0; t < 8; ++t) {
+        p.push_back(t << 11);
+        p.push_back(kMask24 ^ (t << 11));
+        p.push_back(t << 21);
+    }
+    return p;
+}
+
+struct Space24 {
+    std::vector<uint32_t> pat;
+    uint64_t n_struct, n_random;
+    uint64_t seed;
+    uint64_t size() const { return n_struct + n_random; }
+    Op at(uint64_t i) const {
+        if (i < n_struct) return {pat[i / pat.size()], pat[i % pat.size()]};
+        uint64_t r = splitmix64(seed ^ splitmix64(i));
+        return {(uint32_t)r & kMask24, (uint32_t)(r >> 32) & kMask24};
+    }
+};
+
+// ===================================================================
+// IntMulSim: 一个线程一个模型, 连续流水发射
+// ===================================================================
+class IntMulSim : public VerilatedFixture<VtopIntMul> {
+public:
+    explicit IntMulSim(int argc, char* argv[]) : VerilatedFixture(argc, argv) { reset(); }
+
+    // Issues op(i) for i in [begin, end); on_result(i, res) for every output.
+    // Returns false on timeout.
+    template <class OpFn, class ResFn>
+    bool run(bool is_16, uint64_t begin, uint64_t end, OpFn op, ResFn on_result) {
+        top_->io_is_16 = is_16;
+        auto issue = [&](uint64_t i) -> uint64_t {
+            Op o = op(begin + i);
+            top_->io_a_in = o.a;
+            top_->io_b_in = o.b;
+            return 1;
+        };
+        auto collect = [&](uint64_t i) -> uint64_t {
+            on_result(begin + i, (uint64_t)top_->io_res_out);
+            return 1;
+        };
+        return stream(end - begin, issue, collect) == end - begin;
+    }
+};
+
+struct SweepStats {
+    std::atomic<uint64_t> checked{0}, failures{0}, cycles{0};
+    std::atomic<bool> timeout{false};
+    std::mutex print_mutex;
+    uint64_t max_print = 20;
+};
+
+// Runs [begin, end) of one mode across jobs threads
+template <class OpFn>
+static void sweep(int argc, char* argv[], bool is_16, uint64_t begin, uint64_t end, int jobs, OpFn op,
+                  SweepStats& st) {
+    std::vector<std::thread> workers;
+    const uint64_t chunk = (end - begin + jobs - 1) / jobs;
+    for (int j = 0; j < jobs; ++j) {
+        uint64_t b = begin + j * chunk, e = b + chunk < end ? b + chunk : end;
+        if (b >= e) break;
+        workers.emplace_back([&, b, e]() {
+            IntMulSim sim(argc, argv);
+            bool ok = sim.run(is_16, b, e, op, [&](uint64_t i, uint64_t res) {
+                Op o = op(i);
+                uint64_t ref = ref_mul(is_16, o.a, o.b);
+                if (res == ref) return;
+                if (st.failures.fetch_add(1) < st.max_print) {
+                    std::lock_guard<std::mutex> lock(st.print_mutex);
+                    printf("  FAIL %s #%llu: a=0x%06X b=0x%06X dut=0x%012llX ref=0x%012llX\n",
+                           is_16 ? "12x12" : "24x24", (unsigned long long)i, o.a, o.b,
+                           (unsigned long long)res, (unsigned long long)ref);
+                }
+            });
+            if (!ok) st.timeout = true;
+            st.checked += e - b;
+            st.cycles += sim.cycles();
+        });
+    }
+    for (std::thread& t : workers) t.join();
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [--mode 12|24|all] [--jobs <n>] [--shard <k>/<N>] [--random <n>] [--seed <s>]\n"
+           "          [--max-print <n>]\n", prog);
+}
+
+int main(int argc, char* argv[]) {
+    bool run_12 = true, run_24 = true;
+    int jobs = (int)std::thread::hardware_concurrency();
+    unsigned shard = 0, n_shards = 1;
+    uint64_t n_random = 1ull << 24;
+    uint64_t seed = 1;
+    uint64_t max_print = 20;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
+            i++;
+            run_12 = !strcmp(argv[i], "12") || !strcmp(argv[i], "all");
+            run_24 = !strcmp(argv[i], "24") || !strcmp(argv[i], "all");
+            if (!run_12 && !run_24) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--jobs") && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            jobs = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--shard") && i + 1 < argc &&
+                   sscanf(argv[i + 1], "%u/%u", &shard, &n_shards) == 2 && shard < n_shards) {
+            i++;
+        } else if (!strcmp(argv[i], "--random") && i + 1 < argc) {
+            n_random = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--max-print") && i + 1 < argc) {
+            max_print = strtoull(argv[++i], nullptr, 0);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (jobs < 1) jobs = 1;
+    printf("IntMUL_12_24 sign-off: shard %u/%u, %d jobs\n", shard, n_shards, jobs);
+
+    auto shard_range = [&](uint64_t size, uint64_t& b, uint64_t& e) {
+        b = size * shard / n_shards;
+        e = size * (shard + 1) / n_shards;
+    };
+    uint64_t failures = 0;
+    bool timeout = false;
+    auto report = [&](const char* name, uint64_t b, uint64_t e, SweepStats& st, double secs) {
+        printf("%-6s %12llu ops [%llu, %llu) | %llu failures | %llu cycles | %.1f Mops/s\n", name,
+               (unsigned long long)st.checked.load(), (unsigned long long)b, (unsigned long long)e,
+               (unsigned long long)st.failures.load(), (unsigned long long)st.cycles.load(),
+               secs > 0 ? st.checked.load() / secs / 1e6 : 0.0);
+        failures += st.failures;
+        timeout |= st.timeout;
+    };
+
+    if (run_12) {
+        uint64_t b, e;
+        shard_range(kSweep12, b, e);
+        SweepStats st;
+        st.max_print = max_print;
+        auto t0 = std::chrono::steady_clock::now();
+        sweep(argc, argv, true, b, e, jobs, op_12, st);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        report("12x12", b, e, st, secs);
+    }
+    if (run_24) {
+        Space24 sp;
+        sp.pat = structured_24();
+        sp.n_struct = (uint64_t)sp.pat.size() * sp.pat.size();
+        sp.n_random = n_random;
+        sp.seed = seed;
+        uint64_t b, e;
+        shard_range(sp.size(), b, e);
+        SweepStats st;
+        st.max_print = max_print;
+        auto t0 = std::chrono::steady_clock::now();
+        sweep(argc, argv, false, b, e, jobs, [&sp](uint64_t i) { return sp.at(i); }, st);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        report("24x24", b, e, st, secs);
+        printf("       (%llu structured pairs from %zu patterns, %llu random)\n", (unsigned long long)sp.n_struct,
+               sp.pat.size(), (unsigned long long)sp.n_random);
+    }
+
+    if (timeout) {
+        printf("\nTimeout: valid_out stopped before every issued op completed.\n");
+        return 1;
+    }
+    if (failures) {
+        printf("\nIntMUL_12_24 FAILED: %llu mismatches.\n", (unsigned long long)failures);
+        return 1;
+    }
+    printf("\nIntMUL_12_24 passed.\n");
+    return 0;
+}
@@ -0,0 +1,492 @@
+// topLane harness: one 64-bit lane of VFAddWrapper. Compare / min / max / sign
+// injection / move take the fast path (no FAdd_16_32), add / sub the adder.
+//   latency   every op issued alone: the fast ops must complete fcmpDelay, the
+//             adds faddDelay cycles after issue (+1 for the output register of
+//             VFAddWrapper, both counted like faddDelay in the main harness)
+//   chains    dependent chains (each op waits for the previous vd): a clamp
+//             min(max(x, lo), hi) per element against a vfadd.vf chain, i.e. the
+//             latency min/max had when they were derived from the adder
+//   hazard    a fast op presented in the cycle an earlier add takes the shared
+//             output register: fast_ready must be low, the op is held one cycle
+//             and both results must come out
+//   stream    random ops in fp32 / fp16 / bf16, .vv and .vf, issued every cycle;
+//             fast ops wait for fast_ready (the scheduler contract of the shared
+//             output register), which must agree with the write-back slots of the
+//             ops in flight; vd and fflags are checked per element against
+//             SoftFloat (add/sub) and an RVV model (the others)
+#include "fp_utils.h"
+#include "softfloat_ref.h"
+#include "result_checker.h"
+#include "verilated_fixture.h"
+#include "VtopLane.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+
+enum class OpKind { Add, Sub, RSub, Min, Max, Sgnj, SgnjN, SgnjX, Eq, Le, Lt, Ne, Gt, Ge, Move };
+
+struct OpInfo {
+    const char* name;
+    uint8_t funct6;
+    bool vf_only;
+    OpKind kind;
+};
+
+static const OpInfo kOps[] = {
+    {"vfadd", 0x00, false, OpKind::Add},    {"vfsub", 0x02, false, OpKind::Sub},
+    {"vfrsub", 0x27, true, OpKind::RSub},   {"vfmin", 0x04, false, OpKind::Min},
+    {"vfmax", 0x06, false, OpKind::Max},    {"vfsgnj", 0x08, false, OpKind::Sgnj},
+    {"vfsgnjn", 0x09, false, OpKind::SgnjN}, {"vfsgnjx", 0x0a, false, OpKind::SgnjX},
+    {"vmfeq", 0x18, false, OpKind::Eq},     {"vmfle", 0x19, false, OpKind::Le},
+    {"vmflt", 0x1b, false, OpKind::Lt},     {"vmfne", 0x1c, false, OpKind::Ne},
+    {"vmfgt", 0x1d, true, OpKind::Gt},      {"vmfge", 0x1f, true, OpKind::Ge},
+    {"vfmv.v.f", 0x17, true, OpKind::Move},
+};
+static const int kNumOps = sizeof(kOps) / sizeof(kOps[0]);
+static const int kModes = 3; // FP32, FP16, BF16
+
+static bool is_fast(OpKind k) { return k != OpKind::Add && k != OpKind::Sub && k != OpKind::RSub; }
+static bool is_cmp(OpKind k) { return k >= OpKind::Eq && k <= OpKind::Ge; }
+
+static uint8_t vsew(TestMode mode) {
+    return mode == TestMode::FP32 ? 2 : mode == TestMode::FP16 ? 1 : 5;
+}
+
+// One lane op: vd = vs2 op vs1 (or rs1)
+struct LaneOp {
+    int op;
+    bool vf;
+    uint64_t vs1, vs2, rs1;
+};
+
+struct LaneResult {
+    uint64_t vd;
+    uint8_t fflags[4];
+};
+
+// ===================================================================
+// Reference
+// ===================================================================
+struct Elem {
+    FpFormat fmt;
+    int width;
+    uint32_t sign, mag_mask, exp_mask, quiet;
+    uint32_t qnan;
+};
+
+static Elem elem_of(TestMode mode) {
+    switch (mode) {
+        case TestMode::FP16: return {FpFormat::FP16, 16, 0x8000u, 0x7fffu, 0x7c00u, 0x0200u, 0x7e00u};
+        case TestMode::BF16: return {FpFormat::BF16, 16, 0x8000u, 0x7fffu, 0x7f80u, 0x0040u, 0x7fc0u};
+        default:             return {FpFormat::FP32, 32, 0x80000000u, 0x7fffffffu, 0x7f800000u, 0x00400000u, 0x7fc00000u};
+    }
+}
+
+static bool is_nan(const Elem& e, uint32_t x) { return (x & e.exp_mask) == e.exp_mask && (x & e.mag_mask & ~e.exp_mask); }
+static bool is_snan(const Elem& e, uint32_t x) { return is_nan(e, x) && !(x & e.quiet); }
+
+static uint32_t ref_add(TestMode mode, uint32_t a, uint32_t b, uint8_t& flags) {
+    flags = softfloat_add_flags(mode, a, b);
+    switch (mode) {
+        case TestMode::FP16: return softfloat_add_fp16(a, b);
+        case TestMode::BF16: return softfloat_add_bf16(a, b);
+        default:             return softfloat_add_fp32(a, b);
+    }
+}
+
+// x = vs2 element, y = vs1/rs1 element. Compares return 0/1.
+static uint32_t ref_elem(TestMode mode, OpKind k, uint32_t x, uint32_t y, uint8_t& flags) {
+    const Elem e = elem_of(mode);
+    const bool x_nan = is_nan(e, x), y_nan = is_nan(e, y);
+    const bool any_snan = is_snan(e, x) || is_snan(e, y);
+    const double dx = fp_to_double(x, e.fmt), dy = fp_to_double(y, e.fmt);
+    flags = 0;
+    switch (k) {
+        case OpKind::Add:  return ref_add(mode, x, y, flags);
+        case OpKind::Sub:  return ref_add(mode, x, y ^ e.sign, flags);
+        case OpKind::RSub: return ref_add(mode, x ^ e.sign, y, flags);
+        case OpKind::Sgnj:  return (x & e.mag_mask) | (y & e.sign);
+        case OpKind::SgnjN: return (x & e.mag_mask) | (~y & e.sign);
+        case OpKind::SgnjX: return x ^ (y & e.sign);
+        case OpKind::Move:  return y;
+        case OpKind::Min:
+        case OpKind::Max: {
+            flags = any_snan ? 0x10 : 0;
+            if (x_nan && y_nan) return e.qnan;
+            if (x_nan) return y;
+            if (y_nan) return x;
+            bool x_lt = dx < dy || (dx == dy && (x & e.sign) && !(y & e.sign)); // -0 < +0
+            return (k == OpKind::Min) == x_lt ? x : y;
+        }
+        default: {
+            bool ordered = !x_nan && !y_nan;
+            flags = (k == OpKind::Eq || k == OpKind::Ne ? any_snan : !ordered) ? 0x10 : 0;
+            switch (k) {
+                case OpKind::Eq: return dx == dy;
+                case OpKind::Ne: return !(dx == dy);
+                case OpKind::Lt: return dx < dy;
+                case OpKind::Le: return dx <= dy;
+                case OpKind::Gt: return dx > dy;
+                default:         return dx >= dy;
+            }
+        }
+    }
+}
+
+// vd / fflags of a whole lane. vf replicates rs1 like VFAddWrapper.
+static LaneResult ref_lane(TestMode mode, const LaneOp& op, bool* nan_ok) {
+    const Elem e = elem_of(mode);
+    const OpKind k = kOps[op.op].kind;
+    const int n = 64 / e.width;
+    const uint64_t emask = e.width == 32 ? 0xffffffffull : 0xffffull;
+    LaneResult r = {0, {0, 0, 0, 0}};
+    for (int i = 0; i < n; ++i) {
+        uint32_t x = (uint32_t)(op.vs2 >> (i * e.width) & emask);
+        uint32_t y = (uint32_t)((op.vf ? op.rs1 : op.vs1 >> (i * e.width)) & emask);
+        uint8_t flags;
+        uint32_t v = ref_elem(mode, k, x, y, flags);
+        // add/sub: any NaN encoding of a NaN result is accepted
+        nan_ok[i] = !is_fast(k) && is_nan(e, v);
+        if (is_cmp(k)) {
+            r.vd |= (uint64_t)v << i;
+        } else {
+            r.vd |= (uint64_t)v << (i * e.width);
+        }
+        r.fflags[e.width == 32 ? 2 * i : i] = flags;
+    }
+    return r;
+}
+
+// ===================================================================
+// LaneSim: 驱动 topLane
+// ===================================================================
+class LaneSim : public VerilatedFixture<VtopLane> {
+public:
+    LaneSim(int argc, char* argv[]) : VerilatedFixture(argc, argv) { reset(); }
+
+    void poke(TestMode mode, const LaneOp& op) {
+        top_->io_funct6 = kOps[op.op].funct6;
+        top_->io_funct3 = op.vf ? 5 : 1;
+        top_->io_vm = 1;
+        top_->io_widen = 0;
+        top_->io_widen2 = 0;
+        top_->io_narrow = 0;
+        top_->io_uop_idx = 0;
+        top_->io_vsew = vsew(mode);
+        top_->io_vs1 = op.vs1;
+        top_->io_vs2 = op.vs2;
+        top_->io_vs3 = 0;
+        top_->io_rs1 = op.rs1;
+    }
+    LaneResult peek() const {
+        return {top_->io_vd, {top_->io_fflags_out_0, top_->io_fflags_out_1, top_->io_fflags_out_2,
+                              top_->io_fflags_out_3}};
+    }
+    // Cycles from issuing op alone until valid_out, -1 on timeout
+    int measure_latency(TestMode mode, const LaneOp& op) {
+        poke(mode, op);
+        return single_op_latency();
+    }
+};
+
+// ===================================================================
+// Operands: random values, NaNs, zeros and infinities, equal and negated pairs
+// ===================================================================
+static uint32_t gen_special(const Elem& e) {
+    switch (rand() % 8) {
+        case 0:  return 0;
+        case 1:  return e.sign;                              // -0
+        case 2:  return e.exp_mask;                          // +inf
+        case 3:  return e.exp_mask | e.sign;                 // -inf
+        case 4:  return e.qnan | (rand() & 1 ? e.sign : 0);  // qNaN
+        case 5:  return e.exp_mask | 1;                      // sNaN
+        case 6:  return 1;                                   // min subnormal
+        default: return e.exp_mask - 1;                      // max normal
+    }
+}
+
+static uint32_t gen_elem(TestMode mode, uint32_t other) {
+    const Elem e = elem_of(mode);
+    switch (rand() % 8) {
+        case 0:  return gen_special(e);
+        case 1:  return other;
+        case 2:  return other ^ e.sign;
+        default: return mode == TestMode::FP32 ? gen_any_fp32() : mode == TestMode::FP16 ? gen_any_fp16() : gen_any_bf16();
+    }
+}
+
+static LaneOp gen_op(TestMode mode, int op) {
+    const int w = mode == TestMode::FP32 ? 32 : 16;
+    LaneOp l = {op, kOps[op].vf_only || rand() % 4 == 0, 0, 0, 0};
+    for (int i = 0; i < 64 / w; ++i) {
+        uint32_t x = gen_elem(mode, 0);
+        uint32_t y = gen_elem(mode, x);
+        l.vs2 |= (uint64_t)x << (i * w);
+        l.vs1 |= (uint64_t)y << (i * w);
+    }
+    l.rs1 = (uint32_t)l.vs1 & (w == 32 ? 0xffffffffu : 0xffffu);
+    return l;
+}
+
+// ===================================================================
+// Tests
+// ===================================================================
+static int op_index(const char* name) {
+    for (int i = 0; i < kNumOps; ++i) {
+        if (!strcmp(kOps[i].name, name)) return i;
+    }
+    return -1;
+}
+
+// Returns the measured latencies of the adder and the fast path, or false on a mismatch
+static bool test_latency(LaneSim& sim, int& lat_add, int& lat_fast) {
+    VtopLane* top = sim.top();
+    const int fadd = top->io_fadd_delay, fcmp = top->io_fcmp_delay, bias = top->io_delay_bias;
+    const int exp_add = fadd - bias + 1, exp_fast = fcmp - bias + 1;
+    printf("Latency (issue alone, VParams faddDelay=%d fcmpDelay=%d delayBias=%d, +1 output register):\n",
+           fadd, fcmp, bias);
+    bool ok = true;
+    lat_add = lat_fast = 0;
+    for (int op = 0; op < kNumOps; ++op) {
+        int latency = sim.measure_latency(TestMode::FP32, gen_op(TestMode::FP32, op));
+        int expected = is_fast(kOps[op].kind) ? exp_fast : exp_add;
+        printf("  %-9s %2d cycles%s\n", kOps[op].name, latency, latency == expected ? "" : "  <-- MISMATCH");
+        ok &= latency == expected;
+        (is_fast(kOps[op].kind) ? lat_fast : lat_add) = latency;
+    }
+    if (ok) {
+        printf("  fast path saves %d cycles per op (%d vs %d)\n", lat_add - lat_fast, lat_fast, lat_add);
+    }
+    return ok;
+}
+
+// Dependent chain: every op issues in the cycle the previous vd comes out.
+// Returns cycles per op, or -1 on a wrong result / timeout.
+static double run_chain(LaneSim& sim, TestMode mode, const std::vector<LaneOp>& chain_ops, uint64_t vs2) {
+    VtopLane* top = sim.top();
+    uint64_t c0 = sim.cycles();
+    for (const LaneOp& tmpl : chain_ops) {
+        LaneOp op = tmpl;
+        op.vs2 = vs2;
+        bool nan_ok[4];
+        LaneResult ref = ref_lane(mode, op, nan_ok);
+        if (sim.measure_latency(mode, op) < 0) return -1;
+        vs2 = top->io_vd;
+        if (vs2 != ref.vd) {
+            printf("  chain %s: vd %016llx, expected %016llx\n", kOps[op.op].name,
+                   (unsigned long long)vs2, (unsigned long long)ref.vd);
+            return -1;
+        }
+    }
+    return (double)(sim.cycles() - c0) / chain_ops.size();
+}
+
+static bool test_chains(LaneSim& sim, size_t length) {
+    const TestMode mode = TestMode::FP16;
+    const Elem e = elem_of(mode);
+    const uint32_t lo = fp32_to_fp16(-1.0f), hi = fp32_to_fp16(1.0f), step = fp32_to_fp16(0.125f);
+    std::vector<LaneOp> clamp, add;
+    for (size_t i = 0; i < length; i += 2) {
+        clamp.push_back({op_index("vfmax"), true, 0, 0, lo});
+        clamp.push_back({op_index("vfmin"), true, 0, 0, hi});
+        add.push_back({op_index("vfadd"), true, 0, 0, step});
+        add.push_back({op_index("vfadd"), true, 0, 0, step ^ e.sign});
+    }
+    uint64_t x = 0;
+    for (int i = 0; i < 4; ++i) {
+        x |= (uint64_t)fp32_to_fp16((float)(i * 2 - 3)) << (16 * i);
+    }
+    double c_clamp = run_chain(sim, mode, clamp, x);
+    double c_add = run_chain(sim, mode, add, x);
+    if (c_clamp < 0 || c_add < 0) return false;
+    printf("Dependent chains (%zu ops, fp16): clamp vfmax/vfmin %.2f cycles/op, vfadd %.2f cycles/op "
+           "(the min/max latency through the adder) -> %.2fx\n",
+           clamp.size(), c_clamp, c_add, c_add / c_clamp);
+    return true;
+}
+
+// An add, then a fast op presented in the cycle the add takes the output register.
+// fast_ready must hold the fast op for one cycle; both results must come out.
+static bool test_hazard(LaneSim& sim, int lat_add, int lat_fast) {
+    VtopLane* top = sim.top();
+    const TestMode mode = TestMode::FP32;
+    // vs1 = {3.0, 0.5}, vs2 = {1.0, 2.0}: no NaN results
+    const LaneOp ops[2] = {{op_index("vfadd"), false, 0x404000003f000000ull, 0x3f80000040000000ull, 0},
+                           {op_index("vfmin"), false, 0x404000003f000000ull, 0x3f80000040000000ull, 0}};
+    bool nan_ok[4];
+    const LaneResult ref[2] = {ref_lane(mode, ops[0], nan_ok), ref_lane(mode, ops[1], nan_ok)};
+    std::vector<uint64_t> out;
+    auto step = [&](bool valid) {
+        top->io_valid_in = valid;
+        sim.single_cycle();
+        top->io_valid_in = 0;
+        if (top->io_valid_out) out.push_back(top->io_vd);
+    };
+
+    sim.poke(mode, ops[0]);
+    step(true);
+    for (int i = 1; i < lat_add - lat_fast; ++i) {
+        step(false);
+    }
+    bool ok = !top->io_fast_ready;
+    if (!ok) {
+        printf("  fast_ready high in the cycle the vfadd takes the output register\n");
+    }
+    int held = 0;
+    while (!top->io_fast_ready && held < 10) {
+        step(false);
+        ++held;
+    }
+    sim.poke(mode, ops[1]);
+    step(true);
+    for (int i = 0; i < 20 && out.size() < 2; ++i) {
+        step(false);
+    }
+
+    if (out.size() != 2) {
+        printf("  %zu of 2 results came out\n", out.size());
+        ok = false;
+    }
+    for (size_t i = 0; i < out.size() && i < 2; ++i) {
+        if (out[i] != ref[i].vd) {
+            printf("  %s: vd %016llx, expected %016llx\n", kOps[ops[i].op].name, (unsigned long long)out[i],
+                   (unsigned long long)ref[i].vd);
+            ok = false;
+        }
+    }
+    printf("Write-back hazard: fast op held %d cycle(s) behind a vfadd, %s\n", held, ok ? "both results out" : "FAILED");
+    return ok;
+}
+
+// Random ops issued every cycle; fast ops only while fast_ready
+static uint64_t test_stream(LaneSim& sim, TestMode mode, size_t n_ops, int lat_add, int lat_fast, uint64_t* op_errors) {
+    VtopLane* top = sim.top();
+    struct Inflight { LaneOp op; LaneResult ref; bool nan_ok[4]; };
+    std::map<uint64_t, Inflight> inflight; // key: cycle of valid_out
+    const int n_elem = mode == TestMode::FP32 ? 2 : 4;
+    uint64_t failures = 0, stalls = 0, c0 = sim.cycles();
+    size_t issued = 0;
+    LaneOp next = gen_op(mode, rand() % kNumOps);
+    while (issued < n_ops || !inflight.empty()) {
+        bool fire = false;
+        if (issued < n_ops) {
+            const bool fast = is_fast(kOps[next.op].kind);
+            uint64_t done = sim.cycles() + (fast ? lat_fast : lat_add);
+            if (fast && top->io_fast_ready == inflight.count(done)) {
+                printf("  %s: fast_ready %d in cycle %llu, write-back slot %s\n", mode_name(mode), top->io_fast_ready,
+                       (unsigned long long)sim.cycles(), inflight.count(done) ? "taken" : "free");
+                return failures + 1;
+            }
+            if (!fast || top->io_fast_ready) {
+                Inflight& f = inflight[done];
+                f.op = next;
+                f.ref = ref_lane(mode, next, f.nan_ok);
+                sim.poke(mode, next);
+                fire = true;
+                ++issued;
+                next = gen_op(mode, rand() % kNumOps);
+            } else {
+                ++stalls;
+            }
+        }
+        top->io_valid_in = fire;
+        sim.single_cycle();
+
+        auto it = inflight.find(sim.cycles());
+        if (top->io_valid_out != (it != inflight.end())) {
+            printf("  %s: valid_out %d in cycle %llu\n", mode_name(mode), top->io_valid_out,
+                   (unsigned long long)sim.cycles());
+            top->io_valid_in = 0;
+            return failures + 1;
+        }
+        if (it == inflight.end()) continue;
+
+        const Inflight& f = it->second;
+        LaneResult dut = sim.peek();
+        bool ok = top->io_funct6_out == kOps[f.op.op].funct6;
+        const int w = mode == TestMode::FP32 ? 32 : 16;
+        const bool cmp = is_cmp(kOps[f.op.op].kind);
+        for (int i = 0; i < n_elem; ++i) {
+            uint64_t m = cmp ? 1ull << i : (w == 32 ? 0xffffffffull : 0xffffull) << (i * w);
+            bool both_nan = f.nan_ok[i] && is_nan(elem_of(mode), (uint32_t)((dut.vd & m) >> (i * w)));
+            ok &= (dut.vd & m) == (f.ref.vd & m) || both_nan;
+            int s = w == 32 ? 2 * i : i;
+            ok &= dut.fflags[s] == f.ref.fflags[s];
+        }
+        if (cmp) ok &= dut.vd >> n_elem == 0;
+        if (!ok) {
+            if (failures < 10) {
+                printf("  %s %s%s vs2 %016llx %s %016llx: vd %016llx fflags %02x %02x %02x %02x, "
+                       "expected %016llx %02x %02x %02x %02x\n",
+                       mode_name(mode), kOps[f.op.op].name, f.op.vf ? ".vf" : ".vv",
+                       (unsigned long long)f.op.vs2, f.op.vf ? "rs1" : "vs1",
+                       (unsigned long long)(f.op.vf ? f.op.rs1 : f.op.vs1), (unsigned long long)dut.vd,
+                       dut.fflags[0], dut.fflags[1], dut.fflags[2], dut.fflags[3], (unsigned long long)f.ref.vd,
+                       f.ref.fflags[0], f.ref.fflags[1], f.ref.fflags[2], f.ref.fflags[3]);
+            }
+            ++failures;
+            ++op_errors[f.op.op];
+        }
+        inflight.erase(it);
+    }
+    top->io_valid_in = 0;
+    uint64_t cyc = sim.cycles() - c0;
+    printf("%-5s %zu ops in %llu cycles (%.2f ops/cycle, %llu write-back stalls), %llu mismatches\n",
+           mode_name(mode), n_ops, (unsigned long long)cyc, (double)n_ops / cyc, (unsigned long long)stalls,
+           (unsigned long long)failures);
+    return failures;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n_ops = 100000, length = 1000;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--ops") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            n_ops = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--length") && i + 1 < argc && atol(argv[i + 1]) > 1) {
+            length = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else {
+            printf("Usage: %s [--ops <n>] [--length <chain length>] [--seed <s>]\n", argv[0]);
+            return 1;
+        }
+    }
+    srand(seed);
+
+    LaneSim sim(argc, argv);
+    int lat_add, lat_fast;
+    if (!test_latency(sim, lat_add, lat_fast)) {
+        printf("\nVFAddWrapper latency does not match VParams.\n");
+        return 1;
+    }
+    if (!test_chains(sim, length)) {
+        printf("\nDependent chain failed.\n");
+        return 1;
+    }
+    if (!test_hazard(sim, lat_add, lat_fast)) {
+        printf("\nFast op and add collided on the output register.\n");
+        return 1;
+    }
+
+    uint64_t failures = 0, op_errors[kNumOps] = {};
+    for (int m = 0; m < kModes; ++m) {
+        failures += test_stream(sim, (TestMode)m, n_ops, lat_add, lat_fast, op_errors);
+    }
+    if (failures) {
+        printf("\nMismatches per op:");
+        for (int op = 0; op < kNumOps; ++op) {
+            if (op_errors[op]) printf(" %s %llu", kOps[op].name, (unsigned long long)op_errors[op]);
+        }
+        printf("\n%llu ops differ from the reference.\n", (unsigned long long)failures);
+        return 1;
+    }
+    printf("\nAll lane ops passed.\n");
+    return 0;
+}
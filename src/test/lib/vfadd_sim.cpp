@@ -0,0 +1,168 @@
+// libvfadd_sim: C ABI wrapper around the Verilated top / topFMA models
+#include "vfadd_sim.h"
+#include "simulator.h"
+#include "softfloat_ref.h"
+#include "verilated_fixture.h"
+#include "VtopFMA.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+// ===================================================================
+// FmaStream: 流式驱动 topFMA (c与a/b同周期送入)
+// ===================================================================
+class FmaStream : public VerilatedFixture<VtopFMA> {
+public:
+    FmaStream() : VerilatedFixture(0, nullptr) {}
+
+    size_t run(TestMode mode, const void* a, const void* b, const void* c, void* out, size_t n);
+};
+
+size_t FmaStream::run(TestMode mode, const void* a, const void* b, const void* c, void* out, size_t n) {
+    const bool in16 = mode != TestMode::FP32;
+    const bool c16 = mode == TestMode::FP16 || mode == TestMode::BF16;
+    const bool out16 = c16;
+    const size_t per_cycle = out16 ? 2 : 1;
+
+    auto load = [](const void* p, bool is16, size_t i, size_t n) -> uint32_t {
+        if (i >= n) return 0;
+        return is16 ? ((const uint16_t*)p)[i] : ((const uint32_t*)p)[i];
+    };
+
+    reset();
+
+    top_->io_is_fp32 = mode == TestMode::FP32;
+    top_->io_is_fp16 = mode == TestMode::FP16 || mode == TestMode::FP16_Widen;
+    top_->io_is_bf16 = mode == TestMode::BF16 || mode == TestMode::BF16_Widen;
+    top_->io_is_widen = mode == TestMode::FP16_Widen || mode == TestMode::BF16_Widen;
+
+    auto issue = [&](size_t i) -> uint64_t {
+        uint32_t a0 = load(a, in16, i, n), a1 = load(a, in16, i + 1, n);
+        uint32_t b0 = load(b, in16, i, n), b1 = load(b, in16, i + 1, n);
+        uint32_t c0 = load(c, c16, i, n), c1 = load(c, c16, i + 1, n);
+        switch (mode) {
+            case TestMode::FP32:
+                top_->io_a_in_32 = a0;
+                top_->io_b_in_32 = b0;
+                top_->io_c_in_32 = c0;
+                break;
+            case TestMode::FP16:
+            case TestMode::BF16:
+                top_->io_a_in_16_0 = a0;
+                top_->io_a_in_16_1 = a1;
+                top_->io_b_in_16_0 = b0;
+                top_->io_b_in_16_1 = b1;
+                top_->io_c_in_16_0 = c0;
+                top_->io_c_in_16_1 = c1;
+                break;
+            case TestMode::FP16_Widen:
+            case TestMode::BF16_Widen:
+                // widen: 16位a/b放在高半部分, c为32位
+                top_->io_a_in_16_0 = 0;
+                top_->io_a_in_16_1 = a0;
+                top_->io_b_in_16_0 = 0;
+                top_->io_b_in_16_1 = b0;
+                top_->io_c_in_32 = c0;
+                break;
+            case TestMode::FP16_Narrow:
+            case TestMode::BF16_Narrow:
+                break; // topFMA has no narrowing, to_test_mode() never returns these
+        }
+        return per_cycle;
+    };
+    auto collect = [&](size_t i) -> uint64_t {
+        if (out16) {
+            uint16_t* o = (uint16_t*)out;
+            o[i] = top_->io_res_out_16_0;
+            if (i + 1 < n) o[i + 1] = top_->io_res_out_16_1;
+        } else {
+            ((uint32_t*)out)[i] = top_->io_res_out_32;
+        }
+        return per_cycle;
+    };
+    return stream(n, issue, collect);
+}
+
+// ===================================================================
+// C ABI
+// ===================================================================
+struct vfadd_sim {
+    Simulator fadd{0, nullptr};
+    std::unique_ptr<FmaStream> fma;
+};
+
+static bool to_test_mode(vfadd_sim_mode mode, TestMode& out) {
+    switch (mode) {
+        case VFADD_SIM_FP32: out = TestMode::FP32; return true;
+        case VFADD_SIM_FP16: out = TestMode::FP16; return true;
+        case VFADD_SIM_BF16: out = TestMode::BF16; return true;
+        case VFADD_SIM_FP16_WIDEN: out = TestMode::FP16_Widen; return true;
+        case VFADD_SIM_BF16_WIDEN: out = TestMode::BF16_Widen; return true;
+    }
+    return false;
+}
+
+extern "C" {
+
+vfadd_sim* vfadd_sim_create(void) {
+    try {
+        vfadd_sim* sim = new vfadd_sim;
+        sim->fadd.set_verbose(false);
+        return sim;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void vfadd_sim_destroy(vfadd_sim* sim) {
+    delete sim;
+}
+
+int vfadd_sim_run(vfadd_sim* sim, vfadd_sim_mode mode, const void* a, const void* b, void* out, size_t n) {
+    TestMode m;
+    if (!sim || !to_test_mode(mode, m) || (n && (!a || !b || !out))) {
+        return VFADD_SIM_EINVAL;
+    }
+    try {
+        return sim->fadd.run_stream(m, a, b, out, n) == n ? VFADD_SIM_OK : VFADD_SIM_ETIMEOUT;
+    } catch (...) {
+        return VFADD_SIM_EINTERNAL;
+    }
+}
+
+int vfadd_sim_fma_run(vfadd_sim* sim, vfadd_sim_mode mode,
+                      const void* a, const void* b, const void* c, void* out, size_t n) {
+    TestMode m;
+    if (!sim || !to_test_mode(mode, m) || (n && (!a || !b || !c || !out))) {
+        return VFADD_SIM_EINVAL;
+    }
+    try {
+        if (!sim->fma) {
+            sim->fma.reset(new FmaStream);
+        }
+        return sim->fma->run(m, a, b, c, out, n) == n ? VFADD_SIM_OK : VFADD_SIM_ETIMEOUT;
+    } catch (...) {
+        return VFADD_SIM_EINTERNAL;
+    }
+}
+
+int vfadd_sim_ref_run(vfadd_sim_mode mode, const void* a, const void* b, void* out, size_t n) {
+    // SoftFloat keeps its rounding mode and flags in globals
+    static std::mutex softfloat_mutex;
+    TestMode m;
+    if (!to_test_mode(mode, m) || (n && (!a || !b || !out))) {
+        return VFADD_SIM_EINVAL;
+    }
+    std::lock_guard<std::mutex> lock(softfloat_mutex);
+    softfloat_add_stream(m, a, b, out, n);
+    return VFADD_SIM_OK;
+}
+
+uint64_t vfadd_sim_cycles(const vfadd_sim* sim) {
+    if (!sim) return 0;
+    return sim->fadd.cycles() + (sim->fma ? sim->fma->cycles() : 0);
+}
+
+} // extern "C"
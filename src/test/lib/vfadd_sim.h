@@ -0,0 +1,62 @@
+#ifndef __VFADD_SIM_H__
+#define __VFADD_SIM_H__
+
+/*
+ * libvfadd_sim: C ABI for streaming operand buffers through the Verilated
+ * `top` (FAdd_16_32) and `topFMA` (VFMA_16_32) models.
+ *
+ * Element types by mode (bit patterns, no conversion):
+ *   VFADD_SIM_FP32                  a, b, c, out: uint32_t
+ *   VFADD_SIM_FP16 / VFADD_SIM_BF16 a, b, c, out: uint16_t  (two elements per cycle)
+ *   VFADD_SIM_FP16_WIDEN / _BF16_WIDEN
+ *                                   a, b: uint16_t; c, out: uint32_t
+ *
+ * Each handle owns its own Verilated models, so different handles may be
+ * used from different threads. A single handle is not thread-safe.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    VFADD_SIM_FP32 = 0,
+    VFADD_SIM_FP16 = 1,
+    VFADD_SIM_BF16 = 2,
+    VFADD_SIM_FP16_WIDEN = 3,
+    VFADD_SIM_BF16_WIDEN = 4
+} vfadd_sim_mode;
+
+/* Return codes */
+#define VFADD_SIM_OK        0
+#define VFADD_SIM_EINVAL   -1  /* bad handle, mode or buffer */
+#define VFADD_SIM_ETIMEOUT -2  /* DUT stopped producing valid_out */
+#define VFADD_SIM_EINTERNAL -3
+
+typedef struct vfadd_sim vfadd_sim;
+
+vfadd_sim* vfadd_sim_create(void);
+void vfadd_sim_destroy(vfadd_sim* sim);
+
+/* out[i] = a[i] + b[i] through `top` */
+int vfadd_sim_run(vfadd_sim* sim, vfadd_sim_mode mode,
+                  const void* a, const void* b, void* out, size_t n);
+
+/* out[i] = a[i] * b[i] + c[i] through `topFMA` (model built on first use) */
+int vfadd_sim_fma_run(vfadd_sim* sim, vfadd_sim_mode mode,
+                      const void* a, const void* b, const void* c, void* out, size_t n);
+
+/* SoftFloat reference for vfadd_sim_run (RNE); needs no handle, thread-safe */
+int vfadd_sim_ref_run(vfadd_sim_mode mode, const void* a, const void* b, void* out, size_t n);
+
+/* Clock cycles simulated so far by this handle (both models) */
+uint64_t vfadd_sim_cycles(const vfadd_sim* sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __VFADD_SIM_H__ */
@@ -0,0 +1,296 @@
+// Lockstep differential run: two Verilated variants of `top` (Vbase, Vcand,
+// built with --prefix from two Verilog files) are driven with the identical
+// pipelined stream, one issue per cycle. Every element whose result or fflags
+// differ between the two is reported and classified against SoftFloat, e.g. after an
+// RTL refactor (expect no divergence) or an ExtendedWidth change (expect fixes
+// or regressions only where the extra guard bits matter).
+#include "fp_utils.h"
+#include "result_checker.h"
+#include "softfloat_ref.h"
+#include "workload_dist.h"
+#include "verilated_fixture.h"
+#include "Vbase.h"
+#include "Vcand.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// ===================================================================
+// LockstepDut: one Verilated variant with its own context
+// ===================================================================
+template <class Model>
+class LockstepDut : public VerilatedFixture<Model> {
+    using Base = VerilatedFixture<Model>;
+    using Base::top_;
+
+public:
+    using Base::cycles;
+
+    LockstepDut(int argc, char* argv[]) : Base(argc, argv) {}
+
+    void set_mode(TestMode mode) {
+        top_->io_is_fp32 = mode == TestMode::FP32;
+        top_->io_is_fp16 = mode == TestMode::FP16 || mode == TestMode::FP16_Widen || mode == TestMode::FP16_Narrow;
+        top_->io_is_bf16 = mode == TestMode::BF16 || mode == TestMode::BF16_Widen || mode == TestMode::BF16_Narrow;
+        top_->io_is_widen = mode == TestMode::FP16_Widen || mode == TestMode::BF16_Widen;
+        top_->io_is_narrow = mode == TestMode::FP16_Narrow || mode == TestMode::BF16_Narrow;
+        top_->io_a_already_widen = 0;
+    }
+    // Same packing as Simulator::poke_operands
+    void poke(TestMode mode, bool valid, uint32_t a0, uint32_t b0, uint32_t a1, uint32_t b1) {
+        top_->io_valid_in = valid;
+        if (operand_format(mode) == FpFormat::FP32) {
+            top_->io_a_in_32 = a0;
+            top_->io_b_in_32 = b0;
+        } else if (mode == TestMode::FP16 || mode == TestMode::BF16) {
+            top_->io_a_in_16_0 = a0;
+            top_->io_b_in_16_0 = b0;
+            top_->io_a_in_16_1 = a1;
+            top_->io_b_in_16_1 = b1;
+        } else {
+            top_->io_a_in_16_0 = 0;
+            top_->io_a_in_16_1 = a0;
+            top_->io_b_in_16_0 = 0;
+            top_->io_b_in_16_1 = b0;
+        }
+    }
+    // After single_cycle(): appends this cycle's results (1 or 2 elements) and their fflags to out / flags
+    void collect(TestMode mode, std::vector<uint32_t>& out, std::vector<uint8_t>& flags, size_t n) {
+        if (!top_->io_valid_out || out.size() >= n) return;
+        if (latency_ < 0) latency_ = (int)(cycles() - first_issue_);
+        if (mode == TestMode::FP16 || mode == TestMode::BF16) {
+            out.push_back(top_->io_res_out_16_0);
+            flags.push_back(top_->io_fflags_out_0);
+            if (out.size() < n) {
+                out.push_back(top_->io_res_out_16_1);
+                flags.push_back(top_->io_fflags_out_1);
+            }
+        } else if (mode == TestMode::FP16_Narrow || mode == TestMode::BF16_Narrow) {
+            out.push_back(top_->io_res_out_16_1);
+            flags.push_back(top_->io_fflags_out_1);
+        } else {
+            out.push_back(top_->io_res_out_32);
+            flags.push_back(top_->io_fflags_out_0);
+        }
+    }
+    void start() {
+        first_issue_ = cycles();
+        latency_ = -1;
+    }
+    int latency() const { return latency_; }
+
+private:
+    uint64_t first_issue_ = 0;
+    int latency_ = -1;
+};
+
+// ===================================================================
+// Divergence classification (base vs cand, judged by the SoftFloat result)
+// ===================================================================
+enum class Divergence { Regression, Fix, BothOff, NanPayload, ZeroSign, kCount };
+static const char* kDivNames[] = {"regression", "fix", "both-off", "nan-payload", "zero-sign"};
+
+static bool is_nan(uint32_t x, FpFormat fmt) {
+    switch (fmt) {
+    case FpFormat::FP32: return (x & 0x7F800000u) == 0x7F800000u && (x & 0x007FFFFFu);
+    case FpFormat::FP16: return (x & 0x7C00u) == 0x7C00u && (x & 0x03FFu);
+    default:             return (x & 0x7F80u) == 0x7F80u && (x & 0x007Fu);
+    }
+}
+
+static Divergence classify(uint32_t base, uint32_t cand, uint32_t ref, FpFormat fmt) {
+    const uint32_t sign = fmt == FpFormat::FP32 ? 0x80000000u : 0x8000u;
+    if (is_nan(base, fmt) && is_nan(cand, fmt)) return Divergence::NanPayload;
+    if ((base | sign) == sign && (cand | sign) == sign) return Divergence::ZeroSign;
+    if (base == ref) return Divergence::Regression;
+    if (cand == ref) return Divergence::Fix;
+    return Divergence::BothOff;
+}
+
+struct ModeStream {
+    TestMode mode;
+    std::vector<uint32_t> a, b, ref; // one element per entry
+    std::vector<uint8_t> ref_flags;
+};
+
+static void gen_stream(ModeStream& s, size_t n) {
+    const FpFormat fmt = operand_format(s.mode);
+    const WorkloadParams mix[] = {
+        workload_gaussian(1.0), workload_log_normal(1.0 / 16384, 4.0),
+        workload_outliers(1.0, 256.0, 1.0 / 16), workload_cancelling(1.0, 9),
+    };
+    s.a.resize(n);
+    s.b.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        // Half arbitrary bit patterns (specials, subnormals), half AI-like operands
+        if (i % 2) {
+            s.a[i] = fmt == FpFormat::FP32 ? gen_any_fp32() : fmt == FpFormat::FP16 ? gen_any_fp16() : gen_any_bf16();
+            s.b[i] = fmt == FpFormat::FP32 ? gen_any_fp32() : fmt == FpFormat::FP16 ? gen_any_fp16() : gen_any_bf16();
+        } else {
+            gen_workload_pair(mix[(i / 2) % 4], fmt, s.a[i], s.b[i]);
+        }
+    }
+    // Reference per element
+    s.ref.resize(n);
+    s.ref_flags.resize(n);
+    uint8_t* rf = s.ref_flags.data();
+    if (s.mode == TestMode::FP32) {
+        softfloat_add_stream(s.mode, s.a.data(), s.b.data(), s.ref.data(), n, rf);
+        return;
+    }
+    if (fmt == FpFormat::FP32) { // narrowing: 32-bit operands, 16-bit results
+        std::vector<uint16_t> r16(n);
+        softfloat_add_stream(s.mode, s.a.data(), s.b.data(), r16.data(), n, rf);
+        s.ref.assign(r16.begin(), r16.end());
+        return;
+    }
+    std::vector<uint16_t> a16(s.a.begin(), s.a.end()), b16(s.b.begin(), s.b.end());
+    if (s.mode == TestMode::FP16 || s.mode == TestMode::BF16) {
+        std::vector<uint16_t> r16(n);
+        softfloat_add_stream(s.mode, a16.data(), b16.data(), r16.data(), n, rf);
+        s.ref.assign(r16.begin(), r16.end());
+    } else {
+        softfloat_add_stream(s.mode, a16.data(), b16.data(), s.ref.data(), n, rf);
+    }
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [--vectors <n>] [--mode fp32|fp16|bf16|fp16w|bf16w|fp16n|bf16n] [--seed <s>] [--max-print <n>]\n", prog);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n_vec = 100000;
+    size_t max_print = SIZE_MAX;
+    int only_mode = -1;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        static const char* kModes[] = {"fp32", "fp16", "bf16", "fp16w", "bf16w", "fp16n", "bf16n"};
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--vectors") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            n_vec = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--max-print") && i + 1 < argc) {
+            max_print = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
+            i++;
+            for (int m = 0; m < kNumTestModes; ++m) {
+                if (!strcmp(argv[i], kModes[m])) only_mode = m;
+            }
+            if (only_mode < 0) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    srand(seed);
+    workload_seed(seed);
+
+    LockstepDut<Vbase> base(argc, argv);
+    LockstepDut<Vcand> cand(argc, argv);
+    printf("Lockstep base vs cand: %zu vectors per mode, seed %u\n", n_vec, seed);
+
+    uint64_t total_div = 0;
+    size_t printed = 0;
+    for (int m = 0; m < kNumTestModes; ++m) {
+        if (only_mode >= 0 && m != only_mode) continue;
+        ModeStream s;
+        s.mode = (TestMode)m;
+        const bool two = s.mode == TestMode::FP16 || s.mode == TestMode::BF16;
+        const size_t n = n_vec * (two ? 2 : 1);
+        const FpFormat out_fmt = result_format(s.mode);
+        gen_stream(s, n);
+
+        base.reset();
+        cand.reset();
+        base.set_mode(s.mode);
+        cand.set_mode(s.mode);
+        base.start();
+        cand.start();
+        std::vector<uint32_t> rb, rc;
+        std::vector<uint8_t> fb, fc;
+        rb.reserve(n);
+        rc.reserve(n);
+        size_t issued = 0;
+        int idle = 0;
+        while (rb.size() < n || rc.size() < n) {
+            bool valid = issued < n;
+            uint32_t a1 = two && issued + 1 < n ? s.a[issued + 1] : 0;
+            uint32_t b1 = two && issued + 1 < n ? s.b[issued + 1] : 0;
+            uint32_t a0 = valid ? s.a[issued] : 0, b0 = valid ? s.b[issued] : 0;
+            base.poke(s.mode, valid, a0, b0, a1, b1);
+            cand.poke(s.mode, valid, a0, b0, a1, b1);
+            if (valid) issued += two ? 2 : 1;
+            base.single_cycle();
+            cand.single_cycle();
+            size_t before = rb.size() + rc.size();
+            base.collect(s.mode, rb, fb, n);
+            cand.collect(s.mode, rc, fc, n);
+            if (rb.size() + rc.size() == before && !valid && ++idle > 100) {
+                fprintf(stderr, "%s: timeout (base %zu, cand %zu of %zu results)\n", mode_name(s.mode), rb.size(),
+                        rc.size(), n);
+                return 1;
+            }
+        }
+
+        // Results are classified as above; fflags divergences (NV DZ OF UF NX) are their own class,
+        // judged the same way against the SoftFloat flags
+        uint64_t counts[(int)Divergence::kCount] = {0};
+        uint64_t n_div = 0, flag_div = 0, flag_counts[2] = {0}; // regression, fix (else both-off)
+        for (size_t i = 0; i < n; ++i) {
+            const bool value_div = rb[i] != rc[i], flags_div = fb[i] != fc[i];
+            if (!value_div && !flags_div) continue;
+            n_div++;
+            char desc[48] = "";
+            if (value_div) {
+                Divergence d = classify(rb[i], rc[i], s.ref[i], out_fmt);
+                counts[(int)d]++;
+                snprintf(desc, sizeof(desc), "%s (%u ulp apart)", kDivNames[(int)d],
+                         fp_ulp_distance(rb[i], rc[i], out_fmt));
+            }
+            if (flags_div) {
+                flag_div++;
+                if (fb[i] == s.ref_flags[i]) flag_counts[0]++;
+                else if (fc[i] == s.ref_flags[i]) flag_counts[1]++;
+            }
+            if (printed < max_print) {
+                printed++;
+                char fbuf[3][16];
+                printf("  %-11s vector %zu elem %zu  a=0x%08X b=0x%08X  base=0x%08X cand=0x%08X ref=0x%08X"
+                       "  fflags base=%s cand=%s ref=%s  %s%s\n", mode_name(s.mode), two ? i / 2 : i, two ? i % 2 : 0,
+                       s.a[i], s.b[i], rb[i], rc[i], s.ref[i], fflags_str(fb[i], fbuf[0]), fflags_str(fc[i], fbuf[1]),
+                       fflags_str(s.ref_flags[i], fbuf[2]), desc, flags_div ? (value_div ? ", fflags" : "fflags") : "");
+            }
+        }
+        total_div += n_div;
+
+        printf("%-11s latency base %d / cand %d cycles | %llu of %zu elements diverge", mode_name(s.mode),
+               base.latency(), cand.latency(), (unsigned long long)n_div, n);
+        for (int d = 0; d < (int)Divergence::kCount; ++d) {
+            if (counts[d]) printf(", %s %llu", kDivNames[d], (unsigned long long)counts[d]);
+        }
+        if (flag_div) {
+            printf(", fflags %llu (regression %llu, fix %llu, both-off %llu)", (unsigned long long)flag_div,
+                   (unsigned long long)flag_counts[0], (unsigned long long)flag_counts[1],
+                   (unsigned long long)(flag_div - flag_counts[0] - flag_counts[1]));
+        }
+        printf("\n");
+    }
+
+    if (total_div) {
+        if (printed < total_div) {
+            printf("(%llu divergent elements not printed, see --max-print)\n",
+                   (unsigned long long)(total_div - printed));
+        }
+        printf("\n%llu divergent elements.\n", (unsigned long long)total_div);
+        return 1;
+    }
+    printf("\nNo divergence: base and cand are bit-identical (results and fflags) on this stream.\n");
+    return 0;
+}
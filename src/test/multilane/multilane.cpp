@@ -0,0 +1,260 @@
+// topMultiLane harness: streams whole VLEN-bit vector registers through the
+// VLEN/32 FAdd_16_32 lanes, one register per cycle, and checks every element
+// against SoftFloat, and the accrued fflags of each vector against the OR of
+// the SoftFloat flags of its elements. Reports pipeline latency and simulated
+// throughput.
+#include "fp_utils.h"
+#include "softfloat_ref.h"
+#include "result_checker.h"
+#include "workload_dist.h"
+#include "verilated_fixture.h"
+#include "VtopMultiLane.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const int kVlen = 1024;            // VParams.VLEN
+static const int kWords = kVlen / 32;     // 32-bit words per vector register
+static const int kLaneModes = 5;          // fp32 .. bf16w, topMultiLane has no narrowing
+
+// Elements per vector register in mode (widen: only the low half of the source is used)
+static int elems_per_vector(TestMode mode) {
+    return mode == TestMode::FP16 || mode == TestMode::BF16 ? kVlen / 16 : kVlen / 32;
+}
+
+struct VectorStream {
+    TestMode mode;
+    size_t n_vec;
+    std::vector<uint32_t> a, b, dut, ref; // one element per entry, in operand/result format
+    std::vector<uint8_t> dut_flags;       // accrued fflags_out, one per vector
+    std::vector<uint8_t> ref_flags;       // SoftFloat fflags, one per element
+};
+
+// ===================================================================
+// MultiLaneSim: 驱动 topMultiLane, 每周期一个完整向量寄存器
+// ===================================================================
+class MultiLaneSim : public VerilatedFixture<VtopMultiLane> {
+public:
+    MultiLaneSim(int argc, char* argv[]) : VerilatedFixture(argc, argv) {}
+
+    // Returns the number of vectors written to s.dut (< s.n_vec only on timeout)
+    size_t run(VectorStream& s);
+    uint64_t latency() const { return latency_; }
+    unsigned threads() const { return contextp_->threads(); }
+
+private:
+    void poke_vector(const VectorStream& s, size_t v);
+    void peek_vector(VectorStream& s, size_t v);
+
+    uint64_t latency_ = 0;
+};
+
+// FP32: word i = element i | 16-bit: word i = element 2i | element 2i+1 << 16
+void MultiLaneSim::poke_vector(const VectorStream& s, size_t v) {
+    const int epv = elems_per_vector(s.mode);
+    const uint32_t* a = &s.a[v * epv];
+    const uint32_t* b = &s.b[v * epv];
+    for (int w = 0; w < kWords; ++w) {
+        uint32_t wa = 0, wb = 0;
+        if (s.mode == TestMode::FP32) {
+            wa = a[w];
+            wb = b[w];
+        } else if (2 * w + 1 < epv) {
+            wa = a[2 * w] | a[2 * w + 1] << 16;
+            wb = b[2 * w] | b[2 * w + 1] << 16;
+        }
+        top_->io_a_in[w] = wa;
+        top_->io_b_in[w] = wb;
+    }
+}
+
+void MultiLaneSim::peek_vector(VectorStream& s, size_t v) {
+    const bool out16 = s.mode == TestMode::FP16 || s.mode == TestMode::BF16;
+    uint32_t* out = &s.dut[v * elems_per_vector(s.mode)];
+    s.dut_flags[v] = top_->io_fflags_out;
+    for (int w = 0; w < kWords; ++w) {
+        uint32_t word = top_->io_res_out[w];
+        if (out16) {
+            out[2 * w] = word & 0xffff;
+            out[2 * w + 1] = word >> 16;
+        } else {
+            out[w] = word;
+        }
+    }
+}
+
+size_t MultiLaneSim::run(VectorStream& s) {
+    reset();
+
+    top_->io_is_fp32 = s.mode == TestMode::FP32;
+    top_->io_is_fp16 = s.mode == TestMode::FP16 || s.mode == TestMode::FP16_Widen;
+    top_->io_is_bf16 = s.mode == TestMode::BF16 || s.mode == TestMode::BF16_Widen;
+    top_->io_is_widen = s.mode == TestMode::FP16_Widen || s.mode == TestMode::BF16_Widen;
+    top_->io_a_already_widen = 0;
+
+    const uint64_t first_issue = cycles();
+    latency_ = 0;
+    auto issue = [&](size_t v) -> uint64_t {
+        poke_vector(s, v);
+        return 1;
+    };
+    auto collect = [&](size_t v) -> uint64_t {
+        if (v == 0) {
+            latency_ = cycles() - first_issue;
+        }
+        peek_vector(s, v);
+        return 1;
+    };
+    size_t done = stream(s.n_vec, issue, collect);
+    if (done < s.n_vec) {
+        fprintf(stderr, "Timeout waiting for valid_out (%zu of %zu vectors)\n", done, s.n_vec);
+    }
+    return done;
+}
+
+static void gen_operands(VectorStream& s) {
+    const FpFormat fmt = operand_format(s.mode);
+    const WorkloadParams mix[] = {
+        workload_gaussian(1.0), workload_log_normal(1.0 / 16384, 4.0),
+        workload_outliers(1.0, 256.0, 1.0 / 16), workload_cancelling(1.0, 9),
+    };
+    size_t n = s.a.size();
+    for (size_t i = 0; i < n; ++i) {
+        // 1/5 of the elements are arbitrary bit patterns, the rest follow the workload mix
+        if (i % 5 == 4) {
+            s.a[i] = fmt == FpFormat::FP32 ? gen_any_fp32() : fmt == FpFormat::FP16 ? gen_any_fp16() : gen_any_bf16();
+            s.b[i] = fmt == FpFormat::FP32 ? gen_any_fp32() : fmt == FpFormat::FP16 ? gen_any_fp16() : gen_any_bf16();
+        } else {
+            gen_workload_pair(mix[i % 5], fmt, s.a[i], s.b[i]);
+        }
+    }
+}
+
+static void reference(VectorStream& s) {
+    size_t n = s.a.size();
+    uint8_t* rf = s.ref_flags.data();
+    if (s.mode == TestMode::FP32) {
+        softfloat_add_stream(s.mode, s.a.data(), s.b.data(), s.ref.data(), n, rf);
+        return;
+    }
+    std::vector<uint16_t> a16(n), b16(n);
+    for (size_t i = 0; i < n; ++i) {
+        a16[i] = (uint16_t)s.a[i];
+        b16[i] = (uint16_t)s.b[i];
+    }
+    if (s.mode == TestMode::FP16 || s.mode == TestMode::BF16) {
+        std::vector<uint16_t> r16(n);
+        softfloat_add_stream(s.mode, a16.data(), b16.data(), r16.data(), n, rf);
+        for (size_t i = 0; i < n; ++i) {
+            s.ref[i] = r16[i];
+        }
+    } else {
+        softfloat_add_stream(s.mode, a16.data(), b16.data(), s.ref.data(), n, rf);
+    }
+}
+
+// Vectors whose accrued fflags differ from the OR of the element flags
+static uint64_t check_vector_flags(const VectorStream& s) {
+    const int epv = elems_per_vector(s.mode);
+    uint64_t failures = 0;
+    for (size_t v = 0; v < s.n_vec; ++v) {
+        uint8_t ref = 0;
+        for (int i = 0; i < epv; ++i) {
+            ref |= s.ref_flags[v * epv + i];
+        }
+        if (s.dut_flags[v] != ref) {
+            if (failures < 10) {
+                char buf[2][16];
+                printf("  %s vector %zu: fflags_out %s, expected %s\n", mode_name(s.mode), v,
+                       fflags_str(s.dut_flags[v], buf[0]), fflags_str(ref, buf[1]));
+            }
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [--vectors <n>] [--mode fp32|fp16|bf16|fp16w|bf16w] [--seed <s>]\n", prog);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n_vec = 4096;
+    int only_mode = -1;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        static const char* kModes[] = {"fp32", "fp16", "bf16", "fp16w", "bf16w"};
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--vectors") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            n_vec = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
+            i++;
+            for (int m = 0; m < kLaneModes; ++m) {
+                if (!strcmp(argv[i], kModes[m])) only_mode = m;
+            }
+            if (only_mode < 0) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    srand(seed);
+    workload_seed(seed);
+
+    MultiLaneSim sim(argc, argv);
+    ResultChecker checker;
+    printf("topMultiLane: VLEN=%d, %d FAdd_16_32 lanes, %u Verilator thread(s), %zu vectors per mode\n",
+           kVlen, kVlen / 32, sim.threads(), n_vec);
+
+    uint64_t failures = 0, flag_failures = 0;
+    for (int m = 0; m < kLaneModes; ++m) {
+        if (only_mode >= 0 && m != only_mode) continue;
+        VectorStream s;
+        s.mode = (TestMode)m;
+        s.n_vec = n_vec;
+        size_t n = n_vec * elems_per_vector(s.mode);
+        s.a.resize(n);
+        s.b.resize(n);
+        s.dut.resize(n);
+        s.ref.resize(n);
+        s.dut_flags.resize(n_vec);
+        s.ref_flags.resize(n);
+        gen_operands(s);
+
+        uint64_t c0 = sim.cycles();
+        auto t0 = std::chrono::steady_clock::now();
+        size_t done = sim.run(s);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        uint64_t cyc = sim.cycles() - c0;
+        if (done != n_vec) {
+            return 1;
+        }
+
+        reference(s);
+        CheckInputs in = {s.a.data(), s.b.data(), s.dut.data(), s.ref.data()};
+        failures += checker.check_batch(s.mode, ErrorType::ULP, in, n);
+        flag_failures += check_vector_flags(s);
+
+        printf("%-11s latency %llu cycles | %llu cycles, %.1f kvectors/s, %.2f M elements/s (%d elements/vector)\n",
+               mode_name(s.mode), (unsigned long long)sim.latency(), (unsigned long long)cyc,
+               n_vec / secs / 1e3, n / secs / 1e6, elems_per_vector(s.mode));
+    }
+
+    checker.report();
+    if (failures || flag_failures) {
+        printf("\n%llu elements out of tolerance, %llu vectors with wrong fflags_out.\n",
+               (unsigned long long)failures, (unsigned long long)flag_failures);
+        return 1;
+    }
+    printf("\nAll vectors passed.\n");
+    return 0;
+}
@@ -0,0 +1,612 @@
+// Trace-driven cycle model of the lane EXU FP units (no RTL needed).
+//   Reads a trace of vector FP instructions, splits them into uops like the
+//   decoder (VCtrl/VUop: vfa, vfma, vfcvt, redu, widen, narrow, LMUL), and
+//   schedules them on the FAdd / FMA / FCvt / FRed units with the VParams
+//   delays, in RobPtr order. Reports IPC, unit utilization and stalls, so
+//   pipeline depth and unit counts can be tried on real kernels first.
+//
+// Usage: perfmodel [options] <trace> [<trace> ...]     (see print_usage)
+//
+// Trace format, one instruction per line, '#' starts a comment:
+//   vsetvli x0, x0, e16, m2          sew (e16 / e32) and LMUL for what follows
+//   vfwmacc.vv v8, v2, v4            RVV assembly, vd first; .vf/.wf take a scalar
+//   .repeat 64 ... .end              loop body (may nest)
+// Registers not written by the trace are ready at cycle 0.
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// Parameters (defaults = VParams)
+// ===================================================================
+struct ModelParams {
+    int vlen = 1024;
+    int delay_bias = 1;     // issueDelay + wbDelay
+    int fadd_delay = 3;     // faddDelay = (faddStages - 1) + delayBias
+    int fcmp_delay = 1;     // fcmpDelay = delayBias: vfmin/vfmax/vfsgnj* bypass the adder
+    int fma_delay = 4;      // fmaDelay = 3 + delayBias
+    int fcvt_delay = 3;     // fcvtDelay = 2 + delayBias
+    int fred16_delay = 15;  // fredFp16Delay = (log2Up(VLEN/32) + 2) * (faddStages - 1) + delayBias
+    int fred32_delay = 15;  // fredFp32Delay = fredFp16Delay: the VFRed tree, every format
+    int n_units[4] = {1, 1, 1, 1}; // FAdd, FMA, FCvt, FRed
+    int rob_size = 192;     // VRobSize
+    int iq_size = 32;       // VIQSize
+    int wb_ports = 1;       // nVRFWritePortsExu
+    int issue_width = 1;
+    bool ooo = false;       // issue the oldest ready uop instead of the IQ head only
+    bool acc_fwd = false;   // VFMA_16_32 acc_fwd: dependent macc 2 cycles after its producer
+};
+
+enum Unit { FAdd = 0, FMA, FCvt, FRed, kNumUnits };
+static const char* kUnitNames[kNumUnits] = {"FAdd", "FMA", "FCvt", "FRed"};
+
+// ===================================================================
+// RobPtr: CircularQueuePtr(VRobSize), flag flips on wrap-around
+// ===================================================================
+struct RobPtr {
+    bool flag = false;
+    uint32_t value = 0;
+
+    RobPtr next(uint32_t entries) const {
+        RobPtr p = *this;
+        if (++p.value == entries) {
+            p.value = 0;
+            p.flag = !p.flag;
+        }
+        return p;
+    }
+    // Same as CircularQueuePtr.<
+    bool operator<(const RobPtr& that) const { return (flag != that.flag) ^ (value < that.value); }
+    bool operator==(const RobPtr& that) const { return flag == that.flag && value == that.value; }
+};
+
+// ===================================================================
+// Decoded instruction and uops
+// ===================================================================
+static const int kNoReg = -1;
+static const int kRedTmp = 32; // reduction partial sum passed between the uops of one instruction
+static const int kNumRegs = 33;
+
+struct Inst {
+    std::string name;
+    Unit unit;
+    bool macc = false;     // vd is also a source
+    bool widen = false;    // 2*sew = sew op sew
+    bool widen2 = false;   // 2*sew = 2*sew op sew
+    bool narrow = false;   // sew = 2*sew op sew (vfncvt)
+    bool redu = false, ordered = false;
+    bool fcmp = false;     // FAdd unit, fast path (no adder)
+    int vd = kNoReg, vs1 = kNoReg, vs2 = kNoReg;
+    int sew = 32, lmul = 1;
+};
+
+struct Uop {
+    RobPtr robIdx;
+    uint64_t seq;          // program order, also orders uops of one instruction (uopIdx)
+    int uopIdx;
+    bool uopEnd;
+    Unit unit;
+    bool macc_fwd_ok;      // FMA accumulate uop: src[2] is the accumulator
+    int src[3] = {kNoReg, kNoReg, kNoReg};
+    int dest = kNoReg;
+    int latency;           // issue -> dependent issue
+    int occupancy;         // cycles the unit cannot take another uop
+    int elems;             // result elements (reduction: source elements)
+};
+
+struct Mnemonic {
+    const char* name;
+    Unit unit;
+    bool macc, widen, widen2, narrow, redu, ordered;
+};
+
+// Decode table (suffix .vv/.vf/.wv/.wf/.vs/.v stripped)
+static const Mnemonic kMnemonics[] = {
+    {"vfadd", FAdd, 0, 0, 0, 0, 0, 0},     {"vfsub", FAdd, 0, 0, 0, 0, 0, 0},
+    {"vfrsub", FAdd, 0, 0, 0, 0, 0, 0},    {"vfmin", FAdd, 0, 0, 0, 0, 0, 0},
+    {"vfmax", FAdd, 0, 0, 0, 0, 0, 0},     {"vfsgnj", FAdd, 0, 0, 0, 0, 0, 0},
+    {"vfsgnjn", FAdd, 0, 0, 0, 0, 0, 0},   {"vfsgnjx", FAdd, 0, 0, 0, 0, 0, 0},
+    {"vfwadd", FAdd, 0, 1, 0, 0, 0, 0},    {"vfwsub", FAdd, 0, 1, 0, 0, 0, 0},
+    {"vfmul", FMA, 0, 0, 0, 0, 0, 0},      {"vfwmul", FMA, 0, 1, 0, 0, 0, 0},
+    {"vfmacc", FMA, 1, 0, 0, 0, 0, 0},     {"vfnmacc", FMA, 1, 0, 0, 0, 0, 0},
+    {"vfmsac", FMA, 1, 0, 0, 0, 0, 0},     {"vfnmsac", FMA, 1, 0, 0, 0, 0, 0},
+    {"vfmadd", FMA, 1, 0, 0, 0, 0, 0},     {"vfnmadd", FMA, 1, 0, 0, 0, 0, 0},
+    {"vfmsub", FMA, 1, 0, 0, 0, 0, 0},     {"vfnmsub", FMA, 1, 0, 0, 0, 0, 0},
+    {"vfwmacc", FMA, 1, 1, 0, 0, 0, 0},    {"vfwnmacc", FMA, 1, 1, 0, 0, 0, 0},
+    {"vfwmsac", FMA, 1, 1, 0, 0, 0, 0},    {"vfwnmsac", FMA, 1, 1, 0, 0, 0, 0},
+    {"vfcvt", FCvt, 0, 0, 0, 0, 0, 0},     {"vfwcvt", FCvt, 0, 1, 0, 0, 0, 0},
+    {"vfncvt", FCvt, 0, 0, 0, 1, 0, 0},
+    {"vfredusum", FRed, 0, 0, 0, 0, 1, 0}, {"vfredosum", FRed, 0, 0, 0, 0, 1, 1},
+    {"vfredmin", FRed, 0, 0, 0, 0, 1, 0},  {"vfredmax", FRed, 0, 0, 0, 0, 1, 0},
+    {"vfwredusum", FRed, 0, 1, 0, 0, 1, 0}, {"vfwredosum", FRed, 0, 1, 0, 0, 1, 1},
+};
+
+// ===================================================================
+// Trace parser
+// ===================================================================
+static bool parse_vreg(const std::string& tok, int& reg) {
+    if (tok.size() < 2 || tok[0] != 'v') return false;
+    char* end;
+    long r = strtol(tok.c_str() + 1, &end, 10);
+    if (*end || r < 0 || r > 31) return false;
+    reg = (int)r;
+    return true;
+}
+
+static std::vector<std::string> split_operands(const std::string& s) {
+    std::vector<std::string> toks;
+    std::string cur;
+    for (char c : s) {
+        if (c == ',' || c == ' ' || c == '\t') {
+            if (!cur.empty()) toks.push_back(cur);
+            cur.clear();
+        } else {
+            cur += c;
+        }
+    }
+    if (!cur.empty()) toks.push_back(cur);
+    return toks;
+}
+
+class TraceParser {
+public:
+    // Returns false (after printing file:line) on a syntax error
+    bool parse(const char* path, std::vector<Inst>& out);
+
+private:
+    bool parse_line(const std::string& line, Inst& inst, bool& is_inst);
+    int sew_ = 32, lmul_ = 1;
+};
+
+bool TraceParser::parse_line(const std::string& line, Inst& inst, bool& is_inst) {
+    is_inst = false;
+    std::string op = line.substr(0, line.find_first_of(" \t"));
+    std::vector<std::string> ops = split_operands(line.substr(op.size()));
+    if (op == "vsetvli" || op == "vsetivli") {
+        for (const std::string& t : ops) {
+            if (t == "e16") sew_ = 16;
+            else if (t == "e32") sew_ = 32;
+            else if (t == "m1" || t == "m2" || t == "m4" || t == "m8") lmul_ = t[1] - '0';
+        }
+        return true;
+    }
+
+    std::string base = op.substr(0, op.find('.'));
+    std::string suffix = op.find('.') == std::string::npos ? "" : op.substr(op.find('.') + 1);
+    const Mnemonic* m = nullptr;
+    for (const Mnemonic& e : kMnemonics) {
+        if (base == e.name) m = &e;
+    }
+    if (!m || ops.size() < 2) return false;
+    inst = Inst();
+    inst.name = op;
+    inst.unit = m->unit;
+    inst.macc = m->macc;
+    inst.widen = m->widen && suffix[0] != 'w';
+    inst.widen2 = m->widen && suffix[0] == 'w';
+    inst.narrow = m->narrow;
+    inst.redu = m->redu;
+    inst.ordered = m->ordered;
+    inst.fcmp = base == "vfmin" || base == "vfmax" || !strncmp(m->name, "vfsgnj", 6);
+    inst.sew = sew_;
+    inst.lmul = lmul_;
+
+    int r1 = kNoReg, r2 = kNoReg;
+    bool v1 = parse_vreg(ops[1], r1);
+    bool v2 = ops.size() > 2 && parse_vreg(ops[2], r2);
+    if (!parse_vreg(ops[0], inst.vd)) return false;
+    if (inst.macc) {
+        // vd, vs1/rs1, vs2
+        if (!v2) return false;
+        inst.vs1 = v1 ? r1 : kNoReg;
+        inst.vs2 = r2;
+    } else {
+        // vd, vs2, vs1/rs1
+        if (!v1) return false;
+        inst.vs2 = r1;
+        inst.vs1 = v2 ? r2 : kNoReg;
+    }
+    if ((inst.widen || inst.widen2 || inst.narrow) && (sew_ != 16 || lmul_ > 4)) return false;
+    int vd_regs = inst.redu ? 1 : inst.widen || inst.widen2 ? 2 * lmul_ : lmul_;
+    if (inst.vd + vd_regs > 32) return false;
+    is_inst = true;
+    return true;
+}
+
+bool TraceParser::parse(const char* path, std::vector<Inst>& out) {
+    std::ifstream in(path);
+    if (!in) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    // Stack of (repeat count, index in out where the body starts)
+    std::vector<std::pair<long, size_t>> loops;
+    std::string line;
+    int lineno = 0;
+    sew_ = 32;
+    lmul_ = 1;
+    while (std::getline(in, line)) {
+        ++lineno;
+        line = line.substr(0, line.find('#'));
+        size_t b = line.find_first_not_of(" \t\r"), e = line.find_last_not_of(" \t\r");
+        if (b == std::string::npos) continue;
+        line = line.substr(b, e - b + 1);
+
+        if (line.compare(0, 7, ".repeat") == 0) {
+            long n = atol(line.c_str() + 7);
+            if (n <= 0) goto error;
+            loops.emplace_back(n, out.size());
+        } else if (line == ".end") {
+            if (loops.empty()) goto error;
+            std::vector<Inst> body(out.begin() + loops.back().second, out.end());
+            for (long i = 1; i < loops.back().first; ++i) {
+                out.insert(out.end(), body.begin(), body.end());
+            }
+            loops.pop_back();
+        } else {
+            Inst inst;
+            bool is_inst;
+            if (!parse_line(line, inst, is_inst)) goto error;
+            if (is_inst) out.push_back(inst);
+        }
+    }
+    if (!loops.empty()) {
+        fprintf(stderr, "%s: missing .end\n", path);
+        return false;
+    }
+    return true;
+error:
+    fprintf(stderr, "%s:%d: cannot parse \"%s\"\n", path, lineno, line.c_str());
+    return false;
+}
+
+// ===================================================================
+// Uop split (one uop per destination vector register, as the decoder does)
+// ===================================================================
+static void split_uops(const ModelParams& p, const Inst& inst, RobPtr robIdx, uint64_t& seq,
+                       std::vector<Uop>& uops) {
+    const int elems_per_reg = p.vlen / inst.sew;
+    int n;
+    if (inst.redu) n = inst.lmul;                           // one uop per source register
+    else if (inst.widen || inst.widen2) n = 2 * inst.lmul;  // vd group is 2*LMUL
+    else n = inst.lmul;
+
+    for (int i = 0; i < n; ++i) {
+        Uop u;
+        u.robIdx = robIdx;
+        u.seq = seq++;
+        u.uopIdx = i;
+        u.uopEnd = i == n - 1;
+        u.unit = inst.unit;
+        u.macc_fwd_ok = inst.macc;
+        u.elems = inst.widen || inst.widen2 ? elems_per_reg / 2 : elems_per_reg;
+        u.occupancy = 1;
+        auto off = [](int r, int k) { return r == kNoReg ? kNoReg : r + k; };
+        if (inst.redu) {
+            // vs2[i] + (uop 0: vs1, else the partial sum of uop i-1) -> vd on the last uop
+            u.src[0] = off(inst.vs2, i);
+            u.src[1] = i == 0 ? inst.vs1 : kRedTmp;
+            u.dest = u.uopEnd ? inst.vd : kRedTmp;
+            u.elems = elems_per_reg;
+            bool in16 = inst.sew == 16;
+            if (inst.ordered) {
+                u.occupancy = 2 * elems_per_reg; // VFRed: one FAdd, 2 cycles per element, ready low
+                u.latency = u.occupancy + p.delay_bias;
+            } else {
+                u.latency = in16 ? p.fred16_delay : p.fred32_delay;
+            }
+        } else {
+            u.dest = inst.vd + i;
+            if (inst.widen) {
+                u.src[0] = off(inst.vs2, i / 2);
+                u.src[1] = off(inst.vs1, i / 2);
+            } else if (inst.widen2) {
+                u.src[0] = off(inst.vs2, i);
+                u.src[1] = off(inst.vs1, i / 2);
+            } else if (inst.narrow) {
+                u.src[0] = off(inst.vs2, 2 * i);
+                u.src[1] = off(inst.vs2, 2 * i + 1);
+            } else {
+                u.src[0] = off(inst.vs2, i);
+                u.src[1] = off(inst.vs1, i);
+            }
+            if (inst.macc) u.src[2] = inst.vd + i;
+            u.latency = inst.fcmp ? p.fcmp_delay : inst.unit == FAdd ? p.fadd_delay : inst.unit == FMA ? p.fma_delay : p.fcvt_delay;
+        }
+        uops.push_back(u);
+    }
+}
+
+// ===================================================================
+// Scheduler
+// ===================================================================
+enum Stall { StallRaw = 0, StallUnit, StallWb, StallEmpty, kNumStalls };
+static const char* kStallNames[kNumStalls] = {
+    "operand not ready (RAW)", "unit busy", "write-back port", "IQ empty (ROB full / end of trace)"};
+
+struct Stats {
+    uint64_t cycles = 0, insts = 0, uops = 0, elems = 0;
+    uint64_t unit_busy[kNumUnits] = {0};   // unit-cycles taken (1 per pipelined uop)
+    uint64_t unit_uops[kNumUnits] = {0};
+    uint64_t stalls[kNumStalls] = {0};     // unused issue slots by reason
+    uint64_t rob_full_cycles = 0, iq_full_cycles = 0, acc_fwd_uops = 0;
+};
+
+class LaneModel {
+public:
+    explicit LaneModel(const ModelParams& p) : p_(p) {}
+    Stats run(const std::vector<Inst>& trace);
+
+private:
+    struct RobEntry {
+        RobPtr robIdx;
+        int uops_left;
+        uint64_t done_cycle;
+    };
+    struct UnitSlot {
+        uint64_t free_cycle = 0;
+        uint64_t last_seq = UINT64_MAX; // last uop issued (acc_fwd takes its result)
+        uint64_t last_issue = 0;
+    };
+
+    // Why u cannot issue at now (kNumStalls = it can)
+    Stall check(const Uop& u, size_t iq_pos, int& slot, bool& fwd) const;
+
+    const ModelParams& p_;
+    uint64_t now_ = 0;
+    uint64_t reg_ready_[kNumRegs];
+    uint64_t reg_seq_[kNumRegs];  // producer of the value in flight
+    std::vector<UnitSlot> units_[kNumUnits];
+    std::map<uint64_t, int> wb_used_; // write-back cycle -> ports taken
+    std::vector<Uop> iq_;
+};
+
+Stall LaneModel::check(const Uop& u, size_t iq_pos, int& slot, bool& fwd) const {
+    // RAW/WAW on uops still in the IQ ahead of this one (only with out-of-order issue)
+    for (size_t j = 0; j < iq_pos; ++j) {
+        const Uop& o = iq_[j];
+        if (o.dest == kNoReg) continue;
+        if (o.dest == u.dest) return StallRaw;
+        for (int s : u.src) {
+            if (s == o.dest) return StallRaw;
+        }
+    }
+    fwd = false;
+    for (int k = 0; k < 3; ++k) {
+        int s = u.src[k];
+        if (s == kNoReg || reg_ready_[s] <= now_) continue;
+        // acc_fwd: the accumulator comes from the previous uop of the same FMA, acc_ready 2 cycles after it
+        bool can_fwd = p_.acc_fwd && k == 2 && u.macc_fwd_ok;
+        bool ok = false;
+        if (can_fwd) {
+            for (const UnitSlot& us : units_[FMA]) {
+                ok |= us.last_seq == reg_seq_[s] && us.last_issue + 2 <= now_;
+            }
+        }
+        if (!ok) return StallRaw;
+        fwd = true;
+    }
+    slot = -1;
+    for (size_t i = 0; i < units_[u.unit].size(); ++i) {
+        const UnitSlot& us = units_[u.unit][i];
+        if (us.free_cycle > now_) continue;
+        // A forwarded accumulate has to go to the unit holding its accumulator
+        if (fwd && us.last_seq != reg_seq_[u.src[2]]) continue;
+        slot = (int)i;
+        break;
+    }
+    if (slot < 0) return StallUnit;
+    auto it = wb_used_.find(now_ + u.latency);
+    if (it != wb_used_.end() && it->second >= p_.wb_ports) return StallWb;
+    return kNumStalls;
+}
+
+Stats LaneModel::run(const std::vector<Inst>& trace) {
+    Stats st;
+    for (int r = 0; r < kNumRegs; ++r) {
+        reg_ready_[r] = 0;
+        reg_seq_[r] = UINT64_MAX;
+    }
+    for (int k = 0; k < kNumUnits; ++k) {
+        units_[k].assign(p_.n_units[k], UnitSlot());
+    }
+    wb_used_.clear();
+    iq_.clear();
+    now_ = 0;
+
+    std::vector<RobEntry> rob; // oldest first
+    RobPtr enq_ptr;
+    uint64_t seq = 0;
+    size_t next_inst = 0;
+    std::vector<Uop> uops;
+
+    while (next_inst < trace.size() || !iq_.empty() || !rob.empty()) {
+        // Commit, in order
+        while (!rob.empty() && rob.front().uops_left == 0 && rob.front().done_cycle <= now_) {
+            rob.erase(rob.begin());
+            st.insts++;
+        }
+
+        // Issue
+        int issued = 0;
+        for (int w = 0; w < p_.issue_width; ++w) {
+            Stall first = StallEmpty;
+            bool done = false;
+            for (size_t i = 0; i < iq_.size() && !done; ++i) {
+                int slot;
+                bool fwd;
+                Stall s = check(iq_[i], i, slot, fwd);
+                if (i == 0) first = s;
+                if (s == kNumStalls) {
+                    const Uop u = iq_[i];
+                    UnitSlot& us = units_[u.unit][slot];
+                    us.free_cycle = now_ + u.occupancy;
+                    us.last_seq = u.seq;
+                    us.last_issue = now_;
+                    wb_used_[now_ + u.latency]++;
+                    if (u.dest != kNoReg) {
+                        reg_ready_[u.dest] = now_ + u.latency;
+                        reg_seq_[u.dest] = u.seq;
+                    }
+                    for (RobEntry& e : rob) {
+                        if (e.robIdx == u.robIdx) {
+                            e.uops_left--;
+                            e.done_cycle = std::max(e.done_cycle, now_ + u.latency);
+                        }
+                    }
+                    st.uops++;
+                    st.elems += u.elems;
+                    st.unit_busy[u.unit] += u.occupancy;
+                    st.unit_uops[u.unit]++;
+                    st.acc_fwd_uops += fwd;
+                    iq_.erase(iq_.begin() + i);
+                    issued++;
+                    done = true;
+                }
+                if (!p_.ooo) break;
+            }
+            if (!done) {
+                st.stalls[first]++;
+            }
+        }
+        wb_used_.erase(wb_used_.begin(), wb_used_.lower_bound(now_));
+
+        // Dispatch: one instruction per cycle, needs a ROB entry and IQ room for all of its uops
+        if (next_inst < trace.size()) {
+            uops.clear();
+            uint64_t s = seq;
+            split_uops(p_, trace[next_inst], enq_ptr, s, uops);
+            if ((int)rob.size() >= p_.rob_size) {
+                st.rob_full_cycles++;
+            } else if (iq_.size() + uops.size() > (size_t)p_.iq_size) {
+                st.iq_full_cycles++;
+            } else {
+                seq = s;
+                rob.push_back(RobEntry{enq_ptr, (int)uops.size(), now_});
+                iq_.insert(iq_.end(), uops.begin(), uops.end());
+                enq_ptr = enq_ptr.next(p_.rob_size);
+                next_inst++;
+            }
+        }
+        now_++;
+    }
+    st.cycles = now_;
+    return st;
+}
+
+// ===================================================================
+// Report
+// ===================================================================
+static void report(const char* path, const ModelParams& p, const Stats& st) {
+    printf("%s\n", path);
+    printf("  %llu instructions, %llu uops in %llu cycles: IPC %.3f, uops/cycle %.3f, %.1f elements/cycle\n",
+           (unsigned long long)st.insts, (unsigned long long)st.uops, (unsigned long long)st.cycles,
+           (double)st.insts / st.cycles, (double)st.uops / st.cycles, (double)st.elems / st.cycles);
+    for (int k = 0; k < kNumUnits; ++k) {
+        if (!st.unit_uops[k]) continue;
+        printf("  %-5s x%d  %8llu uops  utilization %5.1f%%\n", kUnitNames[k], p.n_units[k],
+               (unsigned long long)st.unit_uops[k], 100.0 * st.unit_busy[k] / ((double)st.cycles * p.n_units[k]));
+    }
+    uint64_t slots = st.cycles * p.issue_width;
+    printf("  issue slots %llu, used %.1f%%\n", (unsigned long long)slots, 100.0 * st.uops / slots);
+    for (int s = 0; s < kNumStalls; ++s) {
+        if (st.stalls[s]) {
+            printf("    stall %-36s %8llu  (%.1f%%)\n", kStallNames[s], (unsigned long long)st.stalls[s],
+                   100.0 * st.stalls[s] / slots);
+        }
+    }
+    if (st.rob_full_cycles || st.iq_full_cycles) {
+        printf("  dispatch blocked: ROB full %llu cycles, IQ full %llu cycles\n",
+               (unsigned long long)st.rob_full_cycles, (unsigned long long)st.iq_full_cycles);
+    }
+    if (p.acc_fwd) {
+        printf("  accumulator-forwarded uops: %llu\n", (unsigned long long)st.acc_fwd_uops);
+    }
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options] <trace> [<trace> ...]\n"
+           "  --vlen <n>                   VLEN (default 1024; FRed delays follow it and --fadd-delay unless given)\n"
+           "  --fadd-delay <n>  --fcmp-delay <n>  --fma-delay <n>  --fcvt-delay <n>\n"
+           "  --fred16-delay <n>  --fred32-delay <n>      delays incl. delayBias (default: VParams)\n"
+           "  --fadd-units <n>  --fma-units <n>  --fcvt-units <n>  --fred-units <n>\n"
+           "  --rob <n>  --iq <n>  --wb-ports <n>  --issue-width <n>\n"
+           "  --ooo                        issue the oldest ready uop (default: in order)\n"
+           "  --acc-fwd                    model VFMA_16_32 accumulator forwarding\n", prog);
+}
+
+static int log2_up(int x) {
+    int r = 0;
+    while ((1 << r) < x) ++r;
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    ModelParams p;
+    std::vector<const char*> traces;
+    bool fred_given = false;
+    struct IntOpt {
+        const char* name;
+        int* val;
+    } int_opts[] = {
+        {"--vlen", &p.vlen}, {"--fadd-delay", &p.fadd_delay}, {"--fcmp-delay", &p.fcmp_delay},
+        {"--fma-delay", &p.fma_delay}, {"--fcvt-delay", &p.fcvt_delay}, {"--fred16-delay", &p.fred16_delay},
+        {"--fred32-delay", &p.fred32_delay},
+        {"--fadd-units", &p.n_units[FAdd]}, {"--fma-units", &p.n_units[FMA]}, {"--fcvt-units", &p.n_units[FCvt]},
+        {"--fred-units", &p.n_units[FRed]}, {"--rob", &p.rob_size}, {"--iq", &p.iq_size},
+        {"--wb-ports", &p.wb_ports}, {"--issue-width", &p.issue_width},
+    };
+    for (int i = 1; i < argc; ++i) {
+        bool matched = false;
+        for (IntOpt& o : int_opts) {
+            if (!strcmp(argv[i], o.name) && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+                *o.val = atoi(argv[++i]);
+                fred_given |= !strncmp(o.name, "--fred", 6) && strstr(o.name, "delay");
+                matched = true;
+                break;
+            }
+        }
+        if (matched) continue;
+        if (!strcmp(argv[i], "--ooo")) {
+            p.ooo = true;
+        } else if (!strcmp(argv[i], "--acc-fwd")) {
+            p.acc_fwd = true;
+        } else if (argv[i][0] != '-') {
+            traces.push_back(argv[i]);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (traces.empty() || p.vlen < 64 || (p.vlen & (p.vlen - 1))) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (!fred_given) {
+        // VFRed: log2(VLEN/32) + 2 adder levels of faddDelay - delayBias cycles each
+        p.fred16_delay = (log2_up(p.vlen / 32) + 2) * (p.fadd_delay - p.delay_bias) + p.delay_bias;
+        p.fred32_delay = p.fred16_delay;
+    }
+
+    printf("Lane EXU model: VLEN=%d, delays fadd %d fcmp %d fma %d fcvt %d fred %d/%d, units FAdd %d FMA %d FCvt %d FRed %d,\n"
+           "  ROB %d, IQ %d, %d write-back port(s), issue width %d, %s issue%s\n",
+           p.vlen, p.fadd_delay, p.fcmp_delay, p.fma_delay, p.fcvt_delay, p.fred16_delay, p.fred32_delay, p.n_units[FAdd],
+           p.n_units[FMA], p.n_units[FCvt], p.n_units[FRed], p.rob_size, p.iq_size, p.wb_ports, p.issue_width,
+           p.ooo ? "out-of-order" : "in-order", p.acc_fwd ? ", acc_fwd" : "");
+
+    for (const char* path : traces) {
+        std::vector<Inst> trace;
+        TraceParser parser;
+        if (!parser.parse(path, trace)) {
+            return 1;
+        }
+        LaneModel model(p);
+        report(path, p, model.run(trace));
+    }
+    return 0;
+}
@@ -0,0 +1,317 @@
+// topSR harness: statistical sign-off of stochastic rounding (SR) of fp16/bf16
+// results in FAdd_16_32. Every result must be one of the two neighbours of the
+// exact sum (computed in double); which one is a random event checked against
+// the discarded fraction f (in ulp) of that sum.
+//   probability  discarded part fixed at k/16 ulp (k = 1..15): P(round away from
+//                zero) must be k/16 in both lanes
+//   bias         random pairs, random exponent gaps and signs: the mean signed
+//                error of SR must be 0; RNE results are checked bit-exact
+//   seed         reloading a seed replays the same roundings, another seed does not
+//   accumulate   chains acc += inc with inc = ulp(acc)/8 and below: SR follows
+//                the exact sum, RNE stalls at the start value
+// Bounds are 5 sigma of the binomial error plus 2^-14 ulp, the resolution of the
+// discarded part kept by the unit.
+#include "fp_utils.h"
+#include "verilated_fixture.h"
+#include "VtopSR.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const double kZ = 5.0;
+static const double kResolution = 1.0 / 16384;
+
+// ===================================================================
+// Format helpers: exact sum -> its two neighbours in the 16-bit format
+// ===================================================================
+struct Fmt {
+    const char* name;
+    bool is_fp16;
+    int man;  // fraction bits
+    int emin; // exponent of the smallest normal
+};
+static const Fmt kFp16 = {"FP16", true, 10, -14};
+static const Fmt kBf16 = {"BF16", false, 7, -126};
+
+static double to_double(uint16_t x, const Fmt& f) { return f.is_fp16 ? fp16_to_fp32(x) : bf16_to_fp32(x); }
+// Exact for representable values
+static uint16_t from_double(double v, const Fmt& f) {
+    return f.is_fp16 ? fp32_to_fp16((float)v) : fp32_to_bf16((float)v);
+}
+
+// lo: x rounded toward zero, hi: the next value away from zero, f = (|x| - |lo|) / ulp
+struct Bracket {
+    uint16_t lo, hi;
+    double f;
+};
+
+static Bracket bracket(double x, const Fmt& fmt) {
+    double ax = std::fabs(x);
+    if (ax == 0.0) return {from_double(x, fmt), from_double(x, fmt), 0.0};
+    int e = std::max(std::ilogb(ax), fmt.emin);
+    double q = std::ldexp(1.0, e - fmt.man);
+    double m = std::floor(ax / q);
+    return {from_double(std::copysign(m * q, x), fmt), from_double(std::copysign((m + 1) * q, x), fmt), ax / q - m};
+}
+
+static uint16_t rne(const Bracket& b) {
+    if (b.f != 0.5) return b.f < 0.5 ? b.lo : b.hi;
+    return (b.lo & 1) ? b.hi : b.lo;
+}
+
+// Random normal value 1.xxx * 2^e, random sign
+static uint16_t gen_value(std::mt19937_64& rng, const Fmt& fmt, int e) {
+    uint32_t man = (uint32_t)rng() & ((1u << fmt.man) - 1);
+    uint32_t bias = fmt.is_fp16 ? 15 : 127;
+    uint32_t sign = (uint32_t)rng() & 1;
+    return (uint16_t)(sign << 15 | (uint32_t)(e + bias) << fmt.man | man);
+}
+
+// ===================================================================
+// SrSim: 驱动 topSR, 流水发射 (每周期两个元素)
+// ===================================================================
+class SrSim : public VerilatedFixture<VtopSR> {
+public:
+    SrSim(int argc, char* argv[]) : VerilatedFixture(argc, argv) { reset(); }
+
+    void seed(uint32_t s) {
+        top_->io_valid_in = 0;
+        top_->io_sr_seed_valid = 1;
+        top_->io_sr_seed = s;
+        single_cycle();
+        top_->io_sr_seed_valid = 0;
+    }
+
+    // Streams a + b (even n, element 2i in lane 0 and 2i+1 in lane 1). False on timeout.
+    bool run(const Fmt& fmt, bool sr, const std::vector<uint16_t>& a, const std::vector<uint16_t>& b,
+             std::vector<uint16_t>& out) {
+        const size_t n = a.size();
+        top_->io_is_fp16 = fmt.is_fp16;
+        top_->io_is_bf16 = !fmt.is_fp16;
+        top_->io_rm_sr = sr;
+        out.resize(n);
+        auto issue = [&](size_t i) -> uint64_t {
+            top_->io_a_in_16_0 = a[i];
+            top_->io_b_in_16_0 = b[i];
+            top_->io_a_in_16_1 = a[i + 1];
+            top_->io_b_in_16_1 = b[i + 1];
+            return 2;
+        };
+        auto collect = [&](size_t i) -> uint64_t {
+            out[i] = top_->io_res_out_16_0;
+            out[i + 1] = top_->io_res_out_16_1;
+            return 2;
+        };
+        return stream(n, issue, collect) == n;
+    }
+};
+
+// Classifies a result against its bracket: 0 = lo, 1 = hi, -1 = neither
+static int outcome(uint16_t dut, const Bracket& b) {
+    if (dut == b.lo) return 0;
+    if (dut == b.hi) return 1;
+    return -1;
+}
+
+static bool report_bad(const char* test, const Fmt& fmt, uint16_t a, uint16_t b, uint16_t dut, const Bracket& br,
+                       uint64_t& printed) {
+    if (printed++ < 10) {
+        printf("  %s %s: 0x%04X + 0x%04X = 0x%04X, not 0x%04X / 0x%04X (f = %.6f)\n", fmt.name, test, a, b, dut,
+               br.lo, br.hi, br.f);
+    }
+    return false;
+}
+
+// ===================================================================
+// Tests
+// ===================================================================
+static bool test_probability(SrSim& sim, const Fmt& fmt, size_t samples, std::mt19937_64& rng) {
+    printf("[%s] probability: %zu samples per lane and k\n", fmt.name, samples);
+    printf("   k/16   lane 0 P(up)   lane 1 P(up)   bound\n");
+    bool ok = true;
+    uint64_t printed = 0;
+    for (int k = 1; k < 16; ++k) {
+        std::vector<uint16_t> a(2 * samples), b(2 * samples), out;
+        for (size_t i = 0; i < a.size(); ++i) {
+            int e = (int)(rng() % 9) - 4;
+            a[i] = gen_value(rng, fmt, e);
+            // Same sign, k/16 ulp of a: the sum sits k/16 of the way from |a| to the next value
+            b[i] = from_double(std::copysign(k * std::ldexp(1.0, e - fmt.man - 4), to_double(a[i], fmt)), fmt);
+        }
+        if (!sim.run(fmt, true, a, b, out)) {
+            printf("  timeout\n");
+            return false;
+        }
+        uint64_t up[2] = {0, 0};
+        for (size_t i = 0; i < a.size(); ++i) {
+            Bracket br = bracket(to_double(a[i], fmt) + to_double(b[i], fmt), fmt);
+            int o = outcome(out[i], br);
+            if (o < 0) ok = report_bad("probability", fmt, a[i], b[i], out[i], br, printed);
+            up[i % 2] += o == 1;
+        }
+        double p = k / 16.0;
+        double bound = kZ * std::sqrt(p * (1 - p) / samples) + kResolution;
+        double p0 = (double)up[0] / samples, p1 = (double)up[1] / samples;
+        bool pass = std::fabs(p0 - p) <= bound && std::fabs(p1 - p) <= bound;
+        printf("  %5.4f   %12.4f   %12.4f   +-%.4f%s\n", p, p0, p1, bound, pass ? "" : "  <-- FAIL");
+        ok &= pass;
+    }
+    return ok;
+}
+
+static bool test_bias(SrSim& sim, const Fmt& fmt, size_t samples, std::mt19937_64& rng) {
+    std::vector<uint16_t> a, b, out_sr, out_rne;
+    a.reserve(samples);
+    b.reserve(samples);
+    while (a.size() < samples) {
+        int e = (int)(rng() % 13) - 6;
+        int gap = (int)(rng() % (2 * fmt.man + 6));
+        uint16_t x = gen_value(rng, fmt, e), y = gen_value(rng, fmt, std::max(e - gap, fmt.emin));
+        double s = to_double(x, fmt) + to_double(y, fmt);
+        if (s == 0.0) continue;
+        a.push_back(x);
+        b.push_back(y);
+    }
+    if (a.size() % 2) {
+        a.pop_back();
+        b.pop_back();
+    }
+    if (!sim.run(fmt, true, a, b, out_sr) || !sim.run(fmt, false, a, b, out_rne)) {
+        printf("[%s] bias: timeout\n", fmt.name);
+        return false;
+    }
+
+    bool ok = true;
+    uint64_t printed = 0, rne_fail = 0, inexact = 0;
+    double err_sr = 0, err_rne = 0, var = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        Bracket br = bracket(to_double(a[i], fmt) + to_double(b[i], fmt), fmt);
+        int o = outcome(out_sr[i], br);
+        if (o < 0) ok = report_bad("bias (SR)", fmt, a[i], b[i], out_sr[i], br, printed);
+        if (out_rne[i] != rne(br)) {
+            rne_fail++;
+            ok = report_bad("bias (RNE)", fmt, a[i], b[i], out_rne[i], br, printed);
+        }
+        inexact += br.f != 0;
+        err_sr += (o == 1) - br.f;
+        err_rne += (out_rne[i] == br.hi && br.f != 0) - br.f;
+        var += br.f * (1 - br.f);
+    }
+    const double n = (double)a.size();
+    double bound = kZ * std::sqrt(var) / n + kResolution;
+    bool pass = std::fabs(err_sr / n) <= bound;
+    printf("[%s] bias: %zu pairs (%llu inexact), mean error SR %+.3e ulp (bound %.1e), RNE %+.3e ulp, "
+           "%llu RNE mismatches%s\n", fmt.name, a.size(), (unsigned long long)inexact, err_sr / n, bound,
+           err_rne / n, (unsigned long long)rne_fail, pass ? "" : "  <-- FAIL");
+    return ok && pass;
+}
+
+static bool test_seed(SrSim& sim, const Fmt& fmt, uint32_t seed, std::mt19937_64& rng) {
+    const size_t n = 4096;
+    std::vector<uint16_t> a(n), b(n), r1, r2, r3;
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = gen_value(rng, fmt, 0);
+        b[i] = gen_value(rng, fmt, -(int)(rng() % 8) - 2);
+    }
+    sim.seed(seed);
+    bool ok = sim.run(fmt, true, a, b, r1);
+    sim.seed(seed);
+    ok &= sim.run(fmt, true, a, b, r2);
+    sim.seed(seed + 1);
+    ok &= sim.run(fmt, true, a, b, r3);
+    bool same = r1 == r2, differs = r1 != r3;
+    printf("[%s] seed: same seed %s, another seed %s\n", fmt.name, same ? "replays" : "DOES NOT replay",
+           differs ? "differs" : "GIVES THE SAME ROUNDINGS");
+    return ok && same && differs;
+}
+
+static bool test_accumulate(SrSim& sim, const Fmt& fmt, size_t chains, size_t steps) {
+    // acc0 = 1, inc = ulp(1) / 8: RNE never moves, the exact sum ends at 1 + steps * inc
+    const double inc = std::ldexp(1.0, -fmt.man - 3);
+    const uint16_t one = from_double(1.0, fmt), inc16 = from_double(inc, fmt);
+    const double exact = 1.0 + steps * inc;
+    chains += chains % 2;
+    std::vector<uint16_t> acc_sr(chains, one), acc_rne(chains, one), b(chains, inc16), out;
+    for (size_t s = 0; s < steps; ++s) {
+        // One dependent step of every chain per call (chains are independent, so they stream)
+        if (!sim.run(fmt, true, acc_sr, b, out)) return false;
+        acc_sr.swap(out);
+        if (!sim.run(fmt, false, acc_rne, b, out)) return false;
+        acc_rne.swap(out);
+    }
+    double mean = 0, sq = 0;
+    for (uint16_t x : acc_sr) {
+        double v = to_double(x, fmt);
+        mean += v;
+        sq += v * v;
+    }
+    mean /= chains;
+    double sd = std::sqrt(std::max(0.0, sq / chains - mean * mean));
+    double bound = kZ * sd / std::sqrt((double)chains) + kResolution * exact;
+    bool pass = std::fabs(mean - exact) <= bound;
+    printf("[%s] accumulate: %zu chains x %zu steps of %g from 1: exact %.6f | SR mean %.6f (sd %.4f, bound %.4f)"
+           " | RNE %.6f%s\n", fmt.name, chains, steps, inc, exact, mean, sd, bound, to_double(acc_rne[0], fmt),
+           pass ? "" : "  <-- FAIL");
+    return pass;
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [--mode fp16|bf16|all] [--samples <n>] [--chains <n>] [--steps <n>] [--seed <s>]\n", prog);
+}
+
+int main(int argc, char* argv[]) {
+    bool run_fp16 = true, run_bf16 = true;
+    size_t samples = 20000, chains = 64, steps = 2048;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
+            i++;
+            run_fp16 = !strcmp(argv[i], "fp16") || !strcmp(argv[i], "all");
+            run_bf16 = !strcmp(argv[i], "bf16") || !strcmp(argv[i], "all");
+            if (!run_fp16 && !run_bf16) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--samples") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            samples = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--chains") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            chains = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--steps") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            steps = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    SrSim sim(argc, argv);
+    std::mt19937_64 rng(seed);
+    sim.seed(seed);
+    printf("Stochastic rounding sign-off, seed %u\n", seed);
+
+    bool ok = true;
+    for (const Fmt* fmt : {&kFp16, &kBf16}) {
+        if ((fmt->is_fp16 && !run_fp16) || (!fmt->is_fp16 && !run_bf16)) continue;
+        ok &= test_probability(sim, *fmt, samples, rng);
+        ok &= test_bias(sim, *fmt, samples * 10, rng);
+        ok &= test_seed(sim, *fmt, seed, rng);
+        ok &= test_accumulate(sim, *fmt, chains, steps);
+        printf("\n");
+    }
+
+    if (!ok) {
+        printf("Stochastic rounding FAILED.\n");
+        return 1;
+    }
+    printf("Stochastic rounding passed.\n");
+    return 0;
+}
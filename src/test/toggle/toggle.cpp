@@ -0,0 +1,263 @@
+// Toggle-activity harness for dynamic-power estimation: top is Verilated with
+// --coverage-toggle, each mode streams the same kind of workload, and the
+// per-bit toggle counters are dumped to <dat-dir>/toggle_<mode>.dat (readable
+// by verilator_coverage) and summed per module instance and per pipeline stage.
+// Toggles per element is the energy-per-op proxy: it compares lane packings
+// (FP16 two per cycle vs. widen one per cycle) and operand/clock-gating ideas.
+#include "fp_utils.h"
+#include "result_checker.h"
+#include "workload_dist.h"
+#include "verilated_fixture.h"
+#include <verilated_cov.h>
+#include "Vtop.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// ToggleSim: 驱动 top, 每个模式单独清零并导出 toggle 计数
+// ===================================================================
+class ToggleSim : public VerilatedFixture<Vtop> {
+public:
+    ToggleSim(int argc, char* argv[]) : VerilatedFixture(argc, argv) {}
+
+    // Streams a/b (n elements, operand format) and writes the toggle counts of
+    // the streaming cycles only (reset and the mode switch are excluded).
+    // Returns the number of cycles counted, 0 on timeout.
+    uint64_t run(TestMode mode, const std::vector<uint32_t>& a, const std::vector<uint32_t>& b,
+                 const std::string& dat);
+};
+
+uint64_t ToggleSim::run(TestMode mode, const std::vector<uint32_t>& a, const std::vector<uint32_t>& b,
+                        const std::string& dat) {
+    const bool two = mode == TestMode::FP16 || mode == TestMode::BF16;
+    reset();
+    top_->io_is_fp32 = mode == TestMode::FP32;
+    top_->io_is_fp16 = mode == TestMode::FP16 || mode == TestMode::FP16_Widen || mode == TestMode::FP16_Narrow;
+    top_->io_is_bf16 = mode == TestMode::BF16 || mode == TestMode::BF16_Widen || mode == TestMode::BF16_Narrow;
+    top_->io_is_widen = mode == TestMode::FP16_Widen || mode == TestMode::BF16_Widen;
+    top_->io_is_narrow = mode == TestMode::FP16_Narrow || mode == TestMode::BF16_Narrow;
+    top_->io_a_already_widen = 0;
+    single_cycle();
+    contextp_->coveragep()->zero();
+
+    const uint64_t start = cycles();
+    const size_t n = a.size();
+    auto issue = [&](size_t i) -> uint64_t {
+        if (operand_format(mode) == FpFormat::FP32) {
+            top_->io_a_in_32 = a[i];
+            top_->io_b_in_32 = b[i];
+            return 1;
+        }
+        if (two) {
+            top_->io_a_in_16_0 = a[i];
+            top_->io_b_in_16_0 = b[i];
+            top_->io_a_in_16_1 = i + 1 < n ? a[i + 1] : 0;
+            top_->io_b_in_16_1 = i + 1 < n ? b[i + 1] : 0;
+            return 2;
+        }
+        top_->io_a_in_16_0 = 0;
+        top_->io_a_in_16_1 = a[i];
+        top_->io_b_in_16_0 = 0;
+        top_->io_b_in_16_1 = b[i];
+        return 1;
+    };
+    if (stream(n, issue, [&](size_t) -> uint64_t { return two ? 2 : 1; }) < n) {
+        return 0;
+    }
+    contextp_->coveragep()->write(dat);
+    return cycles() - start;
+}
+
+// ===================================================================
+// coverage.dat 解析: C '<\001key\002value...>' <count>
+// ===================================================================
+struct Activity {
+    uint64_t toggles = 0;
+    std::set<std::string> bits; // toggle points, direction suffix stripped
+};
+
+struct ModeActivity {
+    std::map<std::string, Activity> module; // instance path
+    std::map<std::string, Activity> stage;  // S<n> from the _S<n> naming, io, comb
+    Activity total;
+};
+
+// _S<n> suffix (valid_S2, res_is_32_S3, adderIn_a_S1_...) -> "S<n>", io_* -> "io", else "comb"
+static std::string stage_of(const std::string& sig) {
+    if (sig.compare(0, 3, "io_") == 0) return "io";
+    for (size_t p = sig.find("_S"); p != std::string::npos; p = sig.find("_S", p + 1)) {
+        size_t e = p + 2;
+        while (e < sig.size() && isdigit((unsigned char)sig[e])) e++;
+        if (e > p + 2 && (e == sig.size() || sig[e] == '_' || sig[e] == '[')) return sig.substr(p + 1, e - p - 1);
+    }
+    return "comb";
+}
+
+static bool parse_toggle_dat(const std::string& path, ModeActivity& act) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t q0 = line.find('\''), q1 = line.rfind('\'');
+        if (line.compare(0, 2, "C ") != 0 || q0 == std::string::npos || q1 <= q0) continue;
+        std::string hier, sig;
+        bool toggle = false;
+        // Keys are written long or short depending on the Verilator version
+        std::string kv = line.substr(q0 + 1, q1 - q0 - 1);
+        for (size_t p = kv.find('\001'); p != std::string::npos;) {
+            size_t next = kv.find('\001', p + 1);
+            std::string item = kv.substr(p + 1, next == std::string::npos ? std::string::npos : next - p - 1);
+            size_t sep = item.find('\002');
+            if (sep != std::string::npos) {
+                std::string key = item.substr(0, sep), val = item.substr(sep + 1);
+                if (val.compare(0, 9, "v_toggle/") == 0) toggle = true;
+                if (key == "h" || key == "hier") hier = val;
+                if (key == "o" || key == "comment") sig = val;
+            }
+            p = next;
+        }
+        if (!toggle || sig.empty()) continue;
+        // One point per bit, or per bit and direction ("x[3]:0->1") in newer versions
+        std::string bit = sig.substr(0, sig.find(':'));
+        std::string name = bit.substr(0, bit.find('['));
+        if (name == "clock" || name == "reset") continue;
+        if (hier.compare(0, 4, "TOP.") == 0) hier = hier.substr(4);
+        uint64_t count = strtoull(line.c_str() + q1 + 1, nullptr, 10);
+
+        std::string key = hier + "." + bit;
+        for (Activity* a : {&act.module[hier], &act.stage[stage_of(name)], &act.total}) {
+            a->toggles += count;
+            a->bits.insert(key);
+        }
+    }
+    return true;
+}
+
+// ===================================================================
+// main
+// ===================================================================
+static void print_usage(const char* prog) {
+    printf("Usage: %s [--vectors <n>] [--workload gaussian|lognormal|outliers|cancelling|any]\n"
+           "          [--seed <s>] [--dat-dir <dir>]\n", prog);
+}
+
+static void print_row(const char* label, const std::vector<const Activity*>& acts, const std::vector<double>& div) {
+    printf("  %-34s", label);
+    for (size_t m = 0; m < acts.size(); ++m) {
+        if (acts[m]) {
+            printf(" %11.1f", acts[m]->toggles / div[m]);
+        } else {
+            printf(" %11s", "-");
+        }
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    size_t n_vec = 100000;
+    uint32_t seed = 1;
+    std::string workload = "gaussian";
+    std::string dat_dir = argv[0];
+    dat_dir = dat_dir.find('/') == std::string::npos ? "." : dat_dir.substr(0, dat_dir.rfind('/'));
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--vectors") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            n_vec = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--workload") && i + 1 < argc) {
+            workload = argv[++i];
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--dat-dir") && i + 1 < argc) {
+            dat_dir = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    WorkloadParams wp;
+    if (workload == "gaussian") {
+        wp = workload_gaussian(1.0);
+    } else if (workload == "lognormal") {
+        wp = workload_log_normal(1.0 / 16384, 4.0);
+    } else if (workload == "outliers") {
+        wp = workload_outliers(1.0, 256.0, 1.0 / 16);
+    } else if (workload == "cancelling") {
+        wp = workload_cancelling(1.0, 9);
+    } else if (workload != "any") {
+        print_usage(argv[0]);
+        return 1;
+    }
+    srand(seed);
+    workload_seed(seed);
+
+    ToggleSim sim(argc, argv);
+    std::vector<ModeActivity> acts(kNumTestModes);
+    std::vector<double> per_elem(kNumTestModes), per_bit_cycle(kNumTestModes);
+    for (int m = 0; m < kNumTestModes; ++m) {
+        const TestMode mode = (TestMode)m;
+        const FpFormat fmt = operand_format(mode);
+        const size_t n = n_vec * (mode == TestMode::FP16 || mode == TestMode::BF16 ? 2 : 1);
+        std::vector<uint32_t> a(n), b(n);
+        for (size_t i = 0; i < n; ++i) {
+            if (workload == "any") {
+                a[i] = fmt == FpFormat::FP32 ? gen_any_fp32() : fmt == FpFormat::FP16 ? gen_any_fp16() : gen_any_bf16();
+                b[i] = fmt == FpFormat::FP32 ? gen_any_fp32() : fmt == FpFormat::FP16 ? gen_any_fp16() : gen_any_bf16();
+            } else {
+                gen_workload_pair(wp, fmt, a[i], b[i]);
+            }
+        }
+        std::string dat = dat_dir + "/toggle_" + mode_name(mode) + ".dat";
+        uint64_t cycles = sim.run(mode, a, b, dat);
+        if (!cycles) {
+            fprintf(stderr, "%s: timeout\n", mode_name(mode));
+            return 1;
+        }
+        if (!parse_toggle_dat(dat, acts[m]) || acts[m].total.bits.empty()) {
+            fprintf(stderr, "%s: no toggle points in %s (Verilated without --coverage-toggle?)\n", mode_name(mode),
+                    dat.c_str());
+            return 1;
+        }
+        per_elem[m] = (double)n;
+        per_bit_cycle[m] = (double)acts[m].total.bits.size() * cycles;
+    }
+
+    // Rows: union over modes (the instance set is the same, the map keeps it sorted)
+    std::set<std::string> modules, stages;
+    for (const ModeActivity& a : acts) {
+        for (const auto& kv : a.module) modules.insert(kv.first);
+        for (const auto& kv : a.stage) stages.insert(kv.first);
+    }
+    auto column = [&](bool by_module, const std::string& key) {
+        std::vector<const Activity*> col;
+        for (const ModeActivity& a : acts) {
+            const auto& map = by_module ? a.module : a.stage;
+            auto it = map.find(key);
+            col.push_back(it == map.end() ? nullptr : &it->second);
+        }
+        return col;
+    };
+
+    printf("Toggle activity: workload %s, %zu vectors per mode, seed %u (dumps in %s)\n\n", workload.c_str(), n_vec,
+           seed, dat_dir.c_str());
+    printf("  %-34s", "toggles per element");
+    for (int m = 0; m < kNumTestModes; ++m) printf(" %11s", mode_name((TestMode)m));
+    printf("\n  per module instance\n");
+    for (const std::string& mod : modules) print_row(("  " + mod).c_str(), column(true, mod), per_elem);
+    printf("  per pipeline stage (_S<n> signals)\n");
+    for (const std::string& st : stages) print_row(("  " + st).c_str(), column(false, st), per_elem);
+    std::vector<const Activity*> total;
+    for (const ModeActivity& a : acts) total.push_back(&a.total);
+    print_row("total", total, per_elem);
+    printf("  %-34s", "activity factor (toggles/bit/cycle)");
+    for (int m = 0; m < kNumTestModes; ++m) printf(" %11.4f", acts[m].total.toggles / per_bit_cycle[m]);
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,332 @@
+// topTwoSum harness: the error output of FAdd_16_32(TwoSum = true).
+//   pairs        res must be the RNE sum and err the exact rounding error
+//                (a + b) - res, bit-exact against 2Sum evaluated with SoftFloat
+//                in the same format (+0 when exact, Inf/NaN or overflowed).
+//                Wherever a + b and res + err are exact in double, the identity
+//                res + err == a + b is also checked directly there. Operands:
+//                arbitrary bit patterns, AI workloads, exponent gaps across the
+//                alignment window and subnormals.
+//   compensated  chains summed plainly (s += x) and with the error output
+//                (s, e = s + x; c += e; result s + c, i.e. Sum2 of Ogita, Rump
+//                and Oishi): two unit ops per element instead of seven with a
+//                software 2Sum. Errors against the exact sum; within the Sum2
+//                bound u|S| + gamma(n-1)^2 sum|x| where (n - 1)u < 1/2.
+#include "fp_utils.h"
+#include "softfloat_ref.h"
+#include "result_checker.h"
+#include "workload_dist.h"
+#include "verilated_fixture.h"
+#include "VtopTwoSum.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+struct Fmt {
+    TestMode mode;
+    FpFormat fmt;
+    int exp_bits, man; // field widths
+};
+static const Fmt kFmts[] = {
+    {TestMode::FP32, FpFormat::FP32, 8, 23},
+    {TestMode::FP16, FpFormat::FP16, 5, 10},
+    {TestMode::BF16, FpFormat::BF16, 8, 7},
+};
+
+static uint32_t sign_bit(const Fmt& f) { return 1u << (f.exp_bits + f.man); }
+static bool is_finite(const Fmt& f, uint32_t x) {
+    uint32_t e = x >> f.man & ((1u << f.exp_bits) - 1);
+    return e != (1u << f.exp_bits) - 1;
+}
+static bool is_zero(const Fmt& f, uint32_t x) { return (x & (sign_bit(f) - 1)) == 0; }
+
+static double to_double(const Fmt& f, uint32_t x) {
+    switch (f.fmt) {
+        case FpFormat::FP32: {
+            float v;
+            memcpy(&v, &x, 4);
+            return v;
+        }
+        case FpFormat::FP16: return fp16_to_fp32((uint16_t)x);
+        default: return bf16_to_fp32((uint16_t)x);
+    }
+}
+
+static uint32_t ref_add(const Fmt& f, uint32_t a, uint32_t b) {
+    switch (f.fmt) {
+        case FpFormat::FP32: return softfloat_add_fp32(a, b);
+        case FpFormat::FP16: return softfloat_add_fp16((uint16_t)a, (uint16_t)b);
+        default: return softfloat_add_bf16((uint16_t)a, (uint16_t)b);
+    }
+}
+static uint32_t ref_sub(const Fmt& f, uint32_t a, uint32_t b) { return ref_add(f, a, b ^ sign_bit(f)); }
+
+// 2Sum (Knuth / Moller) in the format itself: exact for finite s under RNE, subnormals included
+static uint32_t ref_err(const Fmt& f, uint32_t a, uint32_t b, uint32_t s) {
+    if (!is_finite(f, s)) return 0;
+    uint32_t bb = ref_sub(f, s, a);
+    uint32_t ap = ref_sub(f, s, bb);
+    uint32_t err = ref_add(f, ref_sub(f, a, ap), ref_sub(f, b, bb));
+    return is_zero(f, err) ? 0 : err;
+}
+
+// x + y in double, true if exact (2Sum error in double is 0)
+static bool exact_sum(double x, double y, double& s) {
+    s = x + y;
+    double yy = s - x;
+    return (x - (s - yy)) + (y - yy) == 0.0;
+}
+
+// ===================================================================
+// TwoSumSim: 驱动 topTwoSum, 流水发射 (fp32 每周期一个, fp16/bf16 两个)
+// ===================================================================
+class TwoSumSim : public VerilatedFixture<VtopTwoSum> {
+public:
+    TwoSumSim(int argc, char* argv[]) : VerilatedFixture(argc, argv) { reset(); }
+
+    // res[i], err[i] for a[i] + b[i]. False on timeout.
+    bool run(const Fmt& f, const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, std::vector<uint32_t>& res,
+             std::vector<uint32_t>& err) {
+        const size_t n = a.size();
+        const bool two = f.fmt != FpFormat::FP32;
+        top_->io_is_fp32 = !two;
+        top_->io_is_fp16 = f.fmt == FpFormat::FP16;
+        top_->io_is_bf16 = f.fmt == FpFormat::BF16;
+        res.resize(n);
+        err.resize(n);
+        auto issue = [&](size_t i) -> uint64_t {
+            if (!two) {
+                top_->io_a_in_32 = a[i];
+                top_->io_b_in_32 = b[i];
+                return 1;
+            }
+            top_->io_a_in_16_0 = a[i];
+            top_->io_b_in_16_0 = b[i];
+            top_->io_a_in_16_1 = i + 1 < n ? a[i + 1] : 0;
+            top_->io_b_in_16_1 = i + 1 < n ? b[i + 1] : 0;
+            return 2;
+        };
+        auto collect = [&](size_t i) -> uint64_t {
+            if (!two) {
+                res[i] = top_->io_res_out_32;
+                err[i] = top_->io_err_out_32;
+                return 1;
+            }
+            res[i] = top_->io_res_out_16_0;
+            err[i] = top_->io_err_out_16_0;
+            if (i + 1 < n) {
+                res[i + 1] = top_->io_res_out_16_1;
+                err[i + 1] = top_->io_err_out_16_1;
+            }
+            return 2;
+        };
+        return stream(n, issue, collect) == n;
+    }
+};
+
+// ===================================================================
+// Operands
+// ===================================================================
+static uint32_t gen_any(const Fmt& f) {
+    switch (f.fmt) {
+        case FpFormat::FP32: return gen_any_fp32();
+        case FpFormat::FP16: return gen_any_fp16();
+        default: return gen_any_bf16();
+    }
+}
+static uint32_t gen_random(const Fmt& f, int e) {
+    switch (f.fmt) {
+        case FpFormat::FP32: return gen_random_fp32(e, e);
+        case FpFormat::FP16: return gen_random_fp16(e, e);
+        default: return gen_random_bf16(e, e);
+    }
+}
+
+// Every fourth pair each: bit patterns, workloads, exponent gap 0 .. 2 * (man + 1) + 4 around the
+// alignment window, subnormal / small normal
+static void gen_pairs(const Fmt& f, size_t n, std::vector<uint32_t>& a, std::vector<uint32_t>& b) {
+    const WorkloadParams mix[] = {
+        workload_gaussian(1.0), workload_log_normal(1.0 / 16384, 4.0),
+        workload_outliers(1.0, 256.0, 1.0 / 16), workload_cancelling(1.0, 9),
+    };
+    a.resize(n);
+    b.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        switch (i % 4) {
+            case 0:
+                a[i] = gen_any(f);
+                b[i] = gen_any(f);
+                break;
+            case 1:
+                gen_workload_pair(mix[(i / 4) % 4], f.fmt, a[i], b[i]);
+                break;
+            case 2: {
+                // FP16 starts at the top of its range so that the gaps reach below the low adder's window
+                const int emin = 2 - (1 << (f.exp_bits - 1));
+                int e = rand() % 16 - (f.fmt == FpFormat::FP16 ? 0 : 8), gap = rand() % (2 * (f.man + 1) + 5);
+                a[i] = gen_random(f, e);
+                b[i] = gen_random(f, std::max(e - gap, emin));
+                break;
+            }
+            default: {
+                // Exponent field 0 (subnormal) .. 3
+                uint32_t m = (uint32_t)rand() & ((1u << f.man) - 1);
+                a[i] = (uint32_t)(rand() & 1) * sign_bit(f) | (uint32_t)(rand() % 4) << f.man | m;
+                b[i] = (uint32_t)(rand() & 1) * sign_bit(f) | (uint32_t)(rand() % 4) << f.man |
+                       ((uint32_t)rand() & ((1u << f.man) - 1));
+                break;
+            }
+        }
+    }
+}
+
+// ===================================================================
+// Tests
+// ===================================================================
+static bool test_pairs(TwoSumSim& sim, const Fmt& f, size_t n) {
+    std::vector<uint32_t> a, b, res, err;
+    gen_pairs(f, n, a, b);
+    if (!sim.run(f, a, b, res, err)) {
+        printf("[%s] pairs: timeout\n", mode_name(f.mode));
+        return false;
+    }
+    const int hex = f.fmt == FpFormat::FP32 ? 8 : 4;
+    uint64_t res_bad = 0, err_bad = 0, inexact = 0, identity = 0, identity_bad = 0, printed = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t s = ref_add(f, a[i], b[i]);
+        uint32_t e = ref_err(f, a[i], b[i], s);
+        bool bad = false;
+        if (res[i] != s) {
+            res_bad++;
+            bad = true;
+        } else if (err[i] != e) {
+            err_bad++;
+            bad = true;
+        }
+        inexact += e != 0;
+        double x, y;
+        if (is_finite(f, res[i]) && exact_sum(to_double(f, a[i]), to_double(f, b[i]), x) &&
+            exact_sum(to_double(f, res[i]), to_double(f, err[i]), y)) {
+            identity++;
+            if (x != y) {
+                identity_bad++;
+                bad = true;
+            }
+        }
+        if (bad && printed++ < 10) {
+            printf("  %s 0x%0*X + 0x%0*X: res 0x%0*X err 0x%0*X, expected res 0x%0*X err 0x%0*X\n", mode_name(f.mode),
+                   hex, a[i], hex, b[i], hex, res[i], hex, err[i], hex, s, hex, e);
+        }
+    }
+    bool ok = res_bad == 0 && err_bad == 0 && identity_bad == 0;
+    printf("[%s] pairs: %zu (%llu inexact), %llu res / %llu err mismatches, res + err == a + b checked in double "
+           "for %llu, %llu off%s\n", mode_name(f.mode), n, (unsigned long long)inexact, (unsigned long long)res_bad,
+           (unsigned long long)err_bad, (unsigned long long)identity, (unsigned long long)identity_bad,
+           ok ? "" : "  <-- FAIL");
+    return ok;
+}
+
+static bool test_compensated(TwoSumSim& sim, const Fmt& f, size_t chains, size_t length) {
+    // Chains are independent, so one step of all of them streams through the unit per call
+    std::vector<std::vector<uint32_t>> x(length, std::vector<uint32_t>(chains));
+    for (size_t k = 0; k < length; k += 2) {
+        for (size_t c = 0; c < chains; ++c) {
+            uint32_t x0, x1;
+            gen_workload_pair(workload_log_normal(1.0 / 16, 2.0), f.fmt, x0, x1);
+            x[k][c] = x0;
+            if (k + 1 < length) x[k + 1][c] = x1;
+        }
+    }
+    std::vector<uint32_t> plain = x[0], s = x[0], comp(chains, 0), out, e, unused;
+    for (size_t k = 1; k < length; ++k) {
+        if (!sim.run(f, plain, x[k], out, unused)) return false;
+        plain.swap(out);
+        if (!sim.run(f, s, x[k], out, e)) return false;
+        s.swap(out);
+        if (!sim.run(f, comp, e, out, unused)) return false;
+        comp.swap(out);
+    }
+    std::vector<uint32_t> result;
+    if (!sim.run(f, s, comp, result, unused)) return false;
+
+    const double u = std::ldexp(1.0, -f.man - 1);
+    const double nu = (length - 1) * u;
+    const bool bounded = nu < 0.5;
+    double err_plain = 0, err_comp = 0;
+    uint64_t over = 0;
+    for (size_t c = 0; c < chains; ++c) {
+        long double exact = 0, abs_sum = 0;
+        for (size_t k = 0; k < length; ++k) {
+            exact += to_double(f, x[k][c]);
+            abs_sum += std::fabs(to_double(f, x[k][c]));
+        }
+        double dp = std::fabs(to_double(f, plain[c]) - (double)exact);
+        double dc = std::fabs(to_double(f, result[c]) - (double)exact);
+        err_plain += dp / (double)abs_sum;
+        err_comp += dc / (double)abs_sum;
+        double gamma = nu / (1 - nu);
+        if (bounded && dc > u * std::fabs((double)exact) + gamma * gamma * (double)abs_sum) over++;
+    }
+    bool ok = over == 0 && err_comp <= err_plain;
+    printf("[%s] compensated: %zu chains x %zu, mean |error| / sum|x|: plain %.3e, with err %.3e%s%s\n",
+           mode_name(f.mode), chains, length, err_plain / chains, err_comp / chains,
+           bounded ? (over ? ", Sum2 bound exceeded" : ", within the Sum2 bound") : "", ok ? "" : "  <-- FAIL");
+    return ok;
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [--mode fp32|fp16|bf16|all] [--pairs <n>] [--chains <n>] [--length <n>] [--seed <s>]\n", prog);
+}
+
+int main(int argc, char* argv[]) {
+    int only_mode = -1;
+    size_t pairs = 200000, chains = 256, length = 1024;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '+') {
+            continue; // Verilator plusarg
+        } else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
+            i++;
+            static const char* kModes[] = {"fp32", "fp16", "bf16"};
+            for (int m = 0; m < 3; ++m) {
+                if (!strcmp(argv[i], kModes[m])) only_mode = m;
+            }
+            if (only_mode < 0 && strcmp(argv[i], "all")) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--pairs") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            pairs = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--chains") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            chains = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--length") && i + 1 < argc && atol(argv[i + 1]) > 1) {
+            length = (size_t)atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    srand(seed);
+    workload_seed(seed);
+
+    TwoSumSim sim(argc, argv);
+    printf("TwoSum error output, seed %u\n", seed);
+    bool ok = true;
+    for (int m = 0; m < 3; ++m) {
+        if (only_mode >= 0 && m != only_mode) continue;
+        ok &= test_pairs(sim, kFmts[m], pairs);
+        ok &= test_compensated(sim, kFmts[m], chains, length);
+    }
+
+    if (!ok) {
+        printf("TwoSum FAILED.\n");
+        return 1;
+    }
+    printf("TwoSum passed.\n");
+    return 0;
+}